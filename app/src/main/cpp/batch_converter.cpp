@@ -0,0 +1,264 @@
+#include "batch_converter.h"
+#include "native_log.h"
+#include <algorithm>
+#include <chrono>
+#include <sys/stat.h>
+
+#define LOG_TAG "BatchConverter"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+BatchConverter::BatchConverter(uint32_t maxConcurrentJobs, const ConversionOptions& options, uint32_t jobsPerDevice)
+    : maxConcurrentJobs(std::max(1u, maxConcurrentJobs)),
+      jobsPerDevice(std::max(1u, jobsPerDevice)),
+      jobOptions(options),
+      stopping(false),
+      bytesConverted(0),
+      firstStartNanos(0),
+      lastFinishNanos(0) {
+    // Orçamento de hashing dividido entre os jobs simultâneos
+    if (jobOptions.threadCount == 0) {
+        uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        jobOptions.threadCount = std::max(1u, cores / this->maxConcurrentJobs);
+    }
+
+    for (uint32_t i = 0; i < this->maxConcurrentJobs; i++) {
+        runners.emplace_back(&BatchConverter::runnerLoop, this);
+    }
+
+    LOGD("Batch converter started: %u concurrent jobs, %u hash threads each, %u jobs per device",
+         this->maxConcurrentJobs, jobOptions.threadCount, this->jobsPerDevice);
+}
+
+BatchConverter::~BatchConverter() {
+    cancelAll();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (auto& runner : runners) {
+        if (runner.joinable()) {
+            runner.join();
+        }
+    }
+    LOGD("Batch converter stopped");
+}
+
+dev_t BatchConverter::deviceOf(const std::string& path) {
+    // A pasta de saída pode ainda não existir: subir até um pai que exista
+    std::string current = path;
+    struct stat st;
+
+    for (;;) {
+        if (stat(current.c_str(), &st) == 0) {
+            return st.st_dev;
+        }
+        size_t slash = current.find_last_of('/');
+        if (slash == std::string::npos || current == "/") {
+            return 0;
+        }
+        current = slash == 0 ? "/" : current.substr(0, slash);
+    }
+}
+
+uint32_t BatchConverter::submit(const std::string& isoPath, const std::string& outputPath) {
+    std::unique_ptr<Job> job(new Job());
+    job->isoPath = isoPath;
+    job->outputPath = outputPath;
+    job->isoDevice = deviceOf(isoPath);
+    job->outputDevice = deviceOf(outputPath);
+
+    struct stat st;
+    if (stat(isoPath.c_str(), &st) == 0) {
+        job->status.isoBytes = st.st_size;
+    }
+
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = (uint32_t)jobs.size();
+        job->status.id = id;
+        job->status.status = "Na fila";
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+
+    LOGD("Job %u queued: %s -> %s", id, isoPath.c_str(), outputPath.c_str());
+    return id;
+}
+
+bool BatchConverter::devicesAvailable(const Job& job) const {
+    auto busy = [this](dev_t device) {
+        auto it = busyDevices.find(device);
+        return it != busyDevices.end() && it->second >= jobsPerDevice;
+    };
+    return !busy(job.isoDevice) && !busy(job.outputDevice);
+}
+
+void BatchConverter::markDevices(const Job& job, bool busy) {
+    // ISO e saída no mesmo disco contam uma vez só
+    dev_t devices[2] = {job.isoDevice, job.outputDevice};
+    uint32_t count = job.isoDevice == job.outputDevice ? 1 : 2;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (busy) {
+            busyDevices[devices[i]]++;
+        } else if (--busyDevices[devices[i]] == 0) {
+            busyDevices.erase(devices[i]);
+        }
+    }
+}
+
+BatchConverter::Job* BatchConverter::pickNextJob() {
+    // Primeiro job da fila cujos discos estão livres
+    for (auto& job : jobs) {
+        if (job->status.state == BatchJobState::Queued && devicesAvailable(*job)) {
+            return job.get();
+        }
+    }
+    return nullptr;
+}
+
+void BatchConverter::runnerLoop() {
+    Iso2GodConverter converter;
+
+    for (;;) {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this, &job] {
+                return stopping || (job = pickNextJob()) != nullptr;
+            });
+            if (stopping) {
+                return;
+            }
+
+            job->status.state = BatchJobState::Running;
+            job->status.status = "Iniciando...";
+            markDevices(*job, true);
+            if (firstStartNanos == 0) {
+                firstStartNanos = nowNanos();
+            }
+        }
+
+        runJob(job, converter);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            markDevices(*job, false);
+            lastFinishNanos = nowNanos();
+            if (job->status.state == BatchJobState::Done) {
+                bytesConverted += job->status.stats.readBytes;
+            }
+        }
+        // Discos liberados: outro executor pode ter um job que agora cabe
+        jobAvailable.notify_all();
+    }
+}
+
+void BatchConverter::runJob(Job* job, Iso2GodConverter& converter) {
+    LOGD("Job %u started: %s", job->status.id, job->isoPath.c_str());
+
+    uint64_t startNanos = nowNanos();
+
+    auto progressCallback = [this, job](float progress, const std::string& status) {
+        std::lock_guard<std::mutex> lock(mutex);
+        job->status.progress = progress;
+        job->status.status = status;
+    };
+
+    // O token é do job: um cancelamento anterior ao início não se perde
+    ConversionOptions options = jobOptions;
+    options.cancelToken = &job->cancelToken;
+
+    int result = converter.convertIsoToGod(job->isoPath, job->outputPath, progressCallback, options);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job->status.result = result;
+    job->status.seconds = (nowNanos() - startNanos) / 1e9;
+    job->status.stats = converter.getLastConversionStats();
+
+    if (result == 0) {
+        job->status.state = BatchJobState::Done;
+        job->status.progress = 1.0f;
+    } else if (result == -4 || job->cancelToken.isCancelled()) {
+        job->status.state = BatchJobState::Cancelled;
+        job->status.status = "Cancelado";
+    } else {
+        job->status.state = BatchJobState::Failed;
+        job->status.status = "Falha na conversão";
+    }
+
+    LOGD("Job %u finished with %d in %.2fs", job->status.id, result, job->status.seconds);
+}
+
+bool BatchConverter::getJobStatus(uint32_t jobId, BatchJobStatus& status) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobId >= jobs.size()) {
+        return false;
+    }
+    status = jobs[jobId]->status;
+    return true;
+}
+
+BatchStats BatchConverter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    BatchStats stats;
+
+    for (const auto& job : jobs) {
+        switch (job->status.state) {
+            case BatchJobState::Queued: stats.queued++; break;
+            case BatchJobState::Running: stats.running++; break;
+            case BatchJobState::Done: stats.done++; break;
+            case BatchJobState::Failed: stats.failed++; break;
+            case BatchJobState::Cancelled: stats.cancelled++; break;
+        }
+    }
+
+    stats.bytesConverted = bytesConverted;
+    if (firstStartNanos > 0) {
+        uint64_t endNanos = stats.running > 0 ? nowNanos() : lastFinishNanos;
+        stats.elapsedSeconds = endNanos > firstStartNanos ? (endNanos - firstStartNanos) / 1e9 : 0.0;
+    }
+    if (stats.elapsedSeconds > 0.0) {
+        stats.throughputMBps = (bytesConverted / (1024.0 * 1024.0)) / stats.elapsedSeconds;
+    }
+    return stats;
+}
+
+void BatchConverter::cancelJob(uint32_t jobId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobId >= jobs.size()) {
+        return;
+    }
+
+    Job& job = *jobs[jobId];
+    if (job.status.state == BatchJobState::Queued) {
+        job.status.state = BatchJobState::Cancelled;
+        job.status.status = "Cancelado";
+        job.status.result = -4;
+    } else if (job.status.state == BatchJobState::Running) {
+        job.cancelToken.cancel();
+    }
+}
+
+void BatchConverter::cancelAll() {
+    uint32_t count = getJobCount();
+    for (uint32_t i = 0; i < count; i++) {
+        cancelJob(i);
+    }
+    LOGD("All batch jobs cancelled");
+}
+
+uint32_t BatchConverter::getJobCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (uint32_t)jobs.size();
+}
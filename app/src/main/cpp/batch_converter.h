@@ -0,0 +1,110 @@
+#ifndef BATCH_CONVERTER_H
+#define BATCH_CONVERTER_H
+
+#include "iso2god_converter.h"
+#include <sys/types.h>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class BatchJobState {
+    Queued = 0,
+    Running = 1,
+    Done = 2,
+    Failed = 3,
+    Cancelled = 4
+};
+
+// Situação de um job, copiada sob o lock (pode ser lida de qualquer thread)
+struct BatchJobStatus {
+    uint32_t id = 0;
+    BatchJobState state = BatchJobState::Queued;
+    float progress = 0.0f;
+    std::string status;
+    int result = 0;               // código de convertIsoToGod quando terminado
+    uint64_t isoBytes = 0;
+    double seconds = 0.0;         // duração da conversão
+    ConversionStats stats;        // válido quando terminado
+};
+
+// Números do lote inteiro
+struct BatchStats {
+    uint32_t queued = 0;
+    uint32_t running = 0;
+    uint32_t done = 0;
+    uint32_t failed = 0;
+    uint32_t cancelled = 0;
+    uint64_t bytesConverted = 0;  // bytes do ISO lidos pelos jobs concluídos
+    double elapsedSeconds = 0.0;  // do primeiro job iniciado até agora (ou ao último concluído)
+    double throughputMBps = 0.0;
+};
+
+// Converte vários ISOs com um número fixo de jobs simultâneos.
+//
+// Cada executor é uma thread com o seu próprio Iso2GodConverter; as
+// threads de hashing de cada conversão saem de um orçamento único (os
+// núcleos divididos pelos jobs simultâneos), então dois jobs não disputam
+// a CPU com o dobro de threads. O escalonador olha o dispositivo (st_dev)
+// do ISO e da pasta de saída: um job só começa se nenhum dos seus discos
+// já estiver com jobsPerDevice jobs, e o próximo da fila que cabe passa
+// na frente. Assim dois ISOs no mesmo cartão SD não brigam pela cabeça de
+// leitura, enquanto um ISO no armazenamento interno e outro no cartão
+// convertem juntos.
+class BatchConverter {
+public:
+    BatchConverter(uint32_t maxConcurrentJobs, const ConversionOptions& options, uint32_t jobsPerDevice = 1);
+    ~BatchConverter();
+
+    // Enfileira um job e retorna o id; os executores começam sozinhos
+    uint32_t submit(const std::string& isoPath, const std::string& outputPath);
+
+    bool getJobStatus(uint32_t jobId, BatchJobStatus& status) const;
+    BatchStats getStats() const;
+
+    // Job na fila sai dela; job rodando é cancelado pelo seu token
+    void cancelJob(uint32_t jobId);
+    void cancelAll();
+
+    uint32_t getJobCount() const;
+
+private:
+    struct Job {
+        BatchJobStatus status;
+        std::string isoPath;
+        std::string outputPath;
+        dev_t isoDevice;
+        dev_t outputDevice;
+        CancellationToken cancelToken;
+    };
+
+    uint32_t maxConcurrentJobs;
+    uint32_t jobsPerDevice;
+    ConversionOptions jobOptions;
+
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::map<dev_t, uint32_t> busyDevices;
+    bool stopping;
+
+    uint64_t bytesConverted;
+    uint64_t firstStartNanos;
+    uint64_t lastFinishNanos;
+
+    std::vector<std::thread> runners;
+
+    static dev_t deviceOf(const std::string& path);
+
+    Job* pickNextJob();
+    bool devicesAvailable(const Job& job) const;
+    void markDevices(const Job& job, bool busy);
+    void runnerLoop();
+    void runJob(Job* job, Iso2GodConverter& converter);
+};
+
+#endif // BATCH_CONVERTER_H
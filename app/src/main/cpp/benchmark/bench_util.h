@@ -0,0 +1,19 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <string>
+#include <vector>
+
+// Utilitários comuns aos benchmarks de host (Linux)
+
+// Relógio monotônico em segundos
+double nowSeconds();
+
+// Apaga a pasta e tudo dentro dela (sem seguir links)
+void removeTree(const std::string& path);
+
+// Tira os arquivos do page cache, para medir leituras com cache frio
+void dropFromPageCache(const std::string& path);
+void dropFromPageCache(const std::vector<std::string>& paths);
+
+#endif // BENCH_UTIL_H
@@ -0,0 +1,357 @@
+// Benchmark de escala do GDFParser: gera imagens só com metadados em várias
+// formas de árvore e tamanhos e mede, por caso, o tempo de parse, o pico de
+// heap durante o parse, o padrão de leitura (leituras, seeks, bytes) e o
+// custo de uma busca por caminho completo.
+// Resultado em JSON no stdout; mensagens no stderr.
+//
+//   gdf_parse_bench [--shapes wide,deep,balanced,scattered]
+//                   [--entries 1000,10000,100000] [--fanout N] [--depth N]
+//                   [--iterations N] [--work-dir DIR] [--pread] [--cold]
+//                   [--keep]
+
+#include "synthetic_iso.h"
+#include "bench_util.h"
+#include "gdf_parser.h"
+#include "iso_source.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+// Contabilidade do heap: operator new/delete globais substituídos
+static std::atomic<uint64_t> heapCurrent(0);
+static std::atomic<uint64_t> heapPeak(0);
+static std::atomic<uint64_t> heapAllocations(0);
+
+static void* trackedAlloc(size_t size) {
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    uint64_t current = heapCurrent.fetch_add(malloc_usable_size(pointer)) + malloc_usable_size(pointer);
+    uint64_t peak = heapPeak.load();
+    while (current > peak && !heapPeak.compare_exchange_weak(peak, current)) {
+    }
+    heapAllocations.fetch_add(1);
+    return pointer;
+}
+
+static void trackedFree(void* pointer) {
+    if (pointer) {
+        heapCurrent.fetch_sub(malloc_usable_size(pointer));
+        free(pointer);
+    }
+}
+
+void* operator new(size_t size) { return trackedAlloc(size); }
+void* operator new[](size_t size) { return trackedAlloc(size); }
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+
+namespace {
+
+// IsoSource que conta o padrão de acesso do parser. Um seek é uma leitura
+// que não começa onde a anterior terminou. Com --pread lê em scratch como
+// o fallback sem mmap, senão entrega a view do ISO mapeado.
+class CountingIsoSource : public IsoSource {
+public:
+    CountingIsoSource(std::unique_ptr<IsoSource> inner, bool usePread)
+        : IsoSource(inner->getPath(), dup(inner->getFd()), inner->getSize()),
+          inner(std::move(inner)), usePread(usePread) {
+        reset();
+    }
+
+    using IsoSource::view;
+
+    bool isMapped() const override { return !usePread && inner->isMapped(); }
+
+    const uint8_t* view(uint64_t offset, size_t length, uint8_t* scratch) override {
+        reads++;
+        bytes += length;
+        if (offset != lastEnd) {
+            seeks++;
+            seekDistance += offset > lastEnd ? offset - lastEnd : lastEnd - offset;
+        }
+        lastEnd = offset + length;
+
+        if (!usePread) {
+            return inner->view(offset, length, scratch);
+        }
+        if (!inRange(offset, length) || pread(fd, scratch, length, (off_t)offset) != (ssize_t)length) {
+            return nullptr;
+        }
+        return scratch;
+    }
+
+    void adviseSequential() override { inner->adviseSequential(); }
+    void willNeed(uint64_t offset, uint64_t length) override { inner->willNeed(offset, length); }
+    void dontNeed(uint64_t offset, uint64_t length) override { inner->dontNeed(offset, length); }
+
+    void reset() {
+        reads = 0;
+        seeks = 0;
+        bytes = 0;
+        seekDistance = 0;
+        lastEnd = 0;
+    }
+
+    uint64_t reads;
+    uint64_t seeks;
+    uint64_t bytes;
+    uint64_t seekDistance;
+
+private:
+    std::unique_ptr<IsoSource> inner;
+    bool usePread;
+    uint64_t lastEnd;
+};
+
+struct BenchOptions {
+    std::vector<GdfTreeShape> shapes;
+    std::vector<uint32_t> entryCounts;
+    uint32_t fanout = 0;
+    uint32_t depth = 0;
+    uint32_t iterations = 5;
+    std::string workDir = "/tmp";
+    bool usePread = false;
+    bool cold = false;
+    bool keep = false;
+};
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) {
+            comma = list.size();
+        }
+        if (comma > start) {
+            items.push_back(list.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return items;
+}
+
+bool parseArguments(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--shapes" && hasValue) {
+            options.shapes.clear();
+            for (const std::string& name : splitList(argv[++i])) {
+                GdfTreeShape shape;
+                if (!parseTreeShape(name, shape)) {
+                    fprintf(stderr, "Unknown tree shape: %s\n", name.c_str());
+                    return false;
+                }
+                options.shapes.push_back(shape);
+            }
+        } else if (arg == "--entries" && hasValue) {
+            options.entryCounts.clear();
+            for (const std::string& count : splitList(argv[++i])) {
+                options.entryCounts.push_back((uint32_t)strtoul(count.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--fanout" && hasValue) {
+            options.fanout = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--depth" && hasValue) {
+            options.depth = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--work-dir" && hasValue) {
+            options.workDir = argv[++i];
+        } else if (arg == "--pread") {
+            options.usePread = true;
+        } else if (arg == "--cold") {
+            options.cold = true;
+        } else if (arg == "--keep") {
+            options.keep = true;
+        } else {
+            fprintf(stderr, "Unknown or incomplete argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.shapes.empty()) {
+        options.shapes = {GdfTreeShape::Wide, GdfTreeShape::Deep, GdfTreeShape::Balanced, GdfTreeShape::Scattered};
+    }
+    if (options.entryCounts.empty()) {
+        options.entryCounts = {1000, 10000, 100000};
+    }
+    return true;
+}
+
+bool runCase(const BenchOptions& options, GdfTreeShape shape, uint32_t entryCount, bool first, FILE* out) {
+    std::string path = options.workDir + "/gdf_stress_" + getTreeShapeName(shape) + "_" +
+                       std::to_string(entryCount) + ".iso";
+
+    GdfStressSpec spec;
+    spec.shape = shape;
+    spec.entryCount = entryCount;
+    spec.fanout = options.fanout;
+    spec.depth = options.depth;
+
+    GdfImageBuilder builder;
+    double start = nowSeconds();
+    if (!generateStressTree(path, spec, builder)) {
+        return false;
+    }
+    double generateSeconds = nowSeconds() - start;
+
+    std::unique_ptr<IsoSource> opened = IsoSource::open(path);
+    if (!opened) {
+        fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+    CountingIsoSource source(std::move(opened), options.usePread);
+
+    std::vector<double> samples;
+    uint64_t peakBytes = 0;
+    uint64_t allocations = 0;
+    size_t entriesFound = 0;
+    bool complete = false;
+    bool parsed = true;
+
+    // Com cache quente a primeira rodada só aquece e não entra na conta
+    uint32_t rounds = options.cold ? options.iterations : options.iterations + 1;
+    for (uint32_t round = 0; round < rounds; round++) {
+        if (options.cold) {
+            source.dontNeed(0, source.getSize());
+        }
+        source.reset();
+
+        uint64_t baseline = heapCurrent.load();
+        heapPeak.store(baseline);
+        uint64_t allocationsBefore = heapAllocations.load();
+
+        GDFParser parser;
+        double parseStart = nowSeconds();
+        parsed = parser.parse(source);
+        double elapsed = nowSeconds() - parseStart;
+
+        if (options.cold || round > 0) {
+            samples.push_back(elapsed);
+        }
+        peakBytes = heapPeak.load() - baseline;
+        allocations = heapAllocations.load() - allocationsBefore;
+
+        entriesFound = parser.getEntries().size();
+        complete = parser.isComplete();
+    }
+
+    // Busca por caminho completo: até 1000 entries espalhadas, metade com o
+    // caminho em maiúsculas (o GDF não diferencia)
+    GDFParser lookupParser;
+    lookupParser.parse(source);
+    const std::vector<GDFEntry>& entries = lookupParser.getEntries();
+    std::vector<std::string> lookupPaths;
+    std::vector<const GDFEntry*> lookupTargets;
+    size_t stride = std::max<size_t>(1, entries.size() / 1000);
+    for (size_t i = 0; i < entries.size(); i += stride) {
+        std::string entryPath = lookupParser.getPath(entries[i]);
+        if (lookupPaths.size() % 2) {
+            std::transform(entryPath.begin(), entryPath.end(), entryPath.begin(), ::toupper);
+        }
+        lookupPaths.push_back(entryPath);
+        lookupTargets.push_back(&entries[i]);
+    }
+
+    const uint32_t LOOKUP_ROUNDS = 100;
+    size_t lookupsFound = 0;
+    uint64_t lookupAllocations = heapAllocations.load();
+    double lookupStart = nowSeconds();
+    for (uint32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (size_t i = 0; i < lookupPaths.size(); i++) {
+            if (lookupParser.findEntry(lookupPaths[i]) == lookupTargets[i]) {
+                lookupsFound++;
+            }
+        }
+    }
+    double lookupSeconds = nowSeconds() - lookupStart;
+    lookupAllocations = heapAllocations.load() - lookupAllocations;
+    size_t lookupCount = lookupPaths.size() * LOOKUP_ROUNDS;
+
+    std::sort(samples.begin(), samples.end());
+    double median = samples.size() % 2 ? samples[samples.size() / 2]
+        : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    uint64_t expected = (uint64_t)builder.getFileCount() + builder.getDirectoryCount() - 1;
+
+    fprintf(stderr, "%-9s %7u entries: %10.1f us, %llu seeks%s\n", getTreeShapeName(shape), entryCount,
+            median * 1e6, (unsigned long long)source.seeks, complete ? "" : " (incomplete)");
+
+    fprintf(out, "%s    {\n", first ? "" : ",\n");
+    fprintf(out, "      \"shape\": \"%s\",\n", getTreeShapeName(shape));
+    fprintf(out, "      \"entries_expected\": %llu,\n", (unsigned long long)expected);
+    fprintf(out, "      \"directories\": %u,\n", builder.getDirectoryCount());
+    fprintf(out, "      \"image_bytes\": %llu,\n", (unsigned long long)builder.getImageSize());
+    fprintf(out, "      \"generate_seconds\": %.3f,\n", generateSeconds);
+    fprintf(out, "      \"parsed\": %s,\n", parsed ? "true" : "false");
+    fprintf(out, "      \"entries_found\": %zu,\n", entriesFound);
+    fprintf(out, "      \"complete\": %s,\n", complete ? "true" : "false");
+    fprintf(out, "      \"parse_us_min\": %.1f,\n", samples.front() * 1e6);
+    fprintf(out, "      \"parse_us_median\": %.1f,\n", median * 1e6);
+    fprintf(out, "      \"parse_us_max\": %.1f,\n", samples.back() * 1e6);
+    fprintf(out, "      \"heap_peak_bytes\": %llu,\n", (unsigned long long)peakBytes);
+    fprintf(out, "      \"allocations\": %llu,\n", (unsigned long long)allocations);
+    fprintf(out, "      \"reads\": %llu,\n", (unsigned long long)source.reads);
+    fprintf(out, "      \"seeks\": %llu,\n", (unsigned long long)source.seeks);
+    fprintf(out, "      \"seek_distance_bytes\": %llu,\n", (unsigned long long)source.seekDistance);
+    fprintf(out, "      \"bytes_read\": %llu,\n", (unsigned long long)source.bytes);
+    fprintf(out, "      \"lookups\": %zu,\n", lookupCount);
+    fprintf(out, "      \"lookups_found\": %zu,\n", lookupsFound);
+    fprintf(out, "      \"lookup_ns_mean\": %.1f,\n", lookupCount ? lookupSeconds * 1e9 / lookupCount : 0.0);
+    fprintf(out, "      \"lookup_allocations\": %llu\n", (unsigned long long)lookupAllocations);
+    fprintf(out, "    }");
+
+    if (!options.keep) {
+        unlink(path.c_str());
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 2;
+    }
+
+    FILE* out = stdout;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"access\": \"%s\",\n", options.usePread ? "pread" : "mmap");
+    fprintf(out, "  \"cache\": \"%s\",\n", options.cold ? "cold" : "warm");
+    fprintf(out, "  \"iterations\": %u,\n", options.iterations);
+    fprintf(out, "  \"cases\": [\n");
+
+    bool ok = true;
+    bool first = true;
+    for (GdfTreeShape shape : options.shapes) {
+        for (uint32_t entryCount : options.entryCounts) {
+            if (!runCase(options, shape, entryCount, first, out)) {
+                ok = false;
+                continue;
+            }
+            first = false;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    fprintf(out, "\n  ],\n");
+    fprintf(out, "  \"max_rss_kb\": %ld\n", usage.ru_maxrss);
+    fprintf(out, "}\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,487 @@
+// Benchmark de host (Linux) da biblioteca nativa: gera uma imagem XGD2
+// sintética e mede SHA-1, parse do GDF, getIsoInfo com e sem o cache de
+// metadados, a sessão de ISO e a conversão ISO → GOD completa.
+// Resultado em JSON no stdout; mensagens no stderr.
+//
+//   iso2god_bench [--size-mb N] [--files N] [--files-per-dir N]
+//                 [--zero-percent N] [--threads N] [--chunk-mb N]
+//                 [--iterations N] [--work-dir DIR] [--iso PATH]
+//                 [--buffered] [--game-partition-only] [--cold] [--keep]
+//                 [--no-stages] [--trace FILE]
+
+#include "synthetic_iso.h"
+#include "bench_util.h"
+#include "gdf_parser.h"
+#include "hash_utils.h"
+#include "iso2god_converter.h"
+#include "iso_metadata_cache.h"
+#include "iso_session.h"
+#include "iso_source.h"
+#include "xex_parser.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct BenchOptions {
+    SyntheticTitleSpec spec;
+    uint32_t threads = 0;
+    uint32_t chunkMb = 0;
+    uint32_t iterations = 3;
+    std::string workDir = "/tmp";
+    std::string isoPath;          // imagem existente: não gera
+    std::string tracePath;        // trace do Chrome da última conversão
+    bool stages = true;           // métricas por etapa (ConversionProfiler)
+    bool buffered = false;
+    bool gamePartitionOnly = false;
+    bool cold = false;
+    bool keep = false;
+};
+
+struct Timings {
+    std::vector<double> samples;
+
+    void add(double value) { samples.push_back(value); }
+
+    double min() const { return samples.empty() ? 0.0 : *std::min_element(samples.begin(), samples.end()); }
+    double max() const { return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end()); }
+
+    double median() const {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t middle = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    }
+};
+
+static double megabytesPerSecond(uint64_t bytes, double seconds) {
+    return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+static bool parseArguments(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--size-mb" && hasValue) {
+            options.spec.imageSize = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (arg == "--files" && hasValue) {
+            options.spec.fileCount = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--files-per-dir" && hasValue) {
+            options.spec.filesPerDirectory = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--zero-percent" && hasValue) {
+            options.spec.zeroPercent = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--chunk-mb" && hasValue) {
+            options.chunkMb = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--work-dir" && hasValue) {
+            options.workDir = argv[++i];
+        } else if (arg == "--iso" && hasValue) {
+            options.isoPath = argv[++i];
+        } else if (arg == "--buffered") {
+            options.buffered = true;
+        } else if (arg == "--game-partition-only") {
+            options.gamePartitionOnly = true;
+        } else if (arg == "--cold") {
+            options.cold = true;
+        } else if (arg == "--keep") {
+            options.keep = true;
+        } else if (arg == "--no-stages") {
+            options.stages = false;
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// SHA-1 de um buffer inteiro, bloco a bloco (como o conversor antigo) e
+// em lote (como o pipeline de hashing)
+static void benchSha1(uint32_t iterations, FILE* out) {
+    const size_t BUFFER_SIZE = 64 * 1024 * 1024;
+    const size_t BLOCK_SIZE = 4096;
+    const size_t BLOCK_COUNT = BUFFER_SIZE / BLOCK_SIZE;
+
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    uint64_t state = 0x123456789ABCDEFULL;
+    for (size_t i = 0; i + 8 <= buffer.size(); i += 8) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        memcpy(&buffer[i], &state, 8);
+    }
+
+    std::vector<const uint8_t*> blocks(BLOCK_COUNT);
+    for (size_t i = 0; i < BLOCK_COUNT; i++) {
+        blocks[i] = buffer.data() + i * BLOCK_SIZE;
+    }
+    std::vector<uint8_t> hashes(BLOCK_COUNT * HashUtils::SHA1_DIGEST_SIZE);
+
+    Timings whole;
+    Timings perBlock;
+    Timings batch;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        double start = nowSeconds();
+        HashUtils::calculateSHA1(buffer.data(), buffer.size(), hashes.data());
+        whole.add(nowSeconds() - start);
+
+        start = nowSeconds();
+        for (size_t i = 0; i < BLOCK_COUNT; i++) {
+            HashUtils::calculateSHA1(blocks[i], BLOCK_SIZE, hashes.data() + i * HashUtils::SHA1_DIGEST_SIZE);
+        }
+        perBlock.add(nowSeconds() - start);
+
+        start = nowSeconds();
+        HashUtils::calculateSHA1Batch(blocks.data(), BLOCK_COUNT, BLOCK_SIZE, hashes.data());
+        batch.add(nowSeconds() - start);
+    }
+
+    fprintf(out, "  \"sha1\": {\n");
+    fprintf(out, "    \"backend\": \"%s\",\n", HashUtils::getSha1BackendName());
+    fprintf(out, "    \"batch_backend\": \"%s\",\n", HashUtils::getSha1BatchBackendName());
+    fprintf(out, "    \"self_test\": %s,\n", HashUtils::runSha1SelfTest() ? "true" : "false");
+    fprintf(out, "    \"buffer_bytes\": %zu,\n", BUFFER_SIZE);
+    fprintf(out, "    \"single_stream_mbps\": %.1f,\n", megabytesPerSecond(BUFFER_SIZE, whole.min()));
+    fprintf(out, "    \"per_block_4k_mbps\": %.1f,\n", megabytesPerSecond(BUFFER_SIZE, perBlock.min()));
+    fprintf(out, "    \"batch_4k_mbps\": %.1f\n", megabytesPerSecond(BUFFER_SIZE, batch.min()));
+    fprintf(out, "  },\n");
+}
+
+static bool benchGdf(const std::string& isoPath, uint32_t iterations, FILE* out) {
+    std::unique_ptr<IsoSource> source = IsoSource::open(isoPath);
+    if (!source) {
+        fprintf(stderr, "Cannot open %s\n", isoPath.c_str());
+        return false;
+    }
+
+    Timings parse;
+    Timings openAndParse;
+    size_t entryCount = 0;
+    bool complete = false;
+    uint64_t partitionEnd = 0;
+
+    // A primeira rodada aquece o page cache e não entra na conta
+    for (uint32_t it = 0; it <= iterations; it++) {
+        GDFParser parser;
+        double start = nowSeconds();
+        if (!parser.parse(*source)) {
+            fprintf(stderr, "GDF parse failed\n");
+            return false;
+        }
+        double elapsed = nowSeconds() - start;
+
+        GDFParser pathParser;
+        start = nowSeconds();
+        pathParser.parse(isoPath);
+        double pathElapsed = nowSeconds() - start;
+
+        if (it > 0) {
+            parse.add(elapsed);
+            openAndParse.add(pathElapsed);
+        }
+        entryCount = parser.getEntries().size();
+        complete = parser.isComplete();
+        partitionEnd = parser.getGamePartitionEnd();
+    }
+
+    fprintf(out, "  \"gdf_parse\": {\n");
+    fprintf(out, "    \"entries\": %zu,\n", entryCount);
+    fprintf(out, "    \"complete\": %s,\n", complete ? "true" : "false");
+    fprintf(out, "    \"game_partition_end\": %llu,\n", (unsigned long long)partitionEnd);
+    fprintf(out, "    \"parse_us_min\": %.1f,\n", parse.min() * 1e6);
+    fprintf(out, "    \"parse_us_median\": %.1f,\n", parse.median() * 1e6);
+    fprintf(out, "    \"parse_us_max\": %.1f,\n", parse.max() * 1e6);
+    fprintf(out, "    \"open_and_parse_us_median\": %.1f\n", openAndParse.median() * 1e6);
+    fprintf(out, "  },\n");
+    return true;
+}
+
+// Quanto do default.xex o parse dos metadados lê de fato (modo pread,
+// como no getIsoInfo), só o cabeçalho e depois com nome e ícone do XDBF
+static bool measureXexRead(const std::string& isoPath, uint32_t& xexSize, uint64_t& bytesRead,
+                           uint64_t& bytesReadWithTitle) {
+    std::unique_ptr<IsoSource> source = IsoSource::open(isoPath, false);
+    GDFParser gdf;
+    if (!source || !gdf.parse(*source)) {
+        return false;
+    }
+
+    std::optional<GDFEntry> xexEntry = gdf.findFile("default.xex");
+    if (!xexEntry) {
+        return false;
+    }
+
+    uint64_t xexOffset = gdf.getRootOffset() + (uint64_t)xexEntry->sector * gdf.getSectorSize();
+    XexByteSource bytes(*source, xexOffset, xexEntry->size);
+    XexParser parser;
+    if (!parser.parse(bytes)) {
+        return false;
+    }
+
+    xexSize = xexEntry->size;
+    bytesRead = bytes.getBytesRead();
+
+    std::string titleName;
+    std::vector<uint8_t> icon;
+    parser.getTitleName(titleName);
+    parser.getTitleIcon(icon);
+    bytesReadWithTitle = bytes.getBytesRead();
+    return true;
+}
+
+static bool benchIsoInfo(const std::string& isoPath, const std::string& workDir, uint32_t iterations, FILE* out) {
+    std::string cacheDir = workDir + "/iso2god_bench_cache";
+    IsoMetadataCache cache(cacheDir);
+    Iso2GodConverter converter;
+    Timings parsed;
+    Timings cached;
+    Timings verified;
+
+    cache.remove(isoPath);
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        double start = nowSeconds();
+        std::unique_ptr<IsoInfo> info(converter.getIsoInfo(isoPath));
+        parsed.add(nowSeconds() - start);
+        if (!info) {
+            fprintf(stderr, "getIsoInfo failed\n");
+            return false;
+        }
+    }
+
+    // A primeira chamada com cache faz o parse e grava o registro
+    double start = nowSeconds();
+    std::unique_ptr<IsoInfo> first(converter.getIsoInfo(isoPath, cacheDir));
+    double storeSeconds = nowSeconds() - start;
+    if (!first) {
+        fprintf(stderr, "getIsoInfo with cache failed\n");
+        return false;
+    }
+
+    bool hits = true;
+    for (uint32_t it = 0; it < iterations; it++) {
+        start = nowSeconds();
+        std::unique_ptr<IsoInfo> info(converter.getIsoInfo(isoPath, cacheDir));
+        cached.add(nowSeconds() - start);
+
+        // Caminho da conversão: amostras conferidas e índice GDF carregado
+        IsoInfo verifiedInfo;
+        GDFParser gdf;
+        start = nowSeconds();
+        std::unique_ptr<IsoSource> source = IsoSource::open(isoPath);
+        hits = hits && info && source && cache.lookup(*source, verifiedInfo, &gdf) &&
+               info->titleId == first->titleId && verifiedInfo.gamePartitionEnd == first->gamePartitionEnd;
+        verified.add(nowSeconds() - start);
+    }
+
+    cache.remove(isoPath);
+    rmdir(cacheDir.c_str());
+
+    uint32_t xexSize = 0;
+    uint64_t xexBytesRead = 0;
+    uint64_t xexBytesReadWithTitle = 0;
+    if (!measureXexRead(isoPath, xexSize, xexBytesRead, xexBytesReadWithTitle)) {
+        fprintf(stderr, "default.xex read measurement failed\n");
+        return false;
+    }
+
+    // Tela de detalhes: tudo numa chamada, sem cache
+    TitleMetadata metadata;
+    start = nowSeconds();
+    bool metadataOk = converter.getTitleMetadata(isoPath, metadata);
+    double metadataSeconds = nowSeconds() - start;
+    if (!metadataOk) {
+        fprintf(stderr, "getTitleMetadata failed\n");
+        return false;
+    }
+
+    // Sessão: abre e analisa uma vez; os metadados depois saem dela
+    start = nowSeconds();
+    std::unique_ptr<IsoSession> session = converter.openSession(isoPath);
+    double sessionOpenSeconds = nowSeconds() - start;
+    TitleMetadata sessionMetadata;
+    start = nowSeconds();
+    bool sessionOk = session && converter.getTitleMetadata(*session, sessionMetadata);
+    double sessionMetadataSeconds = nowSeconds() - start;
+    if (!sessionOk || sessionMetadata.titleName != metadata.titleName) {
+        fprintf(stderr, "ISO session metadata failed\n");
+        return false;
+    }
+
+    fprintf(out, "  \"iso_info\": {\n");
+    fprintf(out, "    \"title_id\": \"%s\",\n", first->titleId.c_str());
+    fprintf(out, "    \"cache_hits\": %s,\n", hits ? "true" : "false");
+    fprintf(out, "    \"xex_size\": %u,\n", xexSize);
+    fprintf(out, "    \"xex_bytes_read\": %llu,\n", (unsigned long long)xexBytesRead);
+    fprintf(out, "    \"xex_bytes_read_with_title\": %llu,\n", (unsigned long long)xexBytesReadWithTitle);
+    fprintf(out, "    \"title_name\": \"%s\",\n", metadata.titleName.c_str());
+    fprintf(out, "    \"icon_bytes\": %zu,\n", metadata.iconPng.size());
+    fprintf(out, "    \"xex_aes_self_test\": %s,\n", XexCrypto::runSelfTest() ? "true" : "false");
+    fprintf(out, "    \"title_metadata_us\": %.1f,\n", metadataSeconds * 1e6);
+    fprintf(out, "    \"session_open_us\": %.1f,\n", sessionOpenSeconds * 1e6);
+    fprintf(out, "    \"session_title_metadata_us\": %.1f,\n", sessionMetadataSeconds * 1e6);
+    fprintf(out, "    \"parse_us_median\": %.1f,\n", parsed.median() * 1e6);
+    fprintf(out, "    \"parse_and_store_us\": %.1f,\n", storeSeconds * 1e6);
+    fprintf(out, "    \"cached_us_median\": %.1f,\n", cached.median() * 1e6);
+    fprintf(out, "    \"verified_with_gdf_us_median\": %.1f\n", verified.median() * 1e6);
+    fprintf(out, "  },\n");
+    return hits;
+}
+
+static bool benchConversion(const BenchOptions& options, const std::string& isoPath, uint64_t isoSize, FILE* out) {
+    ConversionOptions conversion;
+    conversion.threadCount = options.threads;
+    conversion.readChunkSize = options.chunkMb * 1024 * 1024;
+    conversion.payloadCopyMode = options.buffered ? PayloadCopyMode::Buffered : PayloadCopyMode::KernelCopy;
+    conversion.gamePartitionOnly = options.gamePartitionOnly;
+    conversion.collectMetrics = options.stages;
+
+    Timings total;
+    StageMetrics stages[(uint32_t)ConversionStage::Count];
+    ConversionStats lastStats;
+
+    for (uint32_t it = 0; it < options.iterations; it++) {
+        std::string outputPath = options.workDir + "/iso2god_bench_out";
+        removeTree(outputPath);
+        if (options.cold) {
+            dropFromPageCache(isoPath);
+        }
+
+        if (it + 1 == options.iterations) {
+            conversion.traceFilePath = options.tracePath;
+        }
+
+        Iso2GodConverter converter;
+        double start = nowSeconds();
+        int result = converter.convertIsoToGod(isoPath, outputPath, [](float, const std::string&) {}, conversion);
+        double elapsed = nowSeconds() - start;
+
+        if (result != 0) {
+            fprintf(stderr, "Conversion failed with %d\n", result);
+            return false;
+        }
+
+        total.add(elapsed);
+        lastStats = converter.getLastConversionStats();
+        for (uint32_t stage = 0; stage < (uint32_t)ConversionStage::Count; stage++) {
+            stages[stage] = converter.getProfiler().getStageMetrics((ConversionStage)stage);
+        }
+        fprintf(stderr, "conversion %u/%u: %.3fs\n", it + 1, options.iterations, elapsed);
+
+        if (!options.keep || it + 1 < options.iterations) {
+            removeTree(outputPath);
+        }
+    }
+
+    uint64_t convertedBytes = isoSize - lastStats.skippedBytes;
+
+    fprintf(out, "  \"conversion\": {\n");
+    fprintf(out, "    \"iterations\": %u,\n", options.iterations);
+    fprintf(out, "    \"cache\": \"%s\",\n", options.cold ? "cold" : "warm");
+    fprintf(out, "    \"payload_copy\": \"%s\",\n", options.buffered ? "buffered" : "kernel");
+    fprintf(out, "    \"threads\": %u,\n", options.threads ? options.threads : std::thread::hardware_concurrency());
+    fprintf(out, "    \"converted_bytes\": %llu,\n", (unsigned long long)convertedBytes);
+    fprintf(out, "    \"seconds_min\": %.3f,\n", total.min());
+    fprintf(out, "    \"seconds_median\": %.3f,\n", total.median());
+    fprintf(out, "    \"seconds_max\": %.3f,\n", total.max());
+    fprintf(out, "    \"throughput_mbps\": %.1f,\n", megabytesPerSecond(convertedBytes, total.median()));
+    fprintf(out, "    \"read_throughput_mbps\": %.1f,\n", lastStats.readThroughputMBps);
+    fprintf(out, "    \"kernel_copied_bytes\": %llu,\n", (unsigned long long)lastStats.kernelCopiedBytes);
+    fprintf(out, "    \"written_bytes\": %llu,\n", (unsigned long long)lastStats.writtenBytes);
+    fprintf(out, "    \"skipped_bytes\": %llu,\n", (unsigned long long)lastStats.skippedBytes);
+    fprintf(out, "    \"zero_blocks\": %llu%s\n", (unsigned long long)lastStats.zeroBlocks,
+            options.stages ? "," : "");
+
+    // Etapas da última conversão
+    if (options.stages) {
+        fprintf(out, "    \"stages\": {\n");
+        for (uint32_t stage = 0; stage < (uint32_t)ConversionStage::Count; stage++) {
+            const StageMetrics& metrics = stages[stage];
+            fprintf(out, "      \"%s\": {\"ops\": %llu, \"bytes\": %llu, \"ms\": %.3f, \"max_us\": %.1f, "
+                         "\"stalls\": %llu, \"stall_ms\": %.3f, \"histogram_log2_ns\": [",
+                    ConversionProfiler::getStageName((ConversionStage)stage),
+                    (unsigned long long)metrics.ops, (unsigned long long)metrics.bytes,
+                    metrics.totalNanos / 1e6, metrics.maxNanos / 1e3,
+                    (unsigned long long)metrics.stalls, metrics.stallNanos / 1e6);
+            for (uint32_t bucket = 0; bucket < StageMetrics::HISTOGRAM_BUCKETS; bucket++) {
+                fprintf(out, "%s%llu", bucket ? ", " : "", (unsigned long long)metrics.histogram[bucket]);
+            }
+            fprintf(out, "]}%s\n", stage + 1 < (uint32_t)ConversionStage::Count ? "," : "");
+        }
+        fprintf(out, "    }\n");
+    }
+    fprintf(out, "  }\n");
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 2;
+    }
+
+    bool generated = options.isoPath.empty();
+    std::string isoPath = generated ? options.workDir + "/iso2god_bench.iso" : options.isoPath;
+    GdfImageBuilder builder;
+    double generateSeconds = 0.0;
+
+    if (generated) {
+        double start = nowSeconds();
+        if (!generateSyntheticTitle(isoPath, options.spec, builder)) {
+            return 1;
+        }
+        generateSeconds = nowSeconds() - start;
+        fprintf(stderr, "Generated %s in %.2fs\n", isoPath.c_str(), generateSeconds);
+    }
+
+    std::unique_ptr<IsoSource> source = IsoSource::open(isoPath);
+    if (!source) {
+        fprintf(stderr, "Cannot open %s\n", isoPath.c_str());
+        return 1;
+    }
+    uint64_t isoSize = source->getSize();
+    source.reset();
+
+    FILE* out = stdout;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"image\": {\n");
+    fprintf(out, "    \"path\": \"%s\",\n", isoPath.c_str());
+    fprintf(out, "    \"synthetic\": %s,\n", generated ? "true" : "false");
+    fprintf(out, "    \"size_bytes\": %llu,\n", (unsigned long long)isoSize);
+    if (generated) {
+        fprintf(out, "    \"files\": %u,\n", builder.getFileCount());
+        fprintf(out, "    \"directories\": %u,\n", builder.getDirectoryCount());
+        fprintf(out, "    \"zero_percent\": %u,\n", options.spec.zeroPercent);
+        fprintf(out, "    \"game_partition_end\": %llu,\n", (unsigned long long)builder.getGamePartitionEnd());
+        fprintf(out, "    \"generate_seconds\": %.3f,\n", generateSeconds);
+    }
+    fprintf(out, "    \"hardware_threads\": %u\n", std::thread::hardware_concurrency());
+    fprintf(out, "  },\n");
+
+    benchSha1(options.iterations, out);
+
+    bool ok = benchGdf(isoPath, std::max(options.iterations, 10u), out) &&
+              benchIsoInfo(isoPath, options.workDir, std::max(options.iterations, 10u), out) &&
+              benchConversion(options, isoPath, isoSize, out);
+
+    fprintf(out, "}\n");
+
+    if (generated && !options.keep) {
+        unlink(isoPath.c_str());
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// Benchmark da varredura de biblioteca: gera uma pasta com vários ISOs
+// sintéticos (só metadados) e compara getIsoInfo em série, um arquivo por
+// vez como a camada Kotlin fazia, com o LibraryScanner sem cache e com o
+// cache de metadados já preenchido.
+// Resultado em JSON no stdout; mensagens no stderr.
+//
+//   library_scan_bench [--titles N] [--entries N] [--workers N]
+//                      [--io-per-device N] [--work-dir DIR] [--cold] [--keep]
+
+#include "synthetic_iso.h"
+#include "bench_util.h"
+#include "iso2god_converter.h"
+#include "library_scanner.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+struct ScanBenchOptions {
+    uint32_t titles = 200;
+    uint32_t entries = 2000;          // entries GDF por ISO
+    uint32_t workers = 0;
+    uint32_t ioPerDevice = 2;
+    std::string workDir = "/tmp";
+    bool cold = false;
+    bool keep = false;
+};
+
+struct ScanPass {
+    double seconds = 0.0;
+    uint32_t ok = 0;
+    uint32_t cacheHits = 0;
+    double firstResultSeconds = 0.0;  // do início até o primeiro resultado
+};
+
+static bool parseArguments(int argc, char** argv, ScanBenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--titles" && hasValue) {
+            options.titles = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--entries" && hasValue) {
+            options.entries = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--workers" && hasValue) {
+            options.workers = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--io-per-device" && hasValue) {
+            options.ioPerDevice = (uint32_t)atoi(argv[++i]);
+        } else if (arg == "--work-dir" && hasValue) {
+            options.workDir = argv[++i];
+        } else if (arg == "--cold") {
+            options.cold = true;
+        } else if (arg == "--keep") {
+            options.keep = true;
+        } else {
+            fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static ScanPass runSerial(const std::vector<std::string>& paths) {
+    Iso2GodConverter converter;
+    ScanPass pass;
+
+    double start = nowSeconds();
+    for (const std::string& path : paths) {
+        std::unique_ptr<IsoInfo> info(converter.getIsoInfo(path));
+        if (info) {
+            pass.ok++;
+        }
+        if (pass.firstResultSeconds == 0.0) {
+            pass.firstResultSeconds = nowSeconds() - start;
+        }
+    }
+    pass.seconds = nowSeconds() - start;
+    return pass;
+}
+
+static ScanPass runScanner(const std::string& libraryDir, const LibraryScanOptions& scanOptions) {
+    ScanPass pass;
+    std::vector<LibraryScanResult> batch;
+
+    double start = nowSeconds();
+    LibraryScanner scanner({libraryDir}, scanOptions);
+    while (scanner.nextResults(batch, 100)) {
+        if (!batch.empty() && pass.firstResultSeconds == 0.0) {
+            pass.firstResultSeconds = nowSeconds() - start;
+        }
+        for (const LibraryScanResult& result : batch) {
+            pass.ok += result.ok ? 1 : 0;
+            pass.cacheHits += result.fromCache ? 1 : 0;
+        }
+    }
+    pass.seconds = nowSeconds() - start;
+    return pass;
+}
+
+static void printPass(FILE* out, const char* name, const ScanPass& pass, uint32_t titles, bool last) {
+    fprintf(out, "    \"%s\": {\n", name);
+    fprintf(out, "      \"seconds\": %.4f,\n", pass.seconds);
+    fprintf(out, "      \"first_result_ms\": %.2f,\n", pass.firstResultSeconds * 1e3);
+    fprintf(out, "      \"titles_per_second\": %.1f,\n", pass.seconds > 0.0 ? titles / pass.seconds : 0.0);
+    fprintf(out, "      \"ok\": %u,\n", pass.ok);
+    fprintf(out, "      \"cache_hits\": %u\n", pass.cacheHits);
+    fprintf(out, "    }%s\n", last ? "" : ",");
+}
+
+int main(int argc, char** argv) {
+    ScanBenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 2;
+    }
+
+    std::string libraryDir = options.workDir + "/library_scan_bench";
+    std::string cacheDir = options.workDir + "/library_scan_bench_cache";
+    removeTree(libraryDir);
+    removeTree(cacheDir);
+    mkdir(libraryDir.c_str(), 0755);
+
+    // Metade dos ISOs numa subpasta, para a descoberta recursiva
+    std::string subDir = libraryDir + "/more";
+    mkdir(subDir.c_str(), 0755);
+
+    std::vector<std::string> paths;
+    double generateStart = nowSeconds();
+    for (uint32_t i = 0; i < options.titles; i++) {
+        GdfStressSpec spec;
+        spec.shape = GdfTreeShape::Balanced;
+        spec.entryCount = options.entries;
+        spec.seed = i + 1;
+
+        char name[32];
+        snprintf(name, sizeof(name), "/title%04u.iso", i);
+        std::string path = (i % 2 ? subDir : libraryDir) + name;
+
+        GdfImageBuilder builder;
+        if (!generateStressTree(path, spec, builder)) {
+            return 1;
+        }
+        paths.push_back(path);
+    }
+    fprintf(stderr, "Generated %u titles in %.2fs\n", options.titles, nowSeconds() - generateStart);
+
+    // Sem isso o writeback das imagens recém-geradas cai nas medições
+    sync();
+
+    LibraryScanOptions scanOptions;
+    scanOptions.workerThreads = options.workers;
+    scanOptions.ioPerDevice = options.ioPerDevice;
+
+    if (options.cold) {
+        dropFromPageCache(paths);
+    }
+    ScanPass serial = runSerial(paths);
+
+    if (options.cold) {
+        dropFromPageCache(paths);
+    }
+    ScanPass parallel = runScanner(libraryDir, scanOptions);
+
+    // Primeira passada com cache grava os registros, a segunda só os lê
+    scanOptions.metadataCacheDir = cacheDir;
+    if (options.cold) {
+        dropFromPageCache(paths);
+    }
+    ScanPass populate = runScanner(libraryDir, scanOptions);
+    ScanPass cached = runScanner(libraryDir, scanOptions);
+
+    FILE* out = stdout;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"titles\": %u,\n", options.titles);
+    fprintf(out, "  \"entries_per_title\": %u,\n", options.entries);
+    fprintf(out, "  \"cache\": \"%s\",\n", options.cold ? "cold" : "warm");
+    fprintf(out, "  \"io_per_device\": %u,\n", options.ioPerDevice);
+    fprintf(out, "  \"passes\": {\n");
+    printPass(out, "serial_get_iso_info", serial, options.titles, false);
+    printPass(out, "scanner", parallel, options.titles, false);
+    printPass(out, "scanner_populate_cache", populate, options.titles, false);
+    printPass(out, "scanner_cached", cached, options.titles, true);
+    fprintf(out, "  }\n");
+    fprintf(out, "}\n");
+
+    bool ok = serial.ok == options.titles && parallel.ok == options.titles &&
+              populate.ok == options.titles && cached.cacheHits == options.titles;
+    if (!ok) {
+        fprintf(stderr, "Scan results incomplete\n");
+    }
+
+    removeTree(cacheDir);
+    if (!options.keep) {
+        removeTree(libraryDir);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,621 @@
+#include "synthetic_iso.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+
+static const char GDF_MAGIC[] = "MICROSOFT*XBOX*MEDIA";
+static const size_t GDF_MAGIC_SIZE = 20;
+static const uint32_t FIRST_DATA_SECTOR = 34;   // depois do volume descriptor
+static const size_t WRITE_CHUNK = 1024 * 1024;
+
+// xorshift64*: rápido o bastante para gerar GBs sem dominar o tempo
+struct RandomStream {
+    uint64_t state;
+
+    explicit RandomStream(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    void fill(uint8_t* data, size_t size) {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t value = next();
+            memcpy(data + i, &value, 8);
+        }
+        uint64_t value = next();
+        memcpy(data + i, &value, size - i);
+    }
+};
+
+static void putUInt32BE(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+static void putUInt32LE(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static void putUInt16BE(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)(value >> 8);
+    out[1] = (uint8_t)value;
+}
+
+static void putUInt16LE(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static uint32_t entrySize(const std::string& name) {
+    return (14 + (uint32_t)name.size() + 3) & ~3u;
+}
+
+static uint32_t sectorsFor(uint64_t size) {
+    return (uint32_t)((size + GdfImageBuilder::SECTOR_SIZE - 1) / GdfImageBuilder::SECTOR_SIZE);
+}
+
+// Ordem de gravação de uma árvore balanceada sobre count nomes ordenados:
+// pré-ordem, então a raiz fica na primeira entry como o GDF exige
+static void treeOrder(int32_t low, int32_t high, std::vector<uint32_t>& order) {
+    if (low > high) {
+        return;
+    }
+    int32_t middle = low + (high - low) / 2;
+    order.push_back((uint32_t)middle);
+    treeOrder(low, middle - 1, order);
+    treeOrder(middle + 1, high, order);
+}
+
+// Posição (em bytes) de cada entry, na ordem de gravação, sem cruzar setores
+static uint32_t packEntries(const std::vector<uint32_t>& sizes, std::vector<uint32_t>& positions) {
+    uint32_t position = 0;
+    positions.resize(sizes.size());
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        uint32_t inSector = position % GdfImageBuilder::SECTOR_SIZE;
+        if (inSector + sizes[i] > GdfImageBuilder::SECTOR_SIZE) {
+            position += GdfImageBuilder::SECTOR_SIZE - inSector;
+        }
+        positions[i] = position;
+        position += sizes[i];
+    }
+    return sectorsFor(position) * GdfImageBuilder::SECTOR_SIZE;
+}
+
+static bool nameLess(const std::string& a, const std::string& b) {
+    return strcasecmp(a.c_str(), b.c_str()) < 0;
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, data, size, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "synthetic_iso: write failed at %llu: %s\n",
+                    (unsigned long long)offset, strerror(errno));
+            return false;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+static bool writeRandom(int fd, uint64_t offset, uint64_t size, RandomStream& random, std::vector<uint8_t>& buffer) {
+    while (size > 0) {
+        size_t chunk = (size_t)std::min<uint64_t>(size, buffer.size());
+        random.fill(buffer.data(), chunk);
+        if (!writeAll(fd, buffer.data(), chunk, offset)) {
+            return false;
+        }
+        offset += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+GdfImageBuilder::GdfImageBuilder()
+    : scatterDirectories(false),
+      titleId(0x4D5307E6),
+      seed(1),
+      fileCount(0),
+      directoryCount(1),
+      gamePartitionEnd(0),
+      imageBytes(0) {
+    Node root;
+    root.parent = ROOT_DIRECTORY;
+    root.isDirectory = true;
+    root.content = Content::Zero;
+    root.size = 0;
+    root.sector = 0;
+    nodes.push_back(root);
+}
+
+uint32_t GdfImageBuilder::addDirectory(uint32_t parent, const std::string& name) {
+    Node node;
+    node.name = name;
+    node.parent = parent;
+    node.isDirectory = true;
+    node.content = Content::Zero;
+    node.size = 0;
+    node.sector = 0;
+    nodes.push_back(node);
+
+    uint32_t index = (uint32_t)nodes.size() - 1;
+    nodes[parent].children.push_back(index);
+    directoryCount++;
+    return index;
+}
+
+uint32_t GdfImageBuilder::addFile(uint32_t parent, const std::string& name, uint32_t size, Content content) {
+    Node node;
+    node.name = name;
+    node.parent = parent;
+    node.isDirectory = false;
+    node.content = content;
+    node.size = size;
+    node.sector = 0;
+    nodes.push_back(node);
+
+    uint32_t index = (uint32_t)nodes.size() - 1;
+    nodes[parent].children.push_back(index);
+    fileCount++;
+    return index;
+}
+
+uint32_t GdfImageBuilder::directorySize(const std::vector<std::string>& names) {
+    std::vector<std::string> sorted(names);
+    std::sort(sorted.begin(), sorted.end(), nameLess);
+
+    std::vector<uint32_t> order;
+    treeOrder(0, (int32_t)sorted.size() - 1, order);
+
+    std::vector<uint32_t> sizes;
+    for (uint32_t index : order) {
+        sizes.push_back(entrySize(sorted[index]));
+    }
+
+    std::vector<uint32_t> positions;
+    return packEntries(sizes, positions);
+}
+
+void GdfImageBuilder::layout() {
+    // Filhos em ordem de nome: é a ordem da árvore no disco
+    for (Node& node : nodes) {
+        std::sort(node.children.begin(), node.children.end(), [this](uint32_t a, uint32_t b) {
+            return nameLess(nodes[a].name, nodes[b].name);
+        });
+        if (node.isDirectory) {
+            std::vector<std::string> names;
+            for (uint32_t child : node.children) {
+                names.push_back(nodes[child].name);
+            }
+            node.size = names.empty() ? 0 : directorySize(names);
+        }
+    }
+
+    uint32_t nextSector = FIRST_DATA_SECTOR;
+    auto allocate = [&nextSector](Node& node) {
+        node.sector = node.size > 0 ? nextSector : 0;
+        nextSector += sectorsFor(node.size);
+    };
+
+    // Em profundidade: cada diretório logo antes do seu conteúdo. Sem
+    // espalhar, todos os diretórios vêm antes do primeiro arquivo.
+    std::vector<uint32_t> stack(1, ROOT_DIRECTORY);
+    std::vector<uint32_t> files;
+
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        allocate(nodes[index]);
+
+        const Node& directory = nodes[index];
+        for (auto it = directory.children.rbegin(); it != directory.children.rend(); ++it) {
+            if (nodes[*it].isDirectory) {
+                stack.push_back(*it);
+            } else if (scatterDirectories) {
+                allocate(nodes[*it]);
+            } else {
+                files.push_back(*it);
+            }
+        }
+    }
+
+    for (uint32_t index : files) {
+        allocate(nodes[index]);
+    }
+
+    gamePartitionEnd = ROOT_OFFSET + (uint64_t)nextSector * SECTOR_SIZE;
+}
+
+void GdfImageBuilder::buildDirectory(const Node& directory, std::vector<uint8_t>& out) const {
+    std::vector<uint32_t> order;
+    treeOrder(0, (int32_t)directory.children.size() - 1, order);
+
+    std::vector<uint32_t> sizes;
+    for (uint32_t index : order) {
+        sizes.push_back(entrySize(nodes[directory.children[index]].name));
+    }
+
+    std::vector<uint32_t> positions;
+    out.assign(packEntries(sizes, positions), 0xFF);
+
+    // Posição de gravação de cada filho (por índice ordenado)
+    std::vector<uint32_t> positionOf(directory.children.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        positionOf[order[i]] = positions[i];
+    }
+
+    // Subárvores: o filho esquerdo de [low, high] com raiz middle é a
+    // raiz de [low, middle - 1], igual ao treeOrder
+    std::vector<int32_t> lows(directory.children.size());
+    std::vector<int32_t> highs(directory.children.size());
+    std::vector<std::pair<int32_t, int32_t>> ranges(1, {0, (int32_t)directory.children.size() - 1});
+    while (!ranges.empty()) {
+        std::pair<int32_t, int32_t> range = ranges.back();
+        ranges.pop_back();
+        if (range.first > range.second) {
+            continue;
+        }
+        int32_t middle = range.first + (range.second - range.first) / 2;
+        lows[middle] = range.first;
+        highs[middle] = range.second;
+        ranges.push_back({range.first, middle - 1});
+        ranges.push_back({middle + 1, range.second});
+    }
+
+    for (size_t i = 0; i < order.size(); i++) {
+        int32_t index = (int32_t)order[i];
+        const Node& child = nodes[directory.children[index]];
+        uint8_t* entry = out.data() + positions[i];
+
+        int32_t left = lows[index] <= index - 1 ? lows[index] + (index - 1 - lows[index]) / 2 : -1;
+        int32_t right = index + 1 <= highs[index] ? index + 1 + (highs[index] - index - 1) / 2 : -1;
+
+        putUInt16LE(entry, left >= 0 ? (uint16_t)(positionOf[left] / 4) : 0);
+        putUInt16LE(entry + 2, right >= 0 ? (uint16_t)(positionOf[right] / 4) : 0);
+        putUInt32LE(entry + 4, child.sector);
+        putUInt32LE(entry + 8, child.size);
+        entry[12] = child.isDirectory ? 0x10 : 0x80;
+        entry[13] = (uint8_t)child.name.size();
+        memcpy(entry + 14, child.name.data(), child.name.size());
+
+        // Padding até o próximo dword
+        uint32_t used = 14 + (uint32_t)child.name.size();
+        memset(entry + used, 0xFF, entrySize(child.name) - used);
+    }
+}
+
+// XDBF do título (SPA) mínimo: idioma padrão (XSTC), tabela de strings em
+// inglês com o nome e o ícone
+static void buildTitleXdbf(uint32_t titleId, std::vector<uint8_t>& out) {
+    char name[40];
+    snprintf(name, sizeof(name), "Synthetic Title %08X", titleId);
+    uint16_t nameLength = (uint16_t)strlen(name);
+
+    const uint32_t ENTRY_COUNT = 3;
+    const uint32_t XSTC_SIZE = 16;
+    const uint32_t XSTR_SIZE = 14 + 4 + nameLength;
+    const uint32_t ICON_SIZE = 64;
+    const uint32_t DATA_OFFSET = 24 + ENTRY_COUNT * 18;
+
+    out.assign(DATA_OFFSET + XSTC_SIZE + XSTR_SIZE + ICON_SIZE, 0);
+    uint8_t* xdbf = out.data();
+    memcpy(xdbf, "XDBF", 4);
+    putUInt32BE(xdbf + 4, 0x00010000);
+    putUInt32BE(xdbf + 8, ENTRY_COUNT);
+    putUInt32BE(xdbf + 12, ENTRY_COUNT);
+
+    // namespace, id (64 bits), offset na área de dados, tamanho
+    const uint32_t entries[ENTRY_COUNT][4] = {
+        {1, 0x58535443, 0, XSTC_SIZE},                               // XSTC
+        {3, 1, XSTC_SIZE, XSTR_SIZE},                                // strings em inglês
+        {2, 0x8000, XSTC_SIZE + XSTR_SIZE, ICON_SIZE}                // ícone
+    };
+    for (uint32_t i = 0; i < ENTRY_COUNT; i++) {
+        uint8_t* entry = xdbf + 24 + i * 18;
+        putUInt16BE(entry, (uint16_t)entries[i][0]);
+        putUInt32BE(entry + 6, entries[i][1]);
+        putUInt32BE(entry + 10, entries[i][2]);
+        putUInt32BE(entry + 14, entries[i][3]);
+    }
+
+    uint8_t* xstc = xdbf + DATA_OFFSET;
+    memcpy(xstc, "XSTC", 4);
+    putUInt32BE(xstc + 4, 1);
+    putUInt32BE(xstc + 8, 4);
+    putUInt32BE(xstc + 12, 1);                                       // inglês
+
+    uint8_t* xstr = xstc + XSTC_SIZE;
+    memcpy(xstr, "XSTR", 4);
+    putUInt32BE(xstr + 4, 1);
+    putUInt32BE(xstr + 8, XSTR_SIZE - 12);
+    putUInt16BE(xstr + 12, 1);
+    putUInt16BE(xstr + 14, 0x8000);
+    putUInt16BE(xstr + 16, nameLength);
+    memcpy(xstr + 18, name, nameLength);
+
+    static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    uint8_t* icon = xstr + XSTR_SIZE;
+    memcpy(icon, PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+    for (uint32_t i = sizeof(PNG_SIGNATURE); i < ICON_SIZE; i++) {
+        icon[i] = (uint8_t)(titleId >> (i % 4 * 8));
+    }
+}
+
+void GdfImageBuilder::buildXex(uint32_t size, std::vector<uint8_t>& out) const {
+    const uint32_t HEADER_SIZE = 0x1000;
+    const uint32_t EXECUTION_INFO_OFFSET = 0x100;
+    const uint32_t SECURITY_INFO_OFFSET = 0x200;
+    const uint32_t FILE_FORMAT_OFFSET = 0x400;
+    const uint32_t RESOURCE_INFO_OFFSET = 0x410;
+    const uint32_t LOAD_ADDRESS = 0x82000000;
+    const uint32_t XDBF_IMAGE_OFFSET = 0x1000;   // na imagem PE
+
+    out.assign(std::max(size, HEADER_SIZE), 0);
+    uint8_t* xex = out.data();
+
+    memcpy(xex, "XEX2", 4);
+    putUInt32BE(xex + 4, 0x00000001);            // módulo de título
+    putUInt32BE(xex + 8, HEADER_SIZE);           // início do PE
+    putUInt32BE(xex + 16, SECURITY_INFO_OFFSET);
+    putUInt32BE(xex + 20, 5);                    // optional headers
+
+    putUInt32BE(xex + 24, 0x00040006);           // ExecutionInfo
+    putUInt32BE(xex + 28, EXECUTION_INFO_OFFSET);
+    putUInt32BE(xex + 32, 0x00010100);           // entry point (valor no próprio header)
+    putUInt32BE(xex + 36, LOAD_ADDRESS);
+    putUInt32BE(xex + 40, 0x00010201);           // endereço base da imagem
+    putUInt32BE(xex + 44, LOAD_ADDRESS);
+    putUInt32BE(xex + 48, 0x000003FF);           // formato: sem cifra nem compressão
+    putUInt32BE(xex + 52, FILE_FORMAT_OFFSET);
+    putUInt32BE(xex + 56, 0x000002FF);           // resources (XDBF do título)
+    putUInt32BE(xex + 60, RESOURCE_INFO_OFFSET);
+
+    uint8_t* info = xex + EXECUTION_INFO_OFFSET;
+    putUInt32BE(info, (uint32_t)(seed * 0x9E3779B1u));   // media ID
+    putUInt32BE(info + 4, 0x00010000);                    // versão
+    putUInt32BE(info + 8, 0x00010000);                    // versão base
+    putUInt32BE(info + 12, titleId);
+    info[16] = 0;                                         // plataforma
+    info[17] = 0;                                         // tipo de executável
+    info[18] = 1;                                         // disco 1
+    info[19] = 1;                                         // de 1
+    putUInt32BE(info + 20, titleId);                      // save game ID
+
+    uint8_t* security = xex + SECURITY_INFO_OFFSET;
+    putUInt32BE(security, 0x184);
+    putUInt32BE(security + 4, (uint32_t)out.size() - HEADER_SIZE);
+    putUInt32BE(security + 0x110, LOAD_ADDRESS);
+
+    uint8_t* format = xex + FILE_FORMAT_OFFSET;
+    putUInt32BE(format, 8);
+
+    // Corpo do "PE": bytes aleatórios, com o XDBF do título se couber
+    RandomStream random(seed ^ 0x5845583200000000ULL);
+    random.fill(xex + HEADER_SIZE, out.size() - HEADER_SIZE);
+    memcpy(xex + HEADER_SIZE, "MZ", 2);
+
+    std::vector<uint8_t> xdbf;
+    buildTitleXdbf(titleId, xdbf);
+    if (HEADER_SIZE + XDBF_IMAGE_OFFSET + xdbf.size() <= out.size()) {
+        memcpy(xex + HEADER_SIZE + XDBF_IMAGE_OFFSET, xdbf.data(), xdbf.size());
+
+        uint8_t* resources = xex + RESOURCE_INFO_OFFSET;
+        char name[9];
+        snprintf(name, sizeof(name), "%08X", titleId);
+        putUInt32BE(resources, 4 + 16);
+        memcpy(resources + 4, name, 8);
+        putUInt32BE(resources + 12, LOAD_ADDRESS + XDBF_IMAGE_OFFSET);
+        putUInt32BE(resources + 16, (uint32_t)xdbf.size());
+    }
+}
+
+bool GdfImageBuilder::write(const std::string& path, uint64_t imageSize) {
+    layout();
+    imageBytes = std::max(imageSize, gamePartitionEnd);
+
+    for (const Node& node : nodes) {
+        if (node.isDirectory && node.size > MAX_DIRECTORY_SIZE) {
+            fprintf(stderr, "synthetic_iso: directory '%s' needs %u bytes (max %u)\n",
+                    node.name.c_str(), node.size, MAX_DIRECTORY_SIZE);
+            return false;
+        }
+    }
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "synthetic_iso: cannot create %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Tamanho final de uma vez: o que não for escrito fica como buraco
+    bool ok = ftruncate(fd, (off_t)imageBytes) == 0;
+
+    std::vector<uint8_t> buffer(WRITE_CHUNK);
+    RandomStream random(seed);
+
+    // Partição de vídeo do XGD2
+    ok = ok && writeRandom(fd, 0, ROOT_OFFSET, random, buffer);
+
+    // Volume descriptor (magic no início e no fim do setor)
+    std::vector<uint8_t> descriptor(SECTOR_SIZE, 0);
+    memcpy(descriptor.data(), GDF_MAGIC, GDF_MAGIC_SIZE);
+    putUInt32LE(descriptor.data() + 20, nodes[ROOT_DIRECTORY].sector);
+    putUInt32LE(descriptor.data() + 24, nodes[ROOT_DIRECTORY].size);
+    memcpy(descriptor.data() + SECTOR_SIZE - GDF_MAGIC_SIZE, GDF_MAGIC, GDF_MAGIC_SIZE);
+    ok = ok && writeAll(fd, descriptor.data(), descriptor.size(), ROOT_OFFSET + 32ULL * SECTOR_SIZE);
+
+    std::vector<uint8_t> block;
+    for (size_t i = 0; ok && i < nodes.size(); i++) {
+        const Node& node = nodes[i];
+        uint64_t offset = ROOT_OFFSET + (uint64_t)node.sector * SECTOR_SIZE;
+
+        if (node.isDirectory) {
+            if (node.size > 0) {
+                buildDirectory(node, block);
+                ok = writeAll(fd, block.data(), block.size(), offset);
+            }
+        } else if (node.content == Content::Xex) {
+            buildXex(node.size, block);
+            ok = writeAll(fd, block.data(), node.size, offset);
+        } else if (node.content == Content::Random) {
+            RandomStream fileRandom(seed ^ ((uint64_t)i * 0x9E3779B97F4A7C15ULL));
+            ok = writeRandom(fd, offset, node.size, fileRandom, buffer);
+        }
+    }
+
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "synthetic_iso: failed to write %s\n", path.c_str());
+    }
+    return ok;
+}
+
+bool generateSyntheticTitle(const std::string& path, const SyntheticTitleSpec& spec, GdfImageBuilder& builder) {
+    const uint32_t XEX_SIZE = 64 * 1024;
+    const uint64_t MAX_FILE_SIZE = 0xFFFFF800ULL;   // tamanho do GDF é uint32
+
+    builder.setTitleId(spec.titleId);
+    builder.setSeed(spec.seed);
+    builder.addFile(GdfImageBuilder::ROOT_DIRECTORY, "default.xex", XEX_SIZE, GdfImageBuilder::Content::Xex);
+
+    uint32_t fileCount = std::max(1u, spec.fileCount);
+    uint32_t perDirectory = std::max(1u, spec.filesPerDirectory);
+
+    // Cerca de 7/8 da imagem com dados; o resto é padding no fim
+    uint64_t partitionBudget = spec.imageSize / 8 * 7;
+    uint64_t payload = partitionBudget > GdfImageBuilder::ROOT_OFFSET + 4ULL * 1024 * 1024
+        ? partitionBudget - GdfImageBuilder::ROOT_OFFSET - 4ULL * 1024 * 1024
+        : 0;
+    uint64_t fileSize = payload / fileCount / GdfImageBuilder::SECTOR_SIZE * GdfImageBuilder::SECTOR_SIZE;
+    fileSize = std::min(fileSize, MAX_FILE_SIZE);
+
+    uint32_t directory = GdfImageBuilder::ROOT_DIRECTORY;
+    char name[32];
+
+    for (uint32_t i = 0; i < fileCount; i++) {
+        if (i % perDirectory == 0) {
+            snprintf(name, sizeof(name), "data%03u", i / perDirectory);
+            directory = builder.addDirectory(GdfImageBuilder::ROOT_DIRECTORY, name);
+        }
+
+        // Arquivos zerados espalhados pela imagem, não todos juntos
+        bool zero = (i * 37u) % 100u < spec.zeroPercent;
+        snprintf(name, sizeof(name), "file%05u.bin", i);
+        builder.addFile(directory, name, (uint32_t)fileSize,
+                        zero ? GdfImageBuilder::Content::Zero : GdfImageBuilder::Content::Random);
+    }
+
+    return builder.write(path, spec.imageSize);
+}
+
+const char* getTreeShapeName(GdfTreeShape shape) {
+    switch (shape) {
+        case GdfTreeShape::Wide: return "wide";
+        case GdfTreeShape::Deep: return "deep";
+        case GdfTreeShape::Balanced: return "balanced";
+        case GdfTreeShape::Scattered: return "scattered";
+    }
+    return "unknown";
+}
+
+bool parseTreeShape(const std::string& name, GdfTreeShape& shape) {
+    const GdfTreeShape shapes[] = {
+        GdfTreeShape::Wide, GdfTreeShape::Deep, GdfTreeShape::Balanced, GdfTreeShape::Scattered
+    };
+    for (GdfTreeShape candidate : shapes) {
+        if (name == getTreeShapeName(candidate)) {
+            shape = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool generateStressTree(const std::string& path, const GdfStressSpec& spec, GdfImageBuilder& builder) {
+    const uint32_t XEX_SIZE = 64 * 1024;
+
+    builder.setSeed(spec.seed);
+    builder.setScatterDirectories(spec.shape == GdfTreeShape::Scattered);
+    builder.addFile(GdfImageBuilder::ROOT_DIRECTORY, "default.xex", XEX_SIZE, GdfImageBuilder::Content::Xex);
+
+    // Arquivos de 1 a 8 setores: só ocupam espaço no layout, não no disco
+    RandomStream random(spec.seed);
+    uint32_t remaining = spec.entryCount;
+    uint32_t fileIndex = 0;
+    uint32_t directoryIndex = 0;
+    char name[32];
+
+    auto addFile = [&](uint32_t parent) {
+        snprintf(name, sizeof(name), "file%06u.dat", fileIndex++);
+        uint32_t sectors = 1 + (uint32_t)(random.next() % 8);
+        builder.addFile(parent, name, sectors * GdfImageBuilder::SECTOR_SIZE, GdfImageBuilder::Content::Zero);
+        remaining--;
+    };
+    auto addDirectory = [&](uint32_t parent) {
+        snprintf(name, sizeof(name), "dir%06u", directoryIndex++);
+        remaining--;
+        return builder.addDirectory(parent, name);
+    };
+
+    if (spec.shape == GdfTreeShape::Wide) {
+        // 4096 entries de ~32 bytes: 64 setores por diretório
+        uint32_t perDirectory = spec.fanout ? spec.fanout : 4096;
+        while (remaining > 0) {
+            uint32_t directory = addDirectory(GdfImageBuilder::ROOT_DIRECTORY);
+            for (uint32_t i = 0; i < perDirectory && remaining > 0; i++) {
+                addFile(directory);
+            }
+        }
+    } else if (spec.shape == GdfTreeShape::Deep) {
+        uint32_t depth = spec.depth ? spec.depth : 64;
+        uint32_t perLevel = spec.fanout ? spec.fanout : 4;
+        while (remaining > 0) {
+            uint32_t directory = GdfImageBuilder::ROOT_DIRECTORY;
+            for (uint32_t level = 0; level < depth && remaining > 0; level++) {
+                directory = addDirectory(directory);
+                for (uint32_t i = 0; i < perLevel && remaining > 0; i++) {
+                    addFile(directory);
+                }
+            }
+        }
+    } else {
+        // Em largura: cada diretório recebe fanout entries, 1 em cada 4
+        // é subdiretório
+        uint32_t perDirectory = spec.fanout ? spec.fanout : 16;
+        std::vector<uint32_t> queue(1, GdfImageBuilder::ROOT_DIRECTORY);
+        for (size_t next = 0; next < queue.size() && remaining > 0; next++) {
+            uint32_t directory = queue[next];
+            for (uint32_t i = 0; i < perDirectory && remaining > 0; i++) {
+                if (i % 4 == 0) {
+                    queue.push_back(addDirectory(directory));
+                } else {
+                    addFile(directory);
+                }
+            }
+        }
+    }
+
+    return builder.write(path, 0);
+}
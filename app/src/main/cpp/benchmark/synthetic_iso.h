@@ -0,0 +1,121 @@
+#ifndef SYNTHETIC_ISO_H
+#define SYNTHETIC_ISO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Gerador de imagens GDF/XGD2 sintéticas para os benchmarks.
+//
+// A imagem segue o layout de um disco real: partição de vídeo até o
+// rootOffset do XGD2 (0xFDA000), volume descriptor no setor 32 da
+// partição do jogo, diretórios como árvores binárias (a primeira entry é a
+// raiz, filhos por offset em dwords, entries sem cruzar setores e o resto
+// do setor com 0xFF) e os arquivos alinhados a setor. O default.xex é um
+// XEX2 válido com ExecutionInfo e o XDBF do título (nome e ícone).
+// Arquivos marcados como zerados e o padding final não são escritos: a
+// imagem fica esparsa.
+class GdfImageBuilder {
+public:
+    static const uint32_t ROOT_OFFSET = 0xFDA000;   // XGD2
+    static const uint32_t SECTOR_SIZE = 2048;
+    static constexpr uint32_t ROOT_DIRECTORY = 0;
+
+    // Offsets das subárvores são uint16 em dwords: 256 KiB por diretório
+    static const uint32_t MAX_DIRECTORY_SIZE = 0x40000;
+
+    enum class Content {
+        Random,  // bytes pseudo-aleatórios (não comprimíveis, sem blocos zerados)
+        Zero,    // só zeros (padding)
+        Xex      // default.xex válido
+    };
+
+    GdfImageBuilder();
+
+    // Retornam o índice do nó criado
+    uint32_t addDirectory(uint32_t parent, const std::string& name);
+    uint32_t addFile(uint32_t parent, const std::string& name, uint32_t size, Content content);
+
+    // Setores dos diretórios espalhados entre os arquivos em vez de todos
+    // no começo da partição (mais seeks ao ler a árvore)
+    void setScatterDirectories(bool scatter) { scatterDirectories = scatter; }
+
+    void setTitleId(uint32_t id) { titleId = id; }
+    void setSeed(uint64_t value) { seed = value; }
+
+    // Grava a imagem com imageSize bytes (ou só o necessário, se maior)
+    bool write(const std::string& path, uint64_t imageSize);
+
+    uint32_t getFileCount() const { return fileCount; }
+    uint32_t getDirectoryCount() const { return directoryCount; }
+
+    // Fim do último setor usado, absoluto na imagem (válido depois de write)
+    uint64_t getGamePartitionEnd() const { return gamePartitionEnd; }
+    uint64_t getImageSize() const { return imageBytes; }
+
+    // Tamanho em disco de um diretório com essas entries (múltiplo de setor)
+    static uint32_t directorySize(const std::vector<std::string>& names);
+
+private:
+    struct Node {
+        std::string name;
+        uint32_t parent;
+        bool isDirectory;
+        Content content;
+        uint32_t size;             // arquivos; diretórios calculado em layout()
+        uint32_t sector;
+        std::vector<uint32_t> children;
+    };
+
+    std::vector<Node> nodes;
+    bool scatterDirectories;
+    uint32_t titleId;
+    uint64_t seed;
+    uint32_t fileCount;
+    uint32_t directoryCount;
+    uint64_t gamePartitionEnd;
+    uint64_t imageBytes;
+
+    void layout();
+    void buildDirectory(const Node& directory, std::vector<uint8_t>& out) const;
+    void buildXex(uint32_t size, std::vector<uint8_t>& out) const;
+};
+
+// Parâmetros de um título sintético para o benchmark de conversão
+struct SyntheticTitleSpec {
+    uint64_t imageSize = 512ULL * 1024 * 1024;
+    uint32_t fileCount = 64;            // arquivos de dados, além do default.xex
+    uint32_t filesPerDirectory = 16;
+    uint32_t zeroPercent = 20;          // % dos arquivos de dados só com zeros
+    uint32_t titleId = 0x4D5307E6;
+    uint64_t seed = 1;
+};
+
+// Monta a árvore de um jogo (default.xex na raiz, dados em subpastas) que
+// ocupa cerca de 7/8 de imageSize e grava a imagem
+bool generateSyntheticTitle(const std::string& path, const SyntheticTitleSpec& spec, GdfImageBuilder& builder);
+
+// Formas de árvore do corpus de stress do GDFParser
+enum class GdfTreeShape {
+    Wide,       // poucos diretórios enormes (vários setores cada)
+    Deep,       // cadeias longas de subdiretórios com poucos arquivos por nível
+    Balanced,   // árvore cheia com fanout fixo
+    Scattered   // como Balanced, com os setores dos diretórios entre os arquivos
+};
+
+struct GdfStressSpec {
+    GdfTreeShape shape = GdfTreeShape::Balanced;
+    uint32_t entryCount = 100000;       // arquivos + diretórios, sem contar a raiz
+    uint32_t fanout = 0;                // entries por diretório (0 = padrão da forma)
+    uint32_t depth = 0;                 // níveis das cadeias de Deep (0 = padrão)
+    uint64_t seed = 1;
+};
+
+const char* getTreeShapeName(GdfTreeShape shape);
+bool parseTreeShape(const std::string& name, GdfTreeShape& shape);
+
+// Monta e grava uma imagem só com metadados (arquivos zerados, sem dados),
+// com um default.xex na raiz para continuar sendo um título válido
+bool generateStressTree(const std::string& path, const GdfStressSpec& spec, GdfImageBuilder& builder);
+
+#endif // SYNTHETIC_ISO_H
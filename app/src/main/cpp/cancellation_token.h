@@ -0,0 +1,26 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+// Pedido de cancelamento de uma conversão, feito de qualquer thread.
+//
+// Quem converte consulta isCancelled() a cada lote de blocos (cópia), a
+// cada parte (conferência do resume) e entre as etapas; o custo é uma
+// leitura relaxed. Quem cria o token controla o seu ciclo de vida: um
+// token cancelado antes de a conversão começar continua cancelado, ao
+// contrário do Iso2GodConverter::cancelConversion, que só alcança a
+// conversão em andamento.
+class CancellationToken {
+public:
+    CancellationToken() : cancelled(false) {}
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled.store(false, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled;
+};
+
+#endif // CANCELLATION_TOKEN_H
@@ -0,0 +1,74 @@
+#include "conversion_job.h"
+#include "iso_session.h"
+#include "native_log.h"
+#include <chrono>
+
+#define LOG_TAG "ConversionJob"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+ConversionJob::ConversionJob(std::shared_ptr<IsoSession> session, const std::string& outputPath,
+                             const ConversionOptions& options)
+    : session(std::move(session)),
+      outputPath(outputPath),
+      options(options),
+      finished(false) {
+    this->options.cancelToken = &cancelToken;
+}
+
+ConversionJob::~ConversionJob() {
+    cancel();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void ConversionJob::start() {
+    thread = std::thread(&ConversionJob::run, this);
+}
+
+void ConversionJob::run() {
+    LOGD("Conversion job started: %s", session->getPath().c_str());
+
+    // Cancelado antes de a thread começar: nem abre a saída
+    int result = -4;
+    if (!cancelToken.isCancelled()) {
+        result = converter.convertIsoToGod(*session, outputPath, ProgressCallback(), options);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    finishedCondition.notify_all();
+
+    LOGD("Conversion job finished with %d", result);
+}
+
+ConversionProgress ConversionJob::getProgress() const {
+    ConversionProgress progress = converter.getProgress();
+
+    // Antes de a thread chegar ao conversor a foto ainda é a de Idle
+    if (cancelToken.isCancelled() && isFinished() && !progress.isFinished()) {
+        progress.phase = ConversionPhase::Cancelled;
+        progress.result = -4;
+    }
+    return progress;
+}
+
+ConversionProgress ConversionJob::waitProgress(uint32_t timeoutMs) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finishedCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return finished; });
+    }
+    return getProgress();
+}
+
+void ConversionJob::cancel() {
+    cancelToken.cancel();
+}
+
+bool ConversionJob::isFinished() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return finished;
+}
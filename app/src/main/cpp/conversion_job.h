@@ -0,0 +1,63 @@
+#ifndef CONVERSION_JOB_H
+#define CONVERSION_JOB_H
+
+#include "iso2god_converter.h"
+#include "cancellation_token.h"
+#include "conversion_progress.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class IsoSession;
+
+// Conversão de uma IsoSession numa thread nativa própria.
+//
+// A thread chamadora só inicia e volta na hora; o andamento sai da foto
+// atômica do conversor (getProgress), sem callback: a conversão nunca
+// chama a JVM nem espera por quem acompanha. waitProgress() deixa quem
+// acompanha dormir até o intervalo seguinte ou até o fim, o que for
+// antes. O job mantém a sessão viva enquanto converte e tem o próprio
+// conversor e token de cancelamento, então vários jobs (de ISOs em discos
+// diferentes, por exemplo) rodam em paralelo sem interferir entre si.
+class ConversionJob {
+public:
+    ConversionJob(std::shared_ptr<IsoSession> session, const std::string& outputPath,
+                  const ConversionOptions& options);
+
+    // Cancela se ainda estiver rodando e espera a thread
+    ~ConversionJob();
+
+    void start();
+
+    ConversionProgress getProgress() const;
+
+    // Métricas por etapa (options.collectMetrics); podem ser lidas durante
+    // a conversão, os contadores são atômicos
+    const ConversionProfiler& getProfiler() const { return converter.getProfiler(); }
+
+    // Espera até timeoutMs pelo fim da conversão e devolve o andamento
+    ConversionProgress waitProgress(uint32_t timeoutMs);
+
+    void cancel();
+
+    bool isFinished() const;
+
+private:
+    std::shared_ptr<IsoSession> session;
+    std::string outputPath;
+    ConversionOptions options;
+    Iso2GodConverter converter;
+
+    CancellationToken cancelToken;
+    mutable std::mutex mutex;
+    std::condition_variable finishedCondition;
+    bool finished;
+    std::thread thread;
+
+    void run();
+};
+
+#endif // CONVERSION_JOB_H
@@ -0,0 +1,228 @@
+#include "conversion_journal.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "ConversionJournal"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// magic, versão, tamanho, mtime (s, ns), digest, faixa e número de partes
+static const size_t HEADER_SIZE = 4 + 4 + 8 + 8 + 8 + HashUtils::SHA1_DIGEST_SIZE + 8 + 8 + 4;
+
+template <typename T>
+static void appendValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T readValue(const uint8_t*& in) {
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+ConversionJournal::ConversionJournal(const std::string& journalPath)
+    : path(journalPath),
+      isoSize(0),
+      isoMtimeSec(0),
+      isoMtimeNsec(0),
+      startOffset(0),
+      endOffset(0) {
+    memset(isoDigest, 0, sizeof(isoDigest));
+}
+
+bool ConversionJournal::begin(IsoSource& source, uint64_t startOffset, uint64_t endOffset) {
+    struct stat st;
+    if (fstat(source.getFd(), &st) != 0) {
+        LOGE("Failed to stat ISO: %s", strerror(errno));
+        return false;
+    }
+
+    this->isoSize = source.getSize();
+    this->isoMtimeSec = st.st_mtim.tv_sec;
+    this->isoMtimeNsec = st.st_mtim.tv_nsec;
+    this->startOffset = startOffset;
+    this->endOffset = endOffset;
+    partDigests.clear();
+
+    return source.computeFingerprint(isoDigest);
+}
+
+const uint8_t* ConversionJournal::getPartDigest(uint32_t index) const {
+    if (index >= getCompletedParts()) {
+        return nullptr;
+    }
+    return partDigests.data() + (size_t)index * HashUtils::SHA1_DIGEST_SIZE;
+}
+
+void ConversionJournal::truncate(uint32_t partCount) {
+    if (partCount < getCompletedParts()) {
+        partDigests.resize((size_t)partCount * HashUtils::SHA1_DIGEST_SIZE);
+    }
+}
+
+void ConversionJournal::serialize(std::vector<uint8_t>& out) const {
+    out.clear();
+    appendValue(out, MAGIC);
+    appendValue(out, VERSION);
+    appendValue(out, isoSize);
+    appendValue(out, isoMtimeSec);
+    appendValue(out, isoMtimeNsec);
+    out.insert(out.end(), isoDigest, isoDigest + sizeof(isoDigest));
+    appendValue(out, startOffset);
+    appendValue(out, endOffset);
+    appendValue(out, getCompletedParts());
+    out.insert(out.end(), partDigests.begin(), partDigests.end());
+
+    uint8_t checksum[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1(out.data(), out.size(), checksum);
+    out.insert(out.end(), checksum, checksum + sizeof(checksum));
+}
+
+bool ConversionJournal::load() {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> file;
+    uint8_t buffer[4096];
+    for (;;) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        file.insert(file.end(), buffer, buffer + n);
+    }
+    close(fd);
+
+    if (file.size() < HEADER_SIZE + HashUtils::SHA1_DIGEST_SIZE) {
+        LOGE("Journal too short, ignoring: %s", path.c_str());
+        return false;
+    }
+
+    size_t bodySize = file.size() - HashUtils::SHA1_DIGEST_SIZE;
+    uint8_t checksum[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1(file.data(), bodySize, checksum);
+    if (memcmp(checksum, file.data() + bodySize, sizeof(checksum)) != 0) {
+        LOGE("Journal checksum mismatch, ignoring: %s", path.c_str());
+        return false;
+    }
+
+    const uint8_t* in = file.data();
+    uint32_t magic = readValue<uint32_t>(in);
+    uint32_t version = readValue<uint32_t>(in);
+    if (magic != MAGIC || version != VERSION) {
+        LOGE("Unknown journal format (magic 0x%08X, version %u)", magic, version);
+        return false;
+    }
+
+    uint64_t savedSize = readValue<uint64_t>(in);
+    int64_t savedMtimeSec = readValue<int64_t>(in);
+    int64_t savedMtimeNsec = readValue<int64_t>(in);
+    const uint8_t* savedDigest = in;
+    in += HashUtils::SHA1_DIGEST_SIZE;
+    uint64_t savedStart = readValue<uint64_t>(in);
+    uint64_t savedEnd = readValue<uint64_t>(in);
+    uint32_t savedParts = readValue<uint32_t>(in);
+
+    if (bodySize != HEADER_SIZE + (size_t)savedParts * HashUtils::SHA1_DIGEST_SIZE) {
+        LOGE("Journal size does not match its part count (%u)", savedParts);
+        return false;
+    }
+
+    if (savedSize != isoSize || savedMtimeSec != isoMtimeSec || savedMtimeNsec != isoMtimeNsec ||
+        memcmp(savedDigest, isoDigest, sizeof(isoDigest)) != 0) {
+        LOGD("Journal belongs to a different ISO, starting over");
+        return false;
+    }
+
+    if (savedStart != startOffset || savedEnd != endOffset) {
+        LOGD("Journal covers a different range (0x%llX-0x%llX), starting over",
+             (unsigned long long)savedStart, (unsigned long long)savedEnd);
+        return false;
+    }
+
+    partDigests.assign(in, in + (size_t)savedParts * HashUtils::SHA1_DIGEST_SIZE);
+
+    LOGD("Journal loaded: %u completed parts", savedParts);
+    return true;
+}
+
+bool ConversionJournal::save() {
+    std::vector<uint8_t> out;
+    serialize(out);
+
+    // Grava ao lado e troca com rename: o journal no disco está sempre
+    // inteiro, o antigo ou o novo
+    std::string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOGE("Failed to create journal: %s (%s)", tmpPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    const uint8_t* data = out.data();
+    size_t remaining = out.size();
+    bool written = true;
+
+    while (remaining > 0) {
+        ssize_t n = write(fd, data, remaining);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGE("Failed to write journal: %s", strerror(errno));
+            written = false;
+            break;
+        }
+        data += n;
+        remaining -= n;
+    }
+
+    if (written && fdatasync(fd) != 0) {
+        LOGE("Failed to sync journal: %s", strerror(errno));
+        written = false;
+    }
+    close(fd);
+
+    if (!written || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        if (written) {
+            LOGE("Failed to replace journal: %s", strerror(errno));
+        }
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ConversionJournal::addPart(uint32_t index, const uint8_t* masterDigest) {
+    if (index != getCompletedParts()) {
+        LOGE("Journal out of sequence: part %u after %u parts", index, getCompletedParts());
+        return false;
+    }
+
+    partDigests.insert(partDigests.end(), masterDigest, masterDigest + HashUtils::SHA1_DIGEST_SIZE);
+
+    if (!save()) {
+        return false;
+    }
+    LOGD("Checkpoint: part %u complete", index);
+    return true;
+}
+
+void ConversionJournal::remove() {
+    if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+        LOGE("Failed to remove journal: %s (%s)", path.c_str(), strerror(errno));
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef CONVERSION_JOURNAL_H
+#define CONVERSION_JOURNAL_H
+
+#include "hash_utils.h"
+#include "iso_source.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Checkpoint de uma conversão em andamento, gravado ao lado da saída a
+// cada parte DataNNNN concluída. Guarda a identidade do ISO (tamanho,
+// mtime e IsoSource::computeFingerprint()), a faixa convertida e, para
+// cada parte pronta, o SHA-1 da sua MHT (sem o encadeamento, que só é
+// gravado no fim). A MHT tem o hash de cada SHT, então com esse
+// digest dá para conferir as tabelas de uma parte sem reler os dados.
+//
+// O arquivo é regravado inteiro a cada parte (tmp + rename), com um SHA-1
+// no final: um journal truncado ou corrompido é simplesmente ignorado.
+class ConversionJournal {
+public:
+    explicit ConversionJournal(const std::string& journalPath);
+
+    // Identidade do ISO e faixa desta conversão; zera as partes
+    bool begin(IsoSource& source, uint64_t startOffset, uint64_t endOffset);
+
+    // Lê o journal do disco. true só se for da mesma conversão (mesmo ISO
+    // e mesma faixa); as partes registradas passam a valer.
+    bool load();
+
+    uint32_t getCompletedParts() const { return (uint32_t)(partDigests.size() / HashUtils::SHA1_DIGEST_SIZE); }
+    const uint8_t* getPartDigest(uint32_t index) const;
+
+    // Mantém só as primeiras partCount partes (as que passaram na validação)
+    void truncate(uint32_t partCount);
+
+    // Registra a parte index (a próxima da sequência) e regrava o journal
+    bool addPart(uint32_t index, const uint8_t* masterDigest);
+
+    // Conversão concluída: o journal não serve mais
+    void remove();
+
+    const std::string& getPath() const { return path; }
+
+private:
+    static const uint32_t MAGIC = 0x4A473249;   // "I2GJ"
+    static const uint32_t VERSION = 1;
+
+    std::string path;
+
+    uint64_t isoSize;
+    int64_t isoMtimeSec;
+    int64_t isoMtimeNsec;
+    uint8_t isoDigest[HashUtils::SHA1_DIGEST_SIZE];
+    uint64_t startOffset;
+    uint64_t endOffset;
+
+    std::vector<uint8_t> partDigests;   // 20 bytes por parte concluída
+
+    void serialize(std::vector<uint8_t>& out) const;
+    bool save();
+};
+
+#endif // CONVERSION_JOURNAL_H
@@ -0,0 +1,220 @@
+#include "conversion_profiler.h"
+#include "native_log.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#define LOG_TAG "ConversionProfiler"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// Id pequeno e estável por thread, para o campo "tid" do trace
+static std::atomic<uint32_t> nextThreadId(1);
+
+static uint32_t currentThreadId() {
+    static thread_local uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+static uint32_t histogramBucket(uint64_t nanos) {
+    uint32_t bucket = nanos > 1 ? 63 - (uint32_t)__builtin_clzll(nanos) : 0;
+    return bucket < StageMetrics::HISTOGRAM_BUCKETS ? bucket : StageMetrics::HISTOGRAM_BUCKETS - 1;
+}
+
+static void atomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+ConversionProfiler::ConversionProfiler()
+    : originNanos(0),
+      traceEnabled(false),
+      traceCount(0),
+      droppedEvents(0) {
+    reset(false);
+}
+
+void ConversionProfiler::reset(bool enableTrace) {
+    for (AtomicStage& stage : stages) {
+        stage.ops.store(0, std::memory_order_relaxed);
+        stage.bytes.store(0, std::memory_order_relaxed);
+        stage.blocks.store(0, std::memory_order_relaxed);
+        stage.totalNanos.store(0, std::memory_order_relaxed);
+        stage.maxNanos.store(0, std::memory_order_relaxed);
+        stage.stalls.store(0, std::memory_order_relaxed);
+        stage.stallNanos.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : stage.histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // O buffer do trace fica alocado entre conversões com trace
+    traceEnabled = enableTrace;
+    if (traceEnabled && !traceEvents) {
+        traceEvents.reset(new TraceEvent[TRACE_CAPACITY]);
+    } else if (!traceEnabled) {
+        traceEvents.reset();
+    }
+    traceCount.store(0, std::memory_order_relaxed);
+    droppedEvents.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(threadNamesMutex);
+        threadNames.clear();
+    }
+
+    originNanos = nowNanos();
+}
+
+uint64_t ConversionProfiler::nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ConversionProfiler::record(ConversionStage stage, uint64_t startNanos, uint64_t endNanos,
+                                uint64_t bytes, uint32_t blocks) {
+    AtomicStage& target = stages[(uint32_t)stage];
+    uint64_t nanos = endNanos - startNanos;
+
+    target.ops.fetch_add(1, std::memory_order_relaxed);
+    target.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    target.blocks.fetch_add(blocks, std::memory_order_relaxed);
+    target.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    atomicMax(target.maxNanos, nanos);
+    target.histogram[histogramBucket(blocks > 0 ? nanos / blocks : nanos)].fetch_add(1, std::memory_order_relaxed);
+
+    if (traceEnabled) {
+        addEvent(stage, startNanos, endNanos, bytes, false);
+    }
+}
+
+void ConversionProfiler::recordStall(ConversionStage stage, uint64_t startNanos, uint64_t endNanos) {
+    AtomicStage& target = stages[(uint32_t)stage];
+
+    target.stalls.fetch_add(1, std::memory_order_relaxed);
+    target.stallNanos.fetch_add(endNanos - startNanos, std::memory_order_relaxed);
+
+    if (traceEnabled) {
+        addEvent(stage, startNanos, endNanos, 0, true);
+    }
+}
+
+void ConversionProfiler::addEvent(ConversionStage stage, uint64_t startNanos, uint64_t endNanos,
+                                  uint64_t bytes, bool stall) {
+    uint32_t index = traceCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= TRACE_CAPACITY) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent& event = traceEvents[index];
+    event.startNanos = startNanos;
+    event.durationNanos = endNanos - startNanos;
+    event.bytes = bytes;
+    event.threadId = currentThreadId();
+    event.stage = (uint16_t)stage;
+    event.stall = stall ? 1 : 0;
+}
+
+void ConversionProfiler::setThreadName(const std::string& name) {
+    uint32_t threadId = currentThreadId();
+
+    std::lock_guard<std::mutex> lock(threadNamesMutex);
+    for (auto& entry : threadNames) {
+        if (entry.first == threadId) {
+            entry.second = name;
+            return;
+        }
+    }
+    threadNames.emplace_back(threadId, name);
+}
+
+StageMetrics ConversionProfiler::getStageMetrics(ConversionStage stage) const {
+    const AtomicStage& source = stages[(uint32_t)stage];
+    StageMetrics metrics;
+
+    metrics.ops = source.ops.load(std::memory_order_relaxed);
+    metrics.bytes = source.bytes.load(std::memory_order_relaxed);
+    metrics.blocks = source.blocks.load(std::memory_order_relaxed);
+    metrics.totalNanos = source.totalNanos.load(std::memory_order_relaxed);
+    metrics.maxNanos = source.maxNanos.load(std::memory_order_relaxed);
+    metrics.stalls = source.stalls.load(std::memory_order_relaxed);
+    metrics.stallNanos = source.stallNanos.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < StageMetrics::HISTOGRAM_BUCKETS; i++) {
+        metrics.histogram[i] = source.histogram[i].load(std::memory_order_relaxed);
+    }
+    return metrics;
+}
+
+bool ConversionProfiler::writeTrace(const std::string& path) const {
+    if (!traceEnabled || !traceEvents) {
+        LOGE("Trace requested but not enabled for this conversion");
+        return false;
+    }
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        LOGE("Cannot create trace file: %s (%s)", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    uint32_t count = traceCount.load(std::memory_order_acquire);
+    if (count > TRACE_CAPACITY) {
+        count = TRACE_CAPACITY;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"iso2god\"}}");
+
+    {
+        std::lock_guard<std::mutex> lock(threadNamesMutex);
+        for (const auto& entry : threadNames) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    entry.first, entry.second.c_str());
+        }
+    }
+
+    // Timestamps em microssegundos desde o reset()
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent& event = traceEvents[i];
+        double start = (double)(int64_t)(event.startNanos - originNanos) / 1000.0;
+        double duration = (double)event.durationNanos / 1000.0;
+
+        fprintf(file, ",\n{\"name\":\"%s%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bytes\":%llu}}",
+                getStageName((ConversionStage)event.stage), event.stall ? " stall" : "",
+                event.stall ? "stall" : "stage", event.threadId, start, duration,
+                (unsigned long long)event.bytes);
+    }
+
+    fprintf(file, "\n],\"otherData\":{\"droppedEvents\":%llu}}\n",
+            (unsigned long long)droppedEvents.load(std::memory_order_relaxed));
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+
+    if (ok) {
+        LOGD("Trace written: %s (%u events)", path.c_str(), count);
+    } else {
+        LOGE("Failed to write trace file: %s", path.c_str());
+    }
+    return ok;
+}
+
+const char* ConversionProfiler::getStageName(ConversionStage stage) {
+    switch (stage) {
+        case ConversionStage::GdfParse: return "GdfParse";
+        case ConversionStage::XexParse: return "XexParse";
+        case ConversionStage::Read: return "Read";
+        case ConversionStage::Hash: return "Hash";
+        case ConversionStage::Write: return "Write";
+        case ConversionStage::Finish: return "Finish";
+        case ConversionStage::Progress: return "Progress";
+        case ConversionStage::Count: break;
+    }
+    return "Unknown";
+}
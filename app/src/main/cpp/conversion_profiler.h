@@ -0,0 +1,145 @@
+#ifndef CONVERSION_PROFILER_H
+#define CONVERSION_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Etapas instrumentadas de uma conversão
+enum class ConversionStage : uint32_t {
+    GdfParse,    // árvore GDF (readIsoHeader)
+    XexParse,    // leitura e parse do default.xex
+    Read,        // IsoSource::view no leitor do pipeline
+    Hash,        // detecção de zeros + SHA-1 de um sub-lote
+    Write,       // GodLayoutWriter::writeBlocks (payload + hash tables)
+    Finish,      // última parte e encadeamento das MHTs
+    Progress,    // callback de progresso (JNI)
+    Count
+};
+
+// Números acumulados de uma etapa (cópia, não muda depois de lida)
+struct StageMetrics {
+    static const uint32_t HISTOGRAM_BUCKETS = 32;
+
+    uint64_t ops = 0;
+    uint64_t bytes = 0;
+    uint64_t blocks = 0;
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;      // operação mais longa
+
+    // Esperas em filas do pipeline: leitor sem buffer livre ou com a fila
+    // de hashing cheia (Read), workers sem trabalho (Hash), escritor
+    // esperando o próximo lote em ordem (Write)
+    uint64_t stalls = 0;
+    uint64_t stallNanos = 0;
+
+    // Latência por bloco de 4 KiB (por operação nas etapas sem blocos):
+    // o bucket i conta as amostras em [2^i, 2^(i+1)) ns
+    uint64_t histogram[HISTOGRAM_BUCKETS] = {};
+};
+
+// Contadores e timers por etapa do caminho quente da conversão, e
+// opcionalmente os eventos para um trace no formato do Chrome
+// (chrome://tracing, Perfetto).
+//
+// Quem instrumenta recebe um ConversionProfiler* que é nullptr quando a
+// coleta está desligada: o custo então é só o teste do ponteiro, sem
+// leitura de relógio. Os contadores são atômicos (relaxed) porque os
+// workers de hashing registram em paralelo; os eventos do trace vão para
+// um buffer pré-alocado com índice atômico e o que passar da capacidade é
+// descartado (e contado).
+class ConversionProfiler {
+public:
+    static const uint32_t TRACE_CAPACITY = 256 * 1024;   // eventos (8 MiB)
+
+    ConversionProfiler();
+
+    // Zera tudo para uma nova conversão
+    void reset(bool traceEnabled);
+
+    static uint64_t nowNanos();
+
+    // Operação [startNanos, endNanos) da etapa
+    void record(ConversionStage stage, uint64_t startNanos, uint64_t endNanos,
+                uint64_t bytes = 0, uint32_t blocks = 0);
+
+    void recordStall(ConversionStage stage, uint64_t startNanos, uint64_t endNanos);
+
+    // Nome da thread atual no trace ("reader", "hash-2"...)
+    void setThreadName(const std::string& name);
+
+    StageMetrics getStageMetrics(ConversionStage stage) const;
+    uint64_t getDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+
+    // Trace-event JSON (eventos "X" por operação e espera); false se o
+    // trace não foi habilitado ou o arquivo não pôde ser gravado
+    bool writeTrace(const std::string& path) const;
+
+    static const char* getStageName(ConversionStage stage);
+
+private:
+    struct AtomicStage {
+        std::atomic<uint64_t> ops;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> blocks;
+        std::atomic<uint64_t> totalNanos;
+        std::atomic<uint64_t> maxNanos;
+        std::atomic<uint64_t> stalls;
+        std::atomic<uint64_t> stallNanos;
+        std::atomic<uint64_t> histogram[StageMetrics::HISTOGRAM_BUCKETS];
+    };
+
+    struct TraceEvent {
+        uint64_t startNanos;
+        uint64_t durationNanos;
+        uint64_t bytes;
+        uint32_t threadId;
+        uint16_t stage;
+        uint16_t stall;
+    };
+
+    AtomicStage stages[(uint32_t)ConversionStage::Count];
+    uint64_t originNanos;
+
+    bool traceEnabled;
+    std::unique_ptr<TraceEvent[]> traceEvents;
+    std::atomic<uint32_t> traceCount;
+    std::atomic<uint64_t> droppedEvents;
+
+    mutable std::mutex threadNamesMutex;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+
+    void addEvent(ConversionStage stage, uint64_t startNanos, uint64_t endNanos, uint64_t bytes, bool stall);
+};
+
+// Mede o escopo como uma operação da etapa (nada se profiler for nullptr)
+class ProfileScope {
+public:
+    ProfileScope(ConversionProfiler* profiler, ConversionStage stage, uint64_t bytes = 0, uint32_t blocks = 0)
+        : profiler(profiler), stage(stage), bytes(bytes), blocks(blocks),
+          startNanos(profiler ? ConversionProfiler::nowNanos() : 0) {}
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->record(stage, startNanos, ConversionProfiler::nowNanos(), bytes, blocks);
+        }
+    }
+
+    // Bytes só conhecidos depois do trabalho (ex.: leituras sob demanda)
+    void setBytes(uint64_t value) { bytes = value; }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ConversionProfiler* profiler;
+    ConversionStage stage;
+    uint64_t bytes;
+    uint32_t blocks;
+    uint64_t startNanos;
+};
+
+#endif // CONVERSION_PROFILER_H
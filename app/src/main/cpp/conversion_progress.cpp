@@ -0,0 +1,138 @@
+#include "conversion_progress.h"
+#include "conversion_profiler.h"
+
+ConversionProgressTracker::ConversionProgressTracker()
+    : sequence(0),
+      phase((uint32_t)ConversionPhase::Idle),
+      progress(0.0f),
+      bytesDone(0),
+      totalBytes(0),
+      blocksDone(0),
+      totalBlocks(0),
+      copyStartBytes(0),
+      startNanos(0),
+      copyStartNanos(0),
+      endNanos(0),
+      result(0) {
+}
+
+void ConversionProgressTracker::beginWrite() {
+    // Ímpar: escrita em andamento. O fence impede que os stores seguintes
+    // fiquem visíveis antes do contador ímpar
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ConversionProgressTracker::endWrite() {
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void ConversionProgressTracker::start() {
+    beginWrite();
+    phase.store((uint32_t)ConversionPhase::Analyzing, std::memory_order_relaxed);
+    progress.store(0.0f, std::memory_order_relaxed);
+    bytesDone.store(0, std::memory_order_relaxed);
+    totalBytes.store(0, std::memory_order_relaxed);
+    blocksDone.store(0, std::memory_order_relaxed);
+    totalBlocks.store(0, std::memory_order_relaxed);
+    copyStartBytes.store(0, std::memory_order_relaxed);
+    startNanos.store(ConversionProfiler::nowNanos(), std::memory_order_relaxed);
+    copyStartNanos.store(0, std::memory_order_relaxed);
+    endNanos.store(0, std::memory_order_relaxed);
+    result.store(0, std::memory_order_relaxed);
+    endWrite();
+}
+
+void ConversionProgressTracker::setPhase(ConversionPhase newPhase, float newProgress) {
+    beginWrite();
+    phase.store((uint32_t)newPhase, std::memory_order_relaxed);
+    progress.store(newProgress, std::memory_order_relaxed);
+    endWrite();
+}
+
+void ConversionProgressTracker::beginCopy(uint64_t total, uint64_t totalBlockCount,
+                                          uint64_t resumedBytes, uint64_t resumedBlocks) {
+    beginWrite();
+    phase.store((uint32_t)ConversionPhase::Copying, std::memory_order_relaxed);
+    totalBytes.store(total, std::memory_order_relaxed);
+    totalBlocks.store(totalBlockCount, std::memory_order_relaxed);
+    bytesDone.store(resumedBytes, std::memory_order_relaxed);
+    blocksDone.store(resumedBlocks, std::memory_order_relaxed);
+    copyStartBytes.store(resumedBytes, std::memory_order_relaxed);
+    copyStartNanos.store(ConversionProfiler::nowNanos(), std::memory_order_relaxed);
+    endWrite();
+}
+
+void ConversionProgressTracker::update(uint64_t bytes, uint64_t blocks, float newProgress) {
+    beginWrite();
+    bytesDone.store(bytes, std::memory_order_relaxed);
+    blocksDone.store(blocks, std::memory_order_relaxed);
+    progress.store(newProgress, std::memory_order_relaxed);
+    endWrite();
+}
+
+void ConversionProgressTracker::finish(int code) {
+    ConversionPhase finalPhase = ConversionPhase::Failed;
+    if (code == 0) {
+        finalPhase = ConversionPhase::Done;
+    } else if (code == -4) {
+        finalPhase = ConversionPhase::Cancelled;
+    }
+
+    beginWrite();
+    phase.store((uint32_t)finalPhase, std::memory_order_relaxed);
+    if (code == 0) {
+        progress.store(1.0f, std::memory_order_relaxed);
+    }
+    result.store(code, std::memory_order_relaxed);
+    endNanos.store(ConversionProfiler::nowNanos(), std::memory_order_relaxed);
+    endWrite();
+}
+
+ConversionProgress ConversionProgressTracker::snapshot() const {
+    ConversionProgress snap;
+    uint64_t start;
+    uint64_t copyStart;
+    uint64_t copyStartDone;
+    uint64_t end;
+
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        snap.phase = (ConversionPhase)phase.load(std::memory_order_relaxed);
+        snap.progress = progress.load(std::memory_order_relaxed);
+        snap.bytesDone = bytesDone.load(std::memory_order_relaxed);
+        snap.totalBytes = totalBytes.load(std::memory_order_relaxed);
+        snap.blocksDone = blocksDone.load(std::memory_order_relaxed);
+        snap.totalBlocks = totalBlocks.load(std::memory_order_relaxed);
+        snap.result = result.load(std::memory_order_relaxed);
+        start = startNanos.load(std::memory_order_relaxed);
+        copyStart = copyStartNanos.load(std::memory_order_relaxed);
+        copyStartDone = copyStartBytes.load(std::memory_order_relaxed);
+        end = endNanos.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    if (start == 0) {
+        return snap;
+    }
+
+    uint64_t now = end != 0 ? end : ConversionProfiler::nowNanos();
+    snap.elapsedSeconds = (now - start) / 1e9;
+
+    if (copyStart != 0 && now > copyStart) {
+        double copySeconds = (now - copyStart) / 1e9;
+        double copiedBytes = (double)(snap.bytesDone - copyStartDone);
+        snap.throughputMBps = (copiedBytes / (1024.0 * 1024.0)) / copySeconds;
+
+        if (!snap.isFinished() && copiedBytes > 0 && snap.totalBytes >= snap.bytesDone) {
+            snap.etaSeconds = (snap.totalBytes - snap.bytesDone) / (copiedBytes / copySeconds);
+        }
+    }
+    if (snap.isFinished()) {
+        snap.etaSeconds = 0.0;
+    }
+    return snap;
+}
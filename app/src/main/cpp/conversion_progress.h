@@ -0,0 +1,82 @@
+#ifndef CONVERSION_PROGRESS_H
+#define CONVERSION_PROGRESS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Fase da conversão, na ordem em que acontecem; as três últimas são finais
+enum class ConversionPhase : uint32_t {
+    Idle = 0,
+    Analyzing = 1,    // abertura do ISO, GDF e XEX
+    Preparing = 2,    // pasta GOD e arquivo de cabeçalho
+    Verifying = 3,    // conferência das partes do journal (resume)
+    Copying = 4,      // blocos do ISO para as partes Data
+    Finishing = 5,    // última parte e hash tables
+    Done = 6,
+    Failed = 7,
+    Cancelled = 8
+};
+
+// Foto do andamento (cópia; os campos são coerentes entre si)
+struct ConversionProgress {
+    ConversionPhase phase = ConversionPhase::Idle;
+    float progress = 0.0f;        // 0-1, o mesmo valor do ProgressCallback
+    uint64_t bytesDone = 0;       // bytes da faixa convertida já gravados (com os retomados)
+    uint64_t totalBytes = 0;
+    uint64_t blocksDone = 0;
+    uint64_t totalBlocks = 0;
+    double elapsedSeconds = 0.0;
+    double throughputMBps = 0.0;  // desde o início da cópia, sem as partes retomadas
+    double etaSeconds = -1.0;     // -1 enquanto não há como estimar
+    int result = 0;               // código de convertIsoToGod nas fases finais
+
+    bool isFinished() const { return phase >= ConversionPhase::Done; }
+};
+
+// Andamento publicado pela thread da conversão e lido por qualquer outra
+// sem lock.
+//
+// Um só escritor (a thread que converte) grava campos atômicos relaxed
+// entre dois incrementos de um contador de sequência (seqlock): quem lê
+// repete a leitura se o contador mudou ou estava ímpar no meio, então a
+// foto nunca mistura dois updates e a conversão nunca espera por quem
+// lê. Vazão e ETA são calculados na leitura, não no caminho quente.
+class ConversionProgressTracker {
+public:
+    ConversionProgressTracker();
+
+    // Zera para uma nova conversão e marca o início (Analyzing)
+    void start();
+
+    void setPhase(ConversionPhase phase, float progress);
+
+    // Início da fase Copying; resumedBytes/resumedBlocks já estavam prontos
+    void beginCopy(uint64_t totalBytes, uint64_t totalBlocks, uint64_t resumedBytes, uint64_t resumedBlocks);
+
+    // Caminho quente: alguns stores relaxed por lote de blocos
+    void update(uint64_t bytesDone, uint64_t blocksDone, float progress);
+
+    // Fase final a partir do código de retorno (0, -4 = cancelada, outro)
+    void finish(int result);
+
+    ConversionProgress snapshot() const;
+
+private:
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> phase;
+    std::atomic<float> progress;
+    std::atomic<uint64_t> bytesDone;
+    std::atomic<uint64_t> totalBytes;
+    std::atomic<uint64_t> blocksDone;
+    std::atomic<uint64_t> totalBlocks;
+    std::atomic<uint64_t> copyStartBytes;
+    std::atomic<uint64_t> startNanos;
+    std::atomic<uint64_t> copyStartNanos;
+    std::atomic<uint64_t> endNanos;     // 0 enquanto não terminou
+    std::atomic<int> result;
+
+    void beginWrite();
+    void endWrite();
+};
+
+#endif // CONVERSION_PROGRESS_H
@@ -0,0 +1,460 @@
+#include "data_pipeline.h"
+#include "hash_utils.h"
+#include "native_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#define LOG_TAG "DataPipeline"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Espera progressiva: alguns giros, depois yield e por fim sleep curto
+static void backoff(uint32_t& spins) {
+    spins++;
+    if (spins < 64) {
+        return;
+    }
+    if (spins < 128) {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+// As esperas (fila cheia ou vazia) contam como stall da etapa de quem espera
+template <typename T>
+static bool pushWithBackpressure(BoundedQueue<T>& queue, const T& value, const std::atomic<bool>& stop,
+                                 ConversionProfiler* profiler, ConversionStage stage) {
+    if (queue.tryPush(value)) {
+        return true;
+    }
+
+    uint64_t stallStart = profiler ? ConversionProfiler::nowNanos() : 0;
+    uint32_t spins = 0;
+    bool pushed = true;
+
+    while (!queue.tryPush(value)) {
+        if (stop.load(std::memory_order_acquire)) {
+            pushed = false;
+            break;
+        }
+        backoff(spins);
+    }
+
+    if (profiler) {
+        profiler->recordStall(stage, stallStart, ConversionProfiler::nowNanos());
+    }
+    return pushed;
+}
+
+template <typename T>
+static bool popWithBackpressure(BoundedQueue<T>& queue, T& value, const std::atomic<bool>& stop,
+                                ConversionProfiler* profiler, ConversionStage stage) {
+    if (queue.tryPop(value)) {
+        return true;
+    }
+
+    uint64_t stallStart = profiler ? ConversionProfiler::nowNanos() : 0;
+    uint32_t spins = 0;
+    bool popped = true;
+
+    while (!queue.tryPop(value)) {
+        if (stop.load(std::memory_order_acquire)) {
+            popped = false;
+            break;
+        }
+        backoff(spins);
+    }
+
+    if (profiler) {
+        profiler->recordStall(stage, stallStart, ConversionProfiler::nowNanos());
+    }
+    return popped;
+}
+
+static uint32_t clampHashThreads(uint32_t hashThreads) {
+    return hashThreads > DataPipeline::MAX_HASH_THREADS ? DataPipeline::MAX_HASH_THREADS : hashThreads;
+}
+
+// Tamanho do lote de leitura em blocos: entre 1 e 16 MiB, múltiplo de 4 KiB
+static uint32_t chunkBlocksFor(uint32_t chunkSize) {
+    if (chunkSize == 0) {
+        chunkSize = DataPipeline::DEFAULT_CHUNK_SIZE;
+    }
+    chunkSize = std::max(chunkSize, DataPipeline::MIN_CHUNK_SIZE + 0);
+    chunkSize = std::min(chunkSize, DataPipeline::MAX_CHUNK_SIZE + 0);
+    return chunkSize / DataPipeline::BLOCK_SIZE;
+}
+
+// Buffers em voo: o suficiente para dois sub-lotes por worker mais um no
+// leitor e um no escritor, limitado pelo orçamento de memória
+static uint32_t poolSizeFor(uint32_t hashThreads, uint32_t chunkBlocks) {
+    if (hashThreads <= 1) {
+        return 1;
+    }
+
+    uint32_t wantedTasks = hashThreads * 2 + 2;
+    uint32_t wanted = (wantedTasks * DataPipeline::HASH_TASK_BLOCKS + chunkBlocks - 1) / chunkBlocks;
+    uint32_t budget = DataPipeline::BUFFER_MEMORY_BUDGET / (chunkBlocks * DataPipeline::BLOCK_SIZE);
+
+    return std::max(3u, std::min(wanted, budget));
+}
+
+static uint32_t tasksPerChunk(uint32_t blockCount) {
+    return (blockCount + DataPipeline::HASH_TASK_BLOCKS - 1) / DataPipeline::HASH_TASK_BLOCKS;
+}
+
+DataPipeline::DataPipeline(
+    IsoSource& source,
+    uint64_t startOffset,
+    uint64_t endOffset,
+    uint32_t hashThreads,
+    uint32_t chunkSize,
+    ConversionProfiler* profiler
+)
+    : source(source),
+      profiler(profiler),
+      endOffset(endOffset < source.getSize() ? endOffset : source.getSize()),
+      hashThreads(clampHashThreads(hashThreads)),
+      chunkBlocks(chunkBlocksFor(chunkSize)),
+      poolSize(poolSizeFor(clampHashThreads(hashThreads), chunkBlocksFor(chunkSize))),
+      readOffset(startOffset),
+      readSequence(0),
+      startNanos(0),
+      readStats(),
+      freeQueue(poolSize),
+      hashQueue(poolSize * tasksPerChunk(chunkBlocks)),
+      doneQueue(poolSize),
+      nextSequence(0),
+      stopRequested(false),
+      readerDone(false),
+      readFailed(false),
+      totalChunks(0),
+      started(false) {
+}
+
+DataPipeline::~DataPipeline() {
+    stop();
+}
+
+bool DataPipeline::start() {
+    // Leitura sequencial: o kernel pode dobrar a janela de readahead
+    source.adviseSequential();
+
+    // Com o ISO mapeado os lotes apontam para o mapeamento: sem buffers
+    size_t chunkBytes = (size_t)chunkBlocks * BLOCK_SIZE;
+    if (!source.isMapped()) {
+        dataPool.resize((size_t)poolSize * chunkBytes);
+    }
+    hashPool.resize((size_t)poolSize * chunkBlocks * HashUtils::SHA1_DIGEST_SIZE);
+    zeroFlagPool.resize((size_t)poolSize * chunkBlocks);
+    chunks.reset(new PipelineChunk[poolSize]);
+    pending.assign(poolSize, nullptr);
+
+    for (uint32_t i = 0; i < poolSize; i++) {
+        chunks[i].data = nullptr;
+        chunks[i].buffer = dataPool.empty() ? nullptr : dataPool.data() + (size_t)i * chunkBytes;
+        chunks[i].hashes = hashPool.data() + (size_t)i * chunkBlocks * HashUtils::SHA1_DIGEST_SIZE;
+        chunks[i].zeroFlags = zeroFlagPool.data() + (size_t)i * chunkBlocks;
+        chunks[i].pendingTasks.store(0, std::memory_order_relaxed);
+    }
+
+    startNanos = nowNanos();
+    started = true;
+
+    if (hashThreads <= 1) {
+        LOGD("Pipeline started in serial mode, %u KiB %s", (uint32_t)(chunkBytes / 1024),
+             source.isMapped() ? "mapped views" : "reads");
+        return true;
+    }
+
+    for (uint32_t i = 0; i < poolSize; i++) {
+        freeQueue.tryPush(&chunks[i]);
+    }
+
+    readerThread = std::thread(&DataPipeline::readerLoop, this);
+    for (uint32_t i = 0; i < hashThreads; i++) {
+        hashWorkers.emplace_back(&DataPipeline::hashLoop, this, i);
+    }
+
+    LOGD("Pipeline started: 1 reader, %u hash workers, %u chunks of %u KiB (%s)",
+         hashThreads, poolSize, (uint32_t)(chunkBytes / 1024),
+         source.isMapped() ? "mapped" : "pread");
+    return true;
+}
+
+void DataPipeline::stop() {
+    stopRequested.store(true, std::memory_order_release);
+
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+    for (auto& worker : hashWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    hashWorkers.clear();
+}
+
+DataPipeline::ReadResult DataPipeline::readChunk(PipelineChunk* chunk) {
+    if (readOffset >= endOffset) {
+        return ReadResult::EndOfData;
+    }
+
+    const uint64_t chunkBytes = (uint64_t)chunkBlocks * BLOCK_SIZE;
+    size_t toRead = std::min(chunkBytes, endOffset - readOffset);
+    uint32_t blockCount = (toRead + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    size_t paddedBytes = (size_t)blockCount * BLOCK_SIZE;
+
+    // Último bloco parcial: precisa de um buffer para completar com zeros
+    uint8_t* buffer = chunk->buffer;
+    if (paddedBytes != toRead && !buffer) {
+        tailBuffer.resize(paddedBytes);
+        buffer = tailBuffer.data();
+    }
+
+    uint64_t readStart = nowNanos();
+    const uint8_t* data = source.view(readOffset, toRead, buffer);
+    uint64_t readEnd = nowNanos();
+
+    readStats.readCalls++;
+    readStats.readNanos += readEnd - readStart;
+    if (profiler) {
+        profiler->record(ConversionStage::Read, readStart, readEnd, data ? toRead : 0, data ? blockCount : 0);
+    }
+
+    if (data) {
+        if (paddedBytes != toRead) {
+            if (data != buffer) {
+                memcpy(buffer, data, toRead);
+            }
+            memset(buffer + toRead, 0, paddedBytes - toRead);
+            data = buffer;
+        }
+
+        chunk->sequence = readSequence++;
+        chunk->offset = readOffset;
+        chunk->dataBytes = toRead;
+        chunk->blockCount = blockCount;
+        chunk->data = data;
+
+        readOffset += toRead;
+        readStats.bytesRead += toRead;
+        readStats.wallNanos = readEnd - startNanos;
+
+        // Readahead do próximo lote enquanto este é processado
+        if (readOffset < endOffset) {
+            source.willNeed(readOffset, std::min(chunkBytes, endOffset - readOffset));
+        }
+        return ReadResult::Ok;
+    }
+
+    // Sem nova tentativa: um erro de E/S aqui não melhora repetindo na hora,
+    // e parar antes do fim com sucesso geraria um GOD truncado
+    LOGE("Failed to read from ISO at offset %llu", (unsigned long long)readOffset);
+    readFailed.store(true, std::memory_order_release);
+    return ReadResult::Error;
+}
+
+void DataPipeline::hashBlocks(PipelineChunk* chunk, uint32_t firstBlock, uint32_t blockCount) {
+    const uint8_t* blockPtrs[HASH_TASK_BLOCKS];
+    uint32_t blockIndex[HASH_TASK_BLOCKS];
+    uint8_t batchHashes[HASH_TASK_BLOCKS * HashUtils::SHA1_DIGEST_SIZE];
+    const uint8_t* zeroHash = HashUtils::getZeroBlockSHA1();
+
+    while (blockCount > 0) {
+        uint32_t batch = std::min(blockCount, HASH_TASK_BLOCKS + 0);
+        uint32_t toHash = 0;
+
+        // Blocos zerados recebem o hash pronto; o resto vai para o lote
+        for (uint32_t i = 0; i < batch; i++) {
+            uint32_t block = firstBlock + i;
+            const uint8_t* data = chunk->data + (size_t)block * BLOCK_SIZE;
+            bool zero = HashUtils::isZeroBlock(data, BLOCK_SIZE);
+
+            chunk->zeroFlags[block] = zero ? 1 : 0;
+            if (zero) {
+                memcpy(chunk->hashes + (size_t)block * HashUtils::SHA1_DIGEST_SIZE, zeroHash,
+                       HashUtils::SHA1_DIGEST_SIZE);
+            } else {
+                blockPtrs[toHash] = data;
+                blockIndex[toHash] = block;
+                toHash++;
+            }
+        }
+
+        uint8_t* firstHash = chunk->hashes + (size_t)firstBlock * HashUtils::SHA1_DIGEST_SIZE;
+        if (toHash == batch) {
+            // Nenhum bloco zerado: digests direto no lugar final
+            HashUtils::calculateSHA1Batch(blockPtrs, batch, BLOCK_SIZE, firstHash);
+        } else if (toHash > 0) {
+            HashUtils::calculateSHA1Batch(blockPtrs, toHash, BLOCK_SIZE, batchHashes);
+            for (uint32_t i = 0; i < toHash; i++) {
+                memcpy(chunk->hashes + (size_t)blockIndex[i] * HashUtils::SHA1_DIGEST_SIZE,
+                       batchHashes + (size_t)i * HashUtils::SHA1_DIGEST_SIZE, HashUtils::SHA1_DIGEST_SIZE);
+            }
+        }
+
+        firstBlock += batch;
+        blockCount -= batch;
+    }
+}
+
+void DataPipeline::readerLoop() {
+    PipelineChunk* chunk;
+
+    if (profiler) {
+        profiler->setThreadName("reader");
+    }
+
+    // Sem buffer livre: o escritor (ou o hashing) está atrás da leitura
+    while (popWithBackpressure(freeQueue, chunk, stopRequested, profiler, ConversionStage::Read)) {
+        if (readChunk(chunk) != ReadResult::Ok) {
+            freeQueue.tryPush(chunk);
+            break;
+        }
+
+        // Dividir o lote em sub-lotes de hashing
+        uint32_t tasks = tasksPerChunk(chunk->blockCount);
+        chunk->pendingTasks.store(tasks, std::memory_order_relaxed);
+
+        bool pushed = true;
+        for (uint32_t i = 0; i < tasks && pushed; i++) {
+            HashTask task;
+            task.chunk = chunk;
+            task.firstBlock = i * HASH_TASK_BLOCKS;
+            task.blockCount = std::min(chunk->blockCount - task.firstBlock, HASH_TASK_BLOCKS + 0);
+            pushed = pushWithBackpressure(hashQueue, task, stopRequested, profiler, ConversionStage::Read);
+        }
+
+        if (!pushed) {
+            break;
+        }
+    }
+
+    totalChunks.store(readSequence, std::memory_order_relaxed);
+    readerDone.store(true, std::memory_order_release);
+}
+
+void DataPipeline::hashLoop(uint32_t workerIndex) {
+    uint32_t spins = 0;
+    uint64_t idleStart = 0;
+    HashTask task;
+
+    if (profiler) {
+        profiler->setThreadName("hash-" + std::to_string(workerIndex));
+    }
+
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        if (!hashQueue.tryPop(task)) {
+            if (!readerDone.load(std::memory_order_acquire)) {
+                // Worker ocioso: a leitura não acompanha o hashing
+                if (profiler && idleStart == 0) {
+                    idleStart = ConversionProfiler::nowNanos();
+                }
+                backoff(spins);
+                continue;
+            }
+            // O leitor publica readerDone depois do último push: se a fila
+            // continua vazia depois disso, não há mais trabalho
+            if (!hashQueue.tryPop(task)) {
+                return;
+            }
+        }
+
+        if (idleStart != 0) {
+            profiler->recordStall(ConversionStage::Hash, idleStart, ConversionProfiler::nowNanos());
+            idleStart = 0;
+        }
+
+        spins = 0;
+        {
+            ProfileScope scope(profiler, ConversionStage::Hash, (uint64_t)task.blockCount * BLOCK_SIZE,
+                               task.blockCount);
+            hashBlocks(task.chunk, task.firstBlock, task.blockCount);
+        }
+
+        // O último sub-lote concluído entrega o lote ao escritor
+        if (task.chunk->pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (!pushWithBackpressure(doneQueue, task.chunk, stopRequested, profiler, ConversionStage::Hash)) {
+                return;
+            }
+        }
+    }
+}
+
+bool DataPipeline::next(PipelineChunk*& chunk) {
+    if (!started || stopRequested.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    if (hashThreads <= 1) {
+        chunk = &chunks[0];
+        if (readChunk(chunk) != ReadResult::Ok) {
+            return false;
+        }
+        ProfileScope scope(profiler, ConversionStage::Hash, (uint64_t)chunk->blockCount * BLOCK_SIZE,
+                           chunk->blockCount);
+        hashBlocks(chunk, 0, chunk->blockCount);
+        return true;
+    }
+
+    uint32_t spins = 0;
+    uint64_t waitStart = 0;
+
+    for (;;) {
+        PipelineChunk*& slot = pending[nextSequence % poolSize];
+        if (slot) {
+            chunk = slot;
+            slot = nullptr;
+            nextSequence++;
+            // Escritor esperou pelo lote: leitura ou hashing atrás da escrita
+            if (waitStart != 0) {
+                profiler->recordStall(ConversionStage::Write, waitStart, ConversionProfiler::nowNanos());
+            }
+            return true;
+        }
+
+        if (readerDone.load(std::memory_order_acquire) &&
+            nextSequence >= totalChunks.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        if (stopRequested.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // Lotes podem terminar fora de ordem; guardar até chegar a vez
+        PipelineChunk* done;
+        if (doneQueue.tryPop(done)) {
+            pending[done->sequence % poolSize] = done;
+            spins = 0;
+            continue;
+        }
+
+        if (profiler && waitStart == 0) {
+            waitStart = ConversionProfiler::nowNanos();
+        }
+        backoff(spins);
+    }
+}
+
+void DataPipeline::release(PipelineChunk* chunk) {
+    // Faixa já escrita: não precisa mais ocupar page cache
+    if (chunk->dataBytes > 0) {
+        source.dontNeed(chunk->offset, chunk->dataBytes);
+    }
+
+    if (hashThreads <= 1) {
+        return;
+    }
+    freeQueue.tryPush(chunk);
+}
@@ -0,0 +1,154 @@
+#ifndef DATA_PIPELINE_H
+#define DATA_PIPELINE_H
+
+#include "bounded_queue.h"
+#include "conversion_profiler.h"
+#include "iso_source.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Lote de blocos do ISO que atravessa o pipeline
+struct PipelineChunk {
+    uint64_t sequence;
+    uint64_t offset;      // offset no ISO
+    uint32_t dataBytes;   // bytes lidos do ISO
+    uint32_t blockCount;  // blocos de 4 KiB (último completado com zeros)
+    const uint8_t* data;  // páginas mapeadas do ISO ou buffer
+    uint8_t* buffer;      // buffer próprio (pread ou bloco final parcial)
+    uint8_t* hashes;      // blockCount digests SHA-1
+    uint8_t* zeroFlags;   // 1 por bloco todo zerado (hash pré-calculado)
+
+    // Sub-lotes de hashing ainda não concluídos
+    std::atomic<uint32_t> pendingTasks;
+};
+
+// Estatísticas de leitura do ISO
+struct PipelineReadStats {
+    uint64_t bytesRead;
+    uint64_t readCalls;
+    uint64_t readNanos;   // tempo acumulado em IsoSource::view
+    uint64_t wallNanos;   // do start() ao último lote lido
+};
+
+// Leitura + hashing dos blocos do ISO para convertData:
+//
+//   leitor (1 thread) → pool de hashing (N threads) → next() em ordem
+//
+// O leitor pega lotes grandes (chunkSize) do IsoSource com dicas de
+// readahead (SEQUENTIAL/WILLNEED) e libera do page cache as faixas já
+// escritas (DONTNEED), para um ISO de 8 GB não expulsar todo o resto.
+// Com o ISO mapeado os workers fazem o hash direto das páginas mapeadas,
+// sem cópia; os buffers próprios só existem no fallback com pread.
+// Cada lote é dividido em sub-lotes de hashing, então lotes grandes não
+// deixam workers ociosos. Blocos todos zerados (padding, comum nos ISOs)
+// não passam pelo SHA-1: recebem o hash pré-calculado e ficam marcados em
+// zeroFlags para o escritor deixar um buraco no lugar.
+//
+// As etapas são ligadas por filas lock-free limitadas e o número fixo de
+// buffers faz a backpressure: o leitor espera quando todos estão em uso.
+// A escrita fica com quem chama next(), normalmente a thread JNI, para o
+// callback de progresso continuar na mesma thread. Com hashThreads <= 1
+// não há threads auxiliares: next() lê e calcula os hashes diretamente.
+//
+// Com um ConversionProfiler as leituras (Read), os sub-lotes de hashing
+// (Hash) e as esperas nas filas ficam registrados por etapa.
+class DataPipeline {
+public:
+    static const uint32_t BLOCK_SIZE = 4096;
+    static const uint32_t HASH_TASK_BLOCKS = 256;                   // 1 MiB por sub-lote
+    static const uint32_t MIN_CHUNK_SIZE = 1024 * 1024;
+    static const uint32_t MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+    static const uint32_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+    static const uint32_t BUFFER_MEMORY_BUDGET = 64 * 1024 * 1024; // soma dos buffers de lote
+    static const uint32_t MAX_HASH_THREADS = 8;
+
+    // Lê a faixa [startOffset, endOffset) do ISO
+    DataPipeline(
+        IsoSource& source,
+        uint64_t startOffset,
+        uint64_t endOffset,
+        uint32_t hashThreads,
+        uint32_t chunkSize = DEFAULT_CHUNK_SIZE,
+        ConversionProfiler* profiler = nullptr
+    );
+    ~DataPipeline();
+
+    bool start();
+
+    // Próximo lote em ordem de offset; false no fim dos dados, após stop()
+    // ou depois de uma leitura que falhou (hasFailed)
+    bool next(PipelineChunk*& chunk);
+
+    // Uma leitura do ISO falhou: os lotes entregues param antes do fim
+    bool hasFailed() const { return readFailed.load(std::memory_order_acquire); }
+
+    // Devolve o lote ao pool depois de escrito
+    void release(PipelineChunk* chunk);
+
+    void stop();
+
+    uint32_t getHashThreadCount() const { return hashThreads; }
+    uint32_t getChunkSize() const { return chunkBlocks * BLOCK_SIZE; }
+
+    // Válido depois de stop()
+    PipelineReadStats getReadStats() const { return readStats; }
+
+private:
+    enum class ReadResult {
+        Ok,
+        EndOfData,
+        Error
+    };
+
+    struct HashTask {
+        PipelineChunk* chunk;
+        uint32_t firstBlock;
+        uint32_t blockCount;
+    };
+
+    IsoSource& source;
+    ConversionProfiler* profiler;
+    uint64_t endOffset;
+    uint32_t hashThreads;
+    uint32_t chunkBlocks;
+    uint32_t poolSize;
+
+    uint64_t readOffset;
+    uint64_t readSequence;
+    uint64_t startNanos;
+    PipelineReadStats readStats;
+
+    std::vector<uint8_t> dataPool;
+    std::vector<uint8_t> hashPool;
+    std::vector<uint8_t> zeroFlagPool;
+    std::vector<uint8_t> tailBuffer;  // bloco final parcial com o ISO mapeado
+    std::unique_ptr<PipelineChunk[]> chunks;
+
+    BoundedQueue<PipelineChunk*> freeQueue;
+    BoundedQueue<HashTask> hashQueue;
+    BoundedQueue<PipelineChunk*> doneQueue;
+
+    // Lotes já hasheados esperando a vez (índice: sequence % poolSize)
+    std::vector<PipelineChunk*> pending;
+    uint64_t nextSequence;
+
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> readerDone;
+    std::atomic<bool> readFailed;
+    std::atomic<uint64_t> totalChunks;
+
+    std::thread readerThread;
+    std::vector<std::thread> hashWorkers;
+    bool started;
+
+    ReadResult readChunk(PipelineChunk* chunk);
+    static void hashBlocks(PipelineChunk* chunk, uint32_t firstBlock, uint32_t blockCount);
+
+    void readerLoop();
+    void hashLoop(uint32_t workerIndex);
+};
+
+#endif // DATA_PIPELINE_H
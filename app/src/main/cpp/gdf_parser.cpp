@@ -1,11 +1,15 @@
 #include "gdf_parser.h"
-#include <android/log.h>
-#include <fstream>
+#include "iso_source.h"
+#include "native_log.h"
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <strings.h>
+#include <unordered_set>
 
 #define LOG_TAG "GDFParser"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 // Tipos de ISO Xbox 360
 enum class IsoType : uint32_t {
@@ -26,7 +30,8 @@ struct GDFVolumeDescriptor {
     uint32_t volumeSectors;
 };
 
-GDFParser::GDFParser() {
+GDFParser::GDFParser()
+    : rootFirstChild(0), rootChildCount(0), rootOffset(0), sectorSize(2048), usedEnd(0), complete(true) {
     LOGD("GDFParser initialized");
 }
 
@@ -34,220 +39,504 @@ GDFParser::~GDFParser() {
     LOGD("GDFParser destroyed");
 }
 
-// Lê uint16 little-endian
-static uint16_t readUInt16LE(std::ifstream& file) {
-    uint8_t bytes[2];
-    file.read((char*)bytes, 2);
-    return (uint16_t)bytes[0] | ((uint16_t)bytes[1] << 8);
+// Lê uint32 little-endian
+static uint32_t readUInt32LE(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | 
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
 }
 
-// Lê uint32 little-endian
-static uint32_t readUInt32LE(std::ifstream& file) {
-    uint8_t bytes[4];
-    file.read((char*)bytes, 4);
-    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | 
-           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+static const char GDF_MAGIC[] = "MICROSOFT*XBOX*MEDIA";
+static const size_t GDF_MAGIC_SIZE = 20;
+
+// Verifica o magic do volume descriptor para um rootOffset candidato
+static bool hasGdfMagic(IsoSource& source, uint32_t rootOffset, uint8_t* scratch) {
+    const uint8_t* magic = source.view(32 * 2048 + (uint64_t)rootOffset, GDF_MAGIC_SIZE, scratch);
+    return magic && memcmp(magic, GDF_MAGIC, GDF_MAGIC_SIZE) == 0;
 }
 
 bool GDFParser::parse(const std::string& isoPath) {
-    std::ifstream iso(isoPath, std::ios::binary);
-    if (!iso.is_open()) {
+    std::unique_ptr<IsoSource> source = IsoSource::open(isoPath);
+    if (!source) {
         LOGE("Failed to open ISO: %s", isoPath.c_str());
         return false;
     }
+    return parse(*source);
+}
+
+void GDFParser::markUsed(uint32_t sector, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+    
+    uint64_t sectors = ((uint64_t)size + sectorSize - 1) / sectorSize;
+    uint64_t end = rootOffset + ((uint64_t)sector + sectors) * sectorSize;
+    if (end > usedEnd) {
+        usedEnd = end;
+    }
+}
+
+bool GDFParser::parse(IsoSource& source) {
+    LOGD("Parsing GDF from: %s", source.getPath().c_str());
     
-    LOGD("Parsing GDF from: %s", isoPath.c_str());
+    entries.clear();
+    names.clear();
+    pathIndex.clear();
+    rootFirstChild = 0;
+    rootChildCount = 0;
+    usedEnd = 0;
+    complete = true;
     
     // Detectar tipo de ISO (Xsf, XGD1, XGD2, XGD3)
     GDFVolumeDescriptor volDesc;
     volDesc.sectorSize = 2048;
     
     IsoType isoType = IsoType::XGD2;
-    char magic[21] = {0};
+    uint8_t scratch[36];
     
-    // Tentar Xsf (offset 0)
-    iso.seekg(32 * volDesc.sectorSize);
-    iso.read(magic, 20);
-    
-    if (strcmp(magic, "MICROSOFT*XBOX*MEDIA") == 0) {
+    if (hasGdfMagic(source, (uint32_t)IsoType::Xsf, scratch)) {
         isoType = IsoType::Xsf;
-        volDesc.rootOffset = (uint32_t)isoType;
         LOGD("Detected ISO type: Xsf");
+    } else if (hasGdfMagic(source, (uint32_t)IsoType::XGD1, scratch)) {
+        isoType = IsoType::XGD1;
+        LOGD("Detected ISO type: XGD1");
+    } else if (hasGdfMagic(source, (uint32_t)IsoType::XGD2, scratch)) {
+        isoType = IsoType::XGD2;
+        LOGD("Detected ISO type: XGD2");
     } else {
-        // Tentar XGD1
-        iso.seekg(32 * volDesc.sectorSize + (uint32_t)IsoType::XGD1);
-        iso.read(magic, 20);
-        
-        if (strcmp(magic, "MICROSOFT*XBOX*MEDIA") == 0) {
-            isoType = IsoType::XGD1;
-            volDesc.rootOffset = (uint32_t)isoType;
-            LOGD("Detected ISO type: XGD1");
-        } else {
-            // Tentar XGD2
-            iso.seekg(32 * volDesc.sectorSize + (uint32_t)IsoType::XGD2);
-            iso.read(magic, 20);
-            
-            if (strcmp(magic, "MICROSOFT*XBOX*MEDIA") == 0) {
-                isoType = IsoType::XGD2;
-                volDesc.rootOffset = (uint32_t)isoType;
-                LOGD("Detected ISO type: XGD2");
-            } else {
-                // Assumir XGD3
-                isoType = IsoType::XGD3;
-                volDesc.rootOffset = (uint32_t)isoType;
-                LOGD("Detected ISO type: XGD3");
-            }
-        }
+        // Assumir XGD3
+        isoType = IsoType::XGD3;
+        LOGD("Detected ISO type: XGD3");
     }
+    volDesc.rootOffset = (uint32_t)isoType;
+    rootOffset = volDesc.rootOffset;
+    sectorSize = volDesc.sectorSize;
     
     // Ler volume descriptor
-    iso.seekg(32 * volDesc.sectorSize + volDesc.rootOffset);
-    iso.read((char*)volDesc.identifier, 20);
-    volDesc.rootDirSector = readUInt32LE(iso);
-    volDesc.rootDirSize = readUInt32LE(iso);
-    iso.read((char*)volDesc.imageCreationTime, 8);
+    const uint8_t* desc = source.view(32 * volDesc.sectorSize + (uint64_t)volDesc.rootOffset, 36, scratch);
+    if (!desc) {
+        LOGE("Failed to read volume descriptor");
+        return false;
+    }
+    
+    memcpy(volDesc.identifier, desc, 20);
+    volDesc.rootDirSector = readUInt32LE(desc + 20);
+    volDesc.rootDirSize = readUInt32LE(desc + 24);
+    memcpy(volDesc.imageCreationTime, desc + 28, 8);
     
     LOGD("Root Directory: Sector=%u, Size=%u", volDesc.rootDirSector, volDesc.rootDirSize);
     
-    // Parsear root directory
-    if (!parseDirectory(iso, volDesc, volDesc.rootDirSector, volDesc.rootDirSize)) {
+    markUsed(32, 36);
+    markUsed(volDesc.rootDirSector, volDesc.rootDirSize);
+    
+    // Parsear a árvore a partir do root directory
+    if (!readDirectories(source, volDesc.rootDirSector, volDesc.rootDirSize)) {
         LOGE("Failed to parse root directory");
-        iso.close();
         return false;
     }
     
-    iso.close();
+    buildPathIndex();
     
-    LOGD("GDF parsing completed - Found %zu entries", entries.size());
+    LOGD("GDF parsing completed - Found %zu entries, game partition 0x%X-0x%llX%s",
+         entries.size(), rootOffset, (unsigned long long)usedEnd, complete ? "" : " (incomplete)");
     return true;
 }
 
-bool GDFParser::parseDirectory(
-    std::ifstream& iso,
-    const GDFVolumeDescriptor& volDesc,
-    uint32_t sector,
-    uint32_t size
-) {
-    // Limitar tamanho do diretório para evitar alocação excessiva
-    const uint32_t MAX_DIR_SIZE = 10 * 1024 * 1024; // 10MB
-    if (size > MAX_DIR_SIZE) {
-        LOGE("Directory size too large: %u bytes", size);
-        return false;
+// FNV-1a de 32 bits; nomes em minúsculas (ASCII) porque o GDF não
+// diferencia maiúsculas
+static const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+static const uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+static inline uint32_t fnvStep(uint32_t hash, char c) {
+    return (hash ^ (uint8_t)c) * FNV_PRIME;
+}
+
+static inline uint32_t fnvLower(uint32_t hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        char c = data[i];
+        hash = fnvStep(hash, (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c);
     }
-    
-    // Limitar número de entries para evitar loop infinito
-    const size_t MAX_TOTAL_ENTRIES = 10000;
-    if (entries.size() >= MAX_TOTAL_ENTRIES) {
-        LOGE("Too many entries parsed: %zu", entries.size());
-        return false;
+    return hash;
+}
+
+static inline bool isPathSeparator(char c) {
+    return c == '/' || c == '\\';
+}
+
+// Limites das leituras agrupadas
+static const uint32_t MAX_DIR_SIZE = 10 * 1024 * 1024;      // sanidade por diretório
+static const uint32_t MAX_BATCH_BYTES = 1024 * 1024;        // por leitura
+static const uint32_t MAX_GAP_SECTORS = 8;                  // lacuna lida junto (16 KiB)
+
+bool GDFParser::readDirectories(IsoSource& source, uint32_t rootSector, uint32_t rootSize) {
+    if (rootSize == 0) {
+        return true;
     }
-    
-    // Ir para o setor do diretório
-    uint64_t offset = (uint64_t)sector * volDesc.sectorSize + volDesc.rootOffset;
-    iso.seekg(offset);
-    
-    if (iso.fail()) {
-        LOGE("Failed to seek to directory at offset %llu", offset);
+    if (rootSize > MAX_DIR_SIZE) {
+        LOGE("Root directory size too large: %u bytes", rootSize);
+        complete = false;
         return false;
     }
     
-    // Ler todos os dados do diretório
-    uint8_t* dirData = new uint8_t[size];
-    iso.read((char*)dirData, size);
+    // Min-heap por setor
+    std::vector<DirectoryExtent> pending;
+    pending.push_back({rootSector, rootSize, GDFEntry::NO_PARENT});
     
-    if (iso.gcount() != size) {
-        LOGE("Failed to read complete directory data");
-        delete[] dirData;
-        return false;
-    }
+    std::unordered_set<uint32_t> visited;
+    std::vector<DirectoryExtent> batch;
+    std::vector<uint8_t> batchBuffer;
+    bool rootRead = false;
     
-    uint32_t position = 0;
-    uint32_t entriesInThisDir = 0;
-    const uint32_t MAX_ENTRIES_PER_DIR = 1000;
+    auto popPending = [&pending]() {
+        std::pop_heap(pending.begin(), pending.end(), std::greater<DirectoryExtent>());
+        DirectoryExtent extent = pending.back();
+        pending.pop_back();
+        return extent;
+    };
     
-    // Parsear entries até o fim dos dados
-    while (position < size && entriesInThisDir < MAX_ENTRIES_PER_DIR) {
-        // Ler GDFDirEntry
-        if (position + 14 > size) break;
+    while (!pending.empty()) {
+        DirectoryExtent first = popPending();
+        if (!visited.insert(first.sector).second) {
+            continue;
+        }
         
-        uint16_t subTreeL = (uint16_t)dirData[position] | ((uint16_t)dirData[position + 1] << 8);
-        uint16_t subTreeR = (uint16_t)dirData[position + 2] | ((uint16_t)dirData[position + 3] << 8);
-        position += 4;
+        // Extensões seguintes encostadas (ou com lacuna pequena) na mesma leitura
+        batch.assign(1, first);
+        uint64_t batchStart = (uint64_t)first.sector * sectorSize;
+        uint64_t batchEnd = batchStart + first.size;
         
-        // 0xFFFF indica fim da lista
-        if (subTreeL == 0xFFFF && subTreeR == 0xFFFF) {
-            break;
+        while (!pending.empty()) {
+            const DirectoryExtent& next = pending.front();
+            uint64_t nextStart = (uint64_t)next.sector * sectorSize;
+            uint64_t alignedEnd = (batchEnd + sectorSize - 1) / sectorSize * sectorSize;
+            
+            if (visited.count(next.sector)) {
+                popPending();
+                continue;
+            }
+            if (next.size > MAX_DIR_SIZE) {
+                LOGE("Directory size too large: %u bytes", next.size);
+                complete = false;
+                visited.insert(next.sector);
+                popPending();
+                continue;
+            }
+            if (nextStart > alignedEnd + (uint64_t)MAX_GAP_SECTORS * sectorSize ||
+                std::max(batchEnd, nextStart + next.size) - batchStart > MAX_BATCH_BYTES) {
+                break;
+            }
+            
+            DirectoryExtent extent = popPending();
+            visited.insert(extent.sector);
+            batch.push_back(extent);
+            batchEnd = std::max(batchEnd, nextStart + extent.size);
         }
         
-        uint32_t entrySector = (uint32_t)dirData[position] | 
-                               ((uint32_t)dirData[position + 1] << 8) |
-                               ((uint32_t)dirData[position + 2] << 16) |
-                               ((uint32_t)dirData[position + 3] << 24);
-        position += 4;
+        const uint8_t* batchData = source.view(rootOffset + batchStart, (size_t)(batchEnd - batchStart), batchBuffer);
+        if (!batchData) {
+            LOGE("Failed to read directory data at offset %llu (%u directories)",
+                 (unsigned long long)(rootOffset + batchStart), (uint32_t)batch.size());
+            complete = false;
+            if (first.sector == rootSector) {
+                return false;
+            }
+            continue;
+        }
         
-        uint32_t entrySize = (uint32_t)dirData[position] | 
-                            ((uint32_t)dirData[position + 1] << 8) |
-                            ((uint32_t)dirData[position + 2] << 16) |
-                            ((uint32_t)dirData[position + 3] << 24);
-        position += 4;
+        // Os subdiretórios encontrados entram no heap para as próximas leituras
+        for (const DirectoryExtent& extent : batch) {
+            uint64_t offset = (uint64_t)extent.sector * sectorSize - batchStart;
+            parseDirectory(batchData + offset, extent.size, extent.entryIndex, pending);
+            rootRead = rootRead || extent.sector == rootSector;
+        }
+    }
+    
+    return rootRead;
+}
+
+void GDFParser::parseDirectory(
+    const uint8_t* dirData,
+    uint32_t size,
+    uint32_t directoryIndex,
+    std::vector<DirectoryExtent>& pending
+) {
+    uint32_t position = 0;
+    uint32_t firstChild = (uint32_t)entries.size();
+    
+    // Hash do caminho do pai, continuado com "/nome" por cada filho
+    uint32_t parentHash = FNV_OFFSET_BASIS;
+    if (directoryIndex != GDFEntry::NO_PARENT) {
+        parentHash = fnvStep(entries[directoryIndex].pathHash, '/');
+    }
+    
+    // Entries não cruzam setores: o resto de cada setor é preenchido com
+    // 0xFF, então L/R = 0xFFFF manda para o próximo setor (diretórios com
+    // mais de um setor continuam lá)
+    while (position + 14 <= size) {
+        uint32_t sectorEnd = (position / sectorSize + 1) * sectorSize;
+        const uint8_t* entryData = dirData + position;
         
-        uint8_t attributes = dirData[position++];
-        uint8_t nameLength = dirData[position++];
+        uint16_t subTreeL = (uint16_t)entryData[0] | ((uint16_t)entryData[1] << 8);
+        uint16_t subTreeR = (uint16_t)entryData[2] | ((uint16_t)entryData[3] << 8);
         
-        // Validar tamanho do nome
-        if (nameLength > 255 || position + nameLength > size) {
-            LOGE("Invalid name length: %u at position %u", nameLength, position);
-            break;
+        if (subTreeL == 0xFFFF && subTreeR == 0xFFFF) {
+            position = sectorEnd;
+            continue;
         }
         
-        // Ler nome
-        char name[256] = {0};
-        memcpy(name, &dirData[position], nameLength);
-        position += nameLength;
+        uint32_t entrySector = readUInt32LE(entryData + 4);
+        uint32_t entrySize = readUInt32LE(entryData + 8);
+        uint8_t attributes = entryData[12];
+        uint8_t nameLength = entryData[13];
+        uint32_t entryBytes = 14 + nameLength;
         
-        // Padding para alinhar a 4 bytes
-        uint32_t padding = (4 - ((14 + nameLength) % 4)) % 4;
-        position += padding;
+        // Entry inválida: descarta o resto do setor
+        if (nameLength == 0 || position + entryBytes > size || position + entryBytes > sectorEnd) {
+            LOGE("Invalid directory entry at position %u (name length %u)", position, nameLength);
+            complete = false;
+            position = sectorEnd;
+            continue;
+        }
         
-        // Adicionar entry
         GDFEntry entry;
-        entry.name = std::string(name, nameLength);
+        entry.nameOffset = (uint32_t)names.size();
         entry.sector = entrySector;
         entry.size = entrySize;
+        entry.parent = directoryIndex;
+        entry.firstChild = 0;
+        entry.childCount = 0;
+        entry.pathHash = fnvLower(parentHash, (const char*)entryData + 14, nameLength);
+        entry.nameLength = nameLength;
         entry.isDirectory = (attributes & 0x10) != 0;
         
+        names.insert(names.end(), entryData + 14, entryData + 14 + nameLength);
+        names.push_back('\0');
         entries.push_back(entry);
-        entriesInThisDir++;
-        
-        LOGD("Entry: %s (Sector=%u, Size=%u, Dir=%d)",
-             entry.name.c_str(), entry.sector, entry.size, entry.isDirectory);
+        markUsed(entrySector, entrySize);
         
-        // Se for diretório, parsear recursivamente (com limite de tamanho)
-        if (entry.isDirectory && entrySize > 0 && entrySize < MAX_DIR_SIZE) {
-            if (!parseDirectory(iso, volDesc, entrySector, entrySize)) {
-                LOGE("Failed to parse subdirectory: %s", entry.name.c_str());
-                // Continuar mesmo se falhar um subdiretório
-            }
+        if (entry.isDirectory && entrySize > 0) {
+            pending.push_back({entrySector, entrySize, (uint32_t)entries.size() - 1});
+            std::push_heap(pending.begin(), pending.end(), std::greater<DirectoryExtent>());
         }
+        
+        // Próxima entry alinhada a 4 bytes
+        position += (entryBytes + 3) & ~3u;
     }
     
-    if (entriesInThisDir >= MAX_ENTRIES_PER_DIR) {
-        LOGE("Warning: Directory has too many entries, some may be skipped");
+    uint32_t childCount = (uint32_t)entries.size() - firstChild;
+    if (directoryIndex == GDFEntry::NO_PARENT) {
+        rootFirstChild = firstChild;
+        rootChildCount = childCount;
+    } else {
+        entries[directoryIndex].firstChild = firstChild;
+        entries[directoryIndex].childCount = childCount;
     }
+}
+
+void GDFParser::buildPathIndex() {
+    // Potência de 2 com no máximo 50% de ocupação
+    size_t capacity = 16;
+    while (capacity < entries.size() * 2) {
+        capacity *= 2;
+    }
+    pathIndex.assign(capacity, EMPTY_SLOT);
     
-    delete[] dirData;
-    return true;
+    const size_t mask = capacity - 1;
+    for (uint32_t i = 0; i < (uint32_t)entries.size(); i++) {
+        size_t slot = entries[i].pathHash & mask;
+        while (pathIndex[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) & mask;
+        }
+        pathIndex[slot] = i;
+    }
 }
 
-std::vector<GDFEntry> GDFParser::getEntries() const {
-    return entries;
+// Compara o caminho com a cadeia de pais da entry, do último componente
+// para o primeiro
+bool GDFParser::matchesPath(uint32_t index, std::string_view path) const {
+    size_t end = path.size();
+    
+    for (;;) {
+        while (end > 0 && isPathSeparator(path[end - 1])) {
+            end--;
+        }
+        size_t start = end;
+        while (start > 0 && !isPathSeparator(path[start - 1])) {
+            start--;
+        }
+        
+        if (index == GDFEntry::NO_PARENT) {
+            return start == end;
+        }
+        
+        const GDFEntry& entry = entries[index];
+        if (end - start != entry.nameLength ||
+            strncasecmp(path.data() + start, getName(entry), entry.nameLength) != 0) {
+            return false;
+        }
+        
+        index = entry.parent;
+        end = start;
+    }
 }
 
-GDFEntry* GDFParser::findFile(const std::string& fileName) const {
-    for (const auto& entry : entries) {
-        if (entry.name == fileName && !entry.isDirectory) {
-            return new GDFEntry(entry);
+const GDFEntry* GDFParser::findEntry(std::string_view path) const {
+    if (pathIndex.empty()) {
+        return nullptr;
+    }
+    
+    // Mesmo hash de parseDirectory: componentes separados por um '/' só
+    uint32_t hash = FNV_OFFSET_BASIS;
+    bool first = true;
+    size_t position = 0;
+    while (position < path.size()) {
+        while (position < path.size() && isPathSeparator(path[position])) {
+            position++;
+        }
+        size_t start = position;
+        while (position < path.size() && !isPathSeparator(path[position])) {
+            position++;
+        }
+        if (position > start) {
+            if (!first) {
+                hash = fnvStep(hash, '/');
+            }
+            hash = fnvLower(hash, path.data() + start, position - start);
+            first = false;
+        }
+    }
+    if (first) {
+        return nullptr;
+    }
+    
+    const size_t mask = pathIndex.size() - 1;
+    for (size_t slot = hash & mask; pathIndex[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        uint32_t index = pathIndex[slot];
+        if (entries[index].pathHash == hash && matchesPath(index, path)) {
+            return &entries[index];
         }
     }
     return nullptr;
 }
+
+std::optional<GDFEntry> GDFParser::findFile(std::string_view path) const {
+    const GDFEntry* entry = findEntry(path);
+    if (!entry || entry->isDirectory) {
+        return std::nullopt;
+    }
+    return *entry;
+}
+
+std::string GDFParser::getPath(const GDFEntry& entry) const {
+    std::string path(getName(entry), entry.nameLength);
+    for (uint32_t parent = entry.parent; parent != GDFEntry::NO_PARENT; parent = entries[parent].parent) {
+        const GDFEntry& directory = entries[parent];
+        path.insert(0, 1, '/');
+        path.insert(0, getName(directory), directory.nameLength);
+    }
+    return path;
+}
+
+GDFDirectoryRange GDFParser::listDirectory() const {
+    const GDFEntry* base = entries.data();
+    return GDFDirectoryRange(base + rootFirstChild, base + rootFirstChild + rootChildCount);
+}
+
+GDFDirectoryRange GDFParser::listDirectory(const GDFEntry& directory) const {
+    if (!directory.isDirectory) {
+        return GDFDirectoryRange();
+    }
+    const GDFEntry* base = entries.data();
+    return GDFDirectoryRange(base + directory.firstChild, base + directory.firstChild + directory.childCount);
+}
+
+// Cabeçalho do índice salvo: tamanho de GDFEntry, contagens, raiz e limites
+static const size_t INDEX_HEADER_SIZE = 4 * 7 + 8 + 1;
+
+template <typename T>
+static void appendValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T readValue(const uint8_t*& in) {
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+void GDFParser::saveIndex(std::vector<uint8_t>& out) const {
+    out.clear();
+    out.reserve(INDEX_HEADER_SIZE + entries.size() * sizeof(GDFEntry) + names.size());
+    
+    appendValue(out, (uint32_t)sizeof(GDFEntry));
+    appendValue(out, (uint32_t)entries.size());
+    appendValue(out, (uint32_t)names.size());
+    appendValue(out, rootFirstChild);
+    appendValue(out, rootChildCount);
+    appendValue(out, rootOffset);
+    appendValue(out, sectorSize);
+    appendValue(out, usedEnd);
+    appendValue(out, (uint8_t)(complete ? 1 : 0));
+    
+    const uint8_t* entryBytes = reinterpret_cast<const uint8_t*>(entries.data());
+    out.insert(out.end(), entryBytes, entryBytes + entries.size() * sizeof(GDFEntry));
+    out.insert(out.end(), names.begin(), names.end());
+}
+
+bool GDFParser::loadIndex(const uint8_t* data, size_t size) {
+    if (size < INDEX_HEADER_SIZE) {
+        return false;
+    }
+    
+    const uint8_t* in = data;
+    uint32_t entrySize = readValue<uint32_t>(in);
+    uint32_t entryCount = readValue<uint32_t>(in);
+    uint32_t namesSize = readValue<uint32_t>(in);
+    uint32_t savedRootFirstChild = readValue<uint32_t>(in);
+    uint32_t savedRootChildCount = readValue<uint32_t>(in);
+    uint32_t savedRootOffset = readValue<uint32_t>(in);
+    uint32_t savedSectorSize = readValue<uint32_t>(in);
+    uint64_t savedUsedEnd = readValue<uint64_t>(in);
+    uint8_t savedComplete = readValue<uint8_t>(in);
+    
+    if (entrySize != sizeof(GDFEntry) ||
+        size != INDEX_HEADER_SIZE + (uint64_t)entryCount * sizeof(GDFEntry) + namesSize ||
+        (uint64_t)savedRootFirstChild + savedRootChildCount > entryCount || savedSectorSize == 0) {
+        LOGE("Saved GDF index does not match this build or is truncated");
+        return false;
+    }
+    
+    std::vector<GDFEntry> loadedEntries(entryCount);
+    memcpy(loadedEntries.data(), in, (size_t)entryCount * sizeof(GDFEntry));
+    in += (size_t)entryCount * sizeof(GDFEntry);
+    
+    // Nomes dentro do arena e terminados em '\0'; pais sempre antes dos
+    // filhos (é a ordem de leitura), o que também impede ciclos
+    for (uint32_t i = 0; i < entryCount; i++) {
+        const GDFEntry& entry = loadedEntries[i];
+        if ((uint64_t)entry.nameOffset + entry.nameLength >= namesSize ||
+            in[entry.nameOffset + entry.nameLength] != '\0' ||
+            (entry.parent != GDFEntry::NO_PARENT && entry.parent >= i) ||
+            (uint64_t)entry.firstChild + entry.childCount > entryCount) {
+            LOGE("Saved GDF index has an invalid entry (%u)", i);
+            return false;
+        }
+    }
+    
+    entries.swap(loadedEntries);
+    names.assign(in, in + namesSize);
+    rootFirstChild = savedRootFirstChild;
+    rootChildCount = savedRootChildCount;
+    rootOffset = savedRootOffset;
+    sectorSize = savedSectorSize;
+    usedEnd = savedUsedEnd;
+    complete = savedComplete != 0;
+    
+    buildPathIndex();
+    
+    LOGD("GDF index loaded - %zu entries", entries.size());
+    return true;
+}
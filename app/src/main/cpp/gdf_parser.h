@@ -2,37 +2,135 @@
 #define GDF_PARSER_H
 
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
 
-struct GDFVolumeDescriptor;
+class IsoSource;
 
+// Entry compacta (POD): o nome fica no arena do parser, terminado em '\0'
 struct GDFEntry {
-    std::string name;
+    static const uint32_t NO_PARENT = 0xFFFFFFFF;   // filho da raiz
+    
+    uint32_t nameOffset;   // em GDFParser::getName()
     uint32_t sector;
     uint32_t size;
+    uint32_t parent;       // índice do diretório pai em getEntries()
+    uint32_t firstChild;   // diretórios: filhos em [firstChild, firstChild + childCount)
+    uint32_t childCount;
+    uint32_t pathHash;     // FNV-1a do caminho completo em minúsculas
+    uint8_t nameLength;
     bool isDirectory;
 };
 
+// Conteúdo de um diretório: as entries de um diretório são contíguas
+class GDFDirectoryRange {
+public:
+    GDFDirectoryRange() : first(nullptr), last(nullptr) {}
+    GDFDirectoryRange(const GDFEntry* first, const GDFEntry* last) : first(first), last(last) {}
+    
+    const GDFEntry* begin() const { return first; }
+    const GDFEntry* end() const { return last; }
+    size_t size() const { return (size_t)(last - first); }
+    bool empty() const { return first == last; }
+    
+private:
+    const GDFEntry* first;
+    const GDFEntry* last;
+};
+
+// Leitura da árvore de diretórios GDF de um ISO do Xbox 360.
+//
+// Em vez de descer recursivamente com um seek por diretório, o parser
+// mantém as extensões de diretório pendentes num heap por setor e lê
+// sempre a de menor setor, juntando na mesma leitura as extensões
+// seguintes que estão encostadas (ou quase: lacunas pequenas são lidas
+// junto, sai mais barato que outro seek em HDD/SD). Cada diretório é lido
+// uma vez só, o que também protege contra ciclos em imagens corrompidas,
+// e não há limite de entries.
+//
+// As entries ficam na ordem de leitura (primeiro as da raiz) e as de cada
+// diretório ficam juntas. Cada entry aponta para o pai, e um índice hash
+// pelo caminho completo (sem diferenciar maiúsculas, como o GDF) resolve
+// findEntry() sem percorrer a lista nem alocar memória.
 class GDFParser {
 public:
     GDFParser();
     ~GDFParser();
     
+    bool parse(IsoSource& source);
     bool parse(const std::string& isoPath);
-    std::vector<GDFEntry> getEntries() const;
-    GDFEntry* findFile(const std::string& fileName) const;
+    const std::vector<GDFEntry>& getEntries() const { return entries; }
+    const char* getName(const GDFEntry& entry) const { return names.data() + entry.nameOffset; }
+    
+    // Caminho completo com '/' ("media/video.wmv")
+    std::string getPath(const GDFEntry& entry) const;
+    
+    // Busca pelo caminho completo, com '/' ou '\\' e sem diferenciar
+    // maiúsculas; nullptr se não existir. O ponteiro vale até o próximo parse.
+    const GDFEntry* findEntry(std::string_view path) const;
+    
+    // Só arquivos (não diretórios), por valor
+    std::optional<GDFEntry> findFile(std::string_view path) const;
+    
+    // Conteúdo da raiz ou de um diretório; vazio para arquivos
+    GDFDirectoryRange listDirectory() const;
+    GDFDirectoryRange listDirectory(const GDFEntry& directory) const;
+    
+    // Início da partição do jogo no ISO (0xFDA000 no XGD2, 0x2080000 no XGD3)
+    uint32_t getRootOffset() const { return rootOffset; }
+    uint32_t getSectorSize() const { return sectorSize; }
+    
+    // Offset (absoluto no ISO) logo depois do último setor usado por
+    // alguma entry, diretório ou pelo volume descriptor
+    uint64_t getGamePartitionEnd() const { return usedEnd; }
+    
+    // false se alguma parte da árvore não foi lida (limites, dados
+    // inválidos): nesse caso getGamePartitionEnd() não é confiável
+    bool isComplete() const { return complete; }
+    
+    // Árvore já lida (entries, nomes e limites) num bloco binário, para o
+    // cache de metadados: loadIndex() recupera o estado de um parse() sem
+    // tocar no ISO. O formato é o layout em memória, então só vale para o
+    // mesmo build; loadIndex() recusa blocos inconsistentes.
+    void saveIndex(std::vector<uint8_t>& out) const;
+    bool loadIndex(const uint8_t* data, size_t size);
     
 private:
+    // Diretório ainda não lido
+    struct DirectoryExtent {
+        uint32_t sector;
+        uint32_t size;
+        uint32_t entryIndex;   // GDFEntry::NO_PARENT para a raiz
+        
+        bool operator>(const DirectoryExtent& other) const { return sector > other.sector; }
+    };
+    
     std::vector<GDFEntry> entries;
+    std::vector<char> names;   // arena dos nomes
+    std::vector<uint32_t> pathIndex;   // hash aberto (sondagem linear) de índices de entries
+    uint32_t rootFirstChild;
+    uint32_t rootChildCount;
+    uint32_t rootOffset;
+    uint32_t sectorSize;
+    uint64_t usedEnd;
+    bool complete;
+    
+    void markUsed(uint32_t sector, uint32_t size);
     
-    bool parseDirectory(
-        std::ifstream& iso,
-        const GDFVolumeDescriptor& volDesc,
-        uint32_t sector,
-        uint32_t size
+    bool readDirectories(IsoSource& source, uint32_t rootSector, uint32_t rootSize);
+    
+    // Entries de um diretório já lido; subdiretórios vão para pending
+    void parseDirectory(
+        const uint8_t* dirData,
+        uint32_t size,
+        uint32_t directoryIndex,
+        std::vector<DirectoryExtent>& pending
     );
+    
+    void buildPathIndex();
+    bool matchesPath(uint32_t index, std::string_view path) const;
 };
 
 #endif // GDF_PARSER_H
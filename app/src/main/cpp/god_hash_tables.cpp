@@ -1,14 +1,16 @@
 #include "god_hash_tables.h"
 #include "hash_utils.h"
-#include <android/log.h>
-#include <fstream>
+#include "native_log.h"
+#include <cerrno>
 #include <cstring>
+#include <unistd.h>
 
 #define LOG_TAG "GodHashTables"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-GodHashTables::GodHashTables() : blocksInCurrentSub(0) {
+GodHashTables::GodHashTables() {
+    reset();
     LOGD("GodHashTables initialized");
 }
 
@@ -16,102 +18,91 @@ GodHashTables::~GodHashTables() {
     LOGD("GodHashTables destroyed");
 }
 
+void GodHashTables::reset() {
+    memset(subTable, 0, sizeof(subTable));
+    memset(masterTable, 0, sizeof(masterTable));
+    blocksInCurrentSub = 0;
+    subTablesClosed = 0;
+    subTableClosed = false;
+}
+
 void GodHashTables::addBlockHash(const uint8_t* hash) {
-    // Adicionar hash à sub hash table atual
-    for (uint32_t i = 0; i < HASH_SIZE; i++) {
-        currentSubTable.push_back(hash[i]);
-    }
-    
-    blocksInCurrentSub++;
-    
-    // Se completou uma sub hash table (204 blocos)
-    if (blocksInCurrentSub >= BLOCKS_PER_SUB) {
-        finalizeCurrentSubTable();
-    }
+    addBlockHashes(hash, 1);
 }
 
-void GodHashTables::finalizeCurrentSubTable() {
-    if (currentSubTable.empty()) {
-        return;
+uint32_t GodHashTables::addBlockHashes(const uint8_t* hashes, uint32_t count) {
+    // A SHT anterior já foi gravada: começar a próxima do zero
+    if (subTableClosed) {
+        memset(subTable, 0, sizeof(subTable));
+        blocksInCurrentSub = 0;
+        subTableClosed = false;
     }
     
-    // Preencher com zeros se não tiver 204 blocos
-    while (blocksInCurrentSub < BLOCKS_PER_SUB) {
-        for (uint32_t i = 0; i < HASH_SIZE; i++) {
-            currentSubTable.push_back(0);
-        }
-        blocksInCurrentSub++;
-    }
+    uint32_t room = BLOCKS_PER_SUB - blocksInCurrentSub;
+    uint32_t toCopy = count < room ? count : room;
     
-    // Adicionar à lista de sub hash tables
-    subHashTables.push_back(currentSubTable);
+    memcpy(subTable + blocksInCurrentSub * HASH_SIZE, hashes, (size_t)toCopy * HASH_SIZE);
+    blocksInCurrentSub += toCopy;
     
-    LOGD("Finalized Sub Hash Table #%zu (%zu bytes)",
-         subHashTables.size() - 1, currentSubTable.size());
-    
-    // Resetar para próxima sub table
-    currentSubTable.clear();
-    blocksInCurrentSub = 0;
+    return toCopy;
 }
 
-void GodHashTables::finalize() {
-    // Finalizar sub hash table atual se tiver dados
-    if (!currentSubTable.empty()) {
-        finalizeCurrentSubTable();
+HashTableSpan GodHashTables::finishSubTable() {
+    if (subTablesClosed >= SUBS_PER_MASTER) {
+        LOGE("Master Hash Table already has %u entries", SUBS_PER_MASTER);
+        return getSubHashTable();
     }
     
-    // Calcular Master Hash Table
-    calculateMasterHash();
-    
-    LOGD("Finalization complete - Total Sub Hash Tables: %zu", subHashTables.size());
-}
-
-void GodHashTables::calculateMasterHash() {
-    masterHashTable.clear();
-    
-    // Master Hash Table contém hashes das Sub Hash Tables
-    for (const auto& subTable : subHashTables) {
-        uint8_t subHash[20];
-        
-        // Calcular SHA-1 da Sub Hash Table inteira
-        HashUtils::calculateSHA1(subTable.data(), subTable.size(), subHash);
-        
-        // Adicionar hash à Master Hash Table
-        for (uint32_t i = 0; i < HASH_SIZE; i++) {
-            masterHashTable.push_back(subHash[i]);
-        }
-    }
+    // SHA-1 do bloco SHT inteiro (4096 bytes, entradas ausentes em zero)
+    HashUtils::calculateSHA1(subTable, BLOCK_SIZE, masterTable + subTablesClosed * HASH_SIZE);
     
-    // Preencher Master Hash Table até ter 203 entries
-    while (masterHashTable.size() < SUBS_PER_MASTER * HASH_SIZE) {
-        for (uint32_t i = 0; i < HASH_SIZE; i++) {
-            masterHashTable.push_back(0);
-        }
-    }
+    subTablesClosed++;
+    subTableClosed = true;
     
-    LOGD("Master Hash Table calculated (%zu bytes)", masterHashTable.size());
+    return getSubHashTable();
 }
 
-std::vector<uint8_t> GodHashTables::getMasterHashTable() const {
-    return masterHashTable;
+uint64_t GodHashTables::subHashTableOffset(uint32_t index) {
+    // MHT, depois cada SHT seguida dos seus 204 blocos
+    return (uint64_t)BLOCK_SIZE * (1 + (uint64_t)index * (BLOCKS_PER_SUB + 1));
 }
 
-std::vector<uint8_t> GodHashTables::getSubHashTable(uint32_t index) const {
-    if (index < subHashTables.size()) {
-        return subHashTables[index];
+bool GodHashTables::readTableBlock(int partFd, uint64_t offset, uint8_t* table) {
+    size_t size = BLOCK_SIZE;
+    
+    while (size > 0) {
+        ssize_t n = pread64(partFd, table, size, (off64_t)offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            LOGE("Failed to read hash table at offset %llu: %s",
+                 (unsigned long long)offset, n < 0 ? strerror(errno) : "end of file");
+            return false;
+        }
+        table += n;
+        size -= n;
+        offset += n;
     }
-    return std::vector<uint8_t>();
-}
-
-uint32_t GodHashTables::getSubHashTableCount() const {
-    return subHashTables.size();
+    return true;
 }
 
-bool GodHashTables::writeToFile(const std::string& dataFilePath) {
-    // TODO: Implementar escrita de hash tables no arquivo Data
-    // As hash tables são escritas no início do arquivo Data0000
-    
-    LOGD("TODO: Write hash tables to: %s", dataFilePath.c_str());
+bool GodHashTables::writeTableBlock(int partFd, uint64_t offset, const uint8_t* table) {
+    size_t size = BLOCK_SIZE;
     
+    while (size > 0) {
+        ssize_t written = pwrite64(partFd, table, size, (off64_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGE("Failed to write hash table at offset %llu: %s",
+                 (unsigned long long)offset, strerror(errno));
+            return false;
+        }
+        table += written;
+        size -= written;
+        offset += written;
+    }
     return true;
 }
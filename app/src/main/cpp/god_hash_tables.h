@@ -2,38 +2,72 @@
 #define GOD_HASH_TABLES_H
 
 #include <cstdint>
-#include <vector>
-#include <string>
+#include <cstddef>
 
+// View somente leitura de um bloco de tabela (sem cópia)
+struct HashTableSpan {
+    const uint8_t* data;
+    size_t size;
+};
+
+// Hash tables de uma parte DataNNNN do GOD:
+//
+//   [MHT][SHT 0][204 blocos][SHT 1][204 blocos] ... [SHT 202][204 blocos]
+//
+// Cada SHT (bloco de 4096 bytes) tem o SHA-1 dos seus 204 blocos de dados;
+// a MHT tem o SHA-1 de cada bloco SHT inteiro. Só existem em memória a SHT
+// em preenchimento e a MHT da parte atual, em arrays fixos: cada SHT é
+// hasheada assim que fecha e pode ser gravada e descartada em seguida.
+// reset() prepara a próxima parte.
 class GodHashTables {
 public:
+    static const uint32_t BLOCK_SIZE = 4096;
+    static const uint32_t HASH_SIZE = 20;
+    static const uint32_t BLOCKS_PER_SUB = 204;
+    static const uint32_t SUBS_PER_MASTER = 203;
+    
     GodHashTables();
     ~GodHashTables();
     
     void addBlockHash(const uint8_t* hash);
     
-    void finalize();
+    // Adiciona hashes de 20 bytes consecutivos (saída de
+    // HashUtils::calculateSHA1Batch) à SHT atual, no máximo até completá-la.
+    // Retorna quantos foram consumidos.
+    uint32_t addBlockHashes(const uint8_t* hashes, uint32_t count);
     
-    std::vector<uint8_t> getMasterHashTable() const;
+    bool isSubTableFull() const { return blocksInCurrentSub == BLOCKS_PER_SUB; }
+    bool hasPendingSubTable() const { return blocksInCurrentSub > 0 && !subTableClosed; }
     
-    std::vector<uint8_t> getSubHashTable(uint32_t index) const;
+    // Fecha a SHT atual (completa, ou parcial no fim do ISO) e registra o
+    // SHA-1 do bloco na MHT. A view vale até o próximo addBlockHashes().
+    HashTableSpan finishSubTable();
     
-    uint32_t getSubHashTableCount() const;
+    // SHTs já fechadas nesta parte (índice da próxima SHT)
+    uint32_t getSubHashTableCount() const { return subTablesClosed; }
     
-    bool writeToFile(const std::string& dataFilePath);
+    HashTableSpan getMasterHashTable() const { return HashTableSpan{masterTable, BLOCK_SIZE}; }
+    HashTableSpan getSubHashTable() const { return HashTableSpan{subTable, BLOCK_SIZE}; }
     
-private:
-    std::vector<std::vector<uint8_t>> subHashTables;
-    std::vector<uint8_t> masterHashTable;
-    std::vector<uint8_t> currentSubTable;
-    uint32_t blocksInCurrentSub;
+    // Limpa tudo para a próxima parte
+    void reset();
     
-    static const uint32_t HASH_SIZE = 20;
-    static const uint32_t BLOCKS_PER_SUB = 204;
-    static const uint32_t SUBS_PER_MASTER = 203;
+    // Offset de cada tabela dentro da parte
+    static uint64_t subHashTableOffset(uint32_t index);
+    static uint64_t masterHashTableOffset() { return 0; }
     
-    void finalizeCurrentSubTable();
-    void calculateMasterHash();
+    // Lê/grava um bloco de tabela de BLOCK_SIZE bytes em offset
+    static bool readTableBlock(int partFd, uint64_t offset, uint8_t* table);
+    static bool writeTableBlock(int partFd, uint64_t offset, const uint8_t* table);
+    
+private:
+    // Blocos inteiros: 204 × 20 (+16 de padding) e 203 × 20 (+ hash da
+    // MHT da parte seguinte + padding), já no formato gravado no arquivo
+    uint8_t subTable[BLOCK_SIZE];
+    uint8_t masterTable[BLOCK_SIZE];
+    uint32_t blocksInCurrentSub;
+    uint32_t subTablesClosed;
+    bool subTableClosed;
 };
 
 #endif // GOD_HASH_TABLES_H
@@ -0,0 +1,314 @@
+#include "god_layout_writer.h"
+#include "hash_utils.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "GodLayoutWriter"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+GodLayoutWriter::GodLayoutWriter(const std::string& dataBasePath, PayloadCopier& copier)
+    : dataBasePath(dataBasePath),
+      copier(copier),
+      partFd(-1),
+      partCount(0),
+      resumedParts(0),
+      blocksInPart(0),
+      totalBlocks(0),
+      zeroBlocks(0) {
+}
+
+GodLayoutWriter::~GodLayoutWriter() {
+    if (partFd >= 0) {
+        close(partFd);
+    }
+}
+
+uint64_t GodLayoutWriter::dataBlockOffset(uint32_t blockInPart) {
+    uint32_t sub = blockInPart / BLOCK_PER_SHT;
+    uint32_t blockInSub = blockInPart % BLOCK_PER_SHT;
+    return GodHashTables::subHashTableOffset(sub) + (uint64_t)(1 + blockInSub) * BLOCK_SIZE;
+}
+
+void GodLayoutWriter::masterDigest(const uint8_t* master, uint8_t* digestOut) {
+    const size_t chainOffset = (size_t)SHT_PER_MHT * GodHashTables::HASH_SIZE;
+    uint8_t unchained[BLOCK_SIZE];
+
+    memcpy(unchained, master, BLOCK_SIZE);
+    memset(unchained + chainOffset, 0, GodHashTables::HASH_SIZE);
+    HashUtils::calculateSHA1(unchained, BLOCK_SIZE, digestOut);
+}
+
+std::string GodLayoutWriter::partPath(uint32_t index) const {
+    char partName[16];
+    snprintf(partName, sizeof(partName), "%04u", index);
+    return dataBasePath + partName;
+}
+
+bool GodLayoutWriter::openNextPart() {
+    std::string path = partPath(partCount);
+
+    partFd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (partFd < 0) {
+        LOGE("Failed to create Data file: %s (%s)", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    partCount++;
+    blocksInPart = 0;
+    hashTables.reset();
+
+    LOGD("Created Data file part %u: %s", partCount - 1, path.c_str());
+    return true;
+}
+
+bool GodLayoutWriter::flushSubTable() {
+    uint32_t index = hashTables.getSubHashTableCount();
+    HashTableSpan subTable = hashTables.finishSubTable();
+
+    if (!GodHashTables::writeTableBlock(partFd, GodHashTables::subHashTableOffset(index), subTable.data)) {
+        LOGE("Failed to write Sub Hash Table #%u of part %u", index, partCount - 1);
+        return false;
+    }
+    return true;
+}
+
+bool GodLayoutWriter::closePart(bool checkpoint) {
+    // SHT parcial (fim do ISO) e a MHT desta parte, ainda sem o encadeamento
+    bool written = !hashTables.hasPendingSubTable() || flushSubTable();
+
+    if (written) {
+        HashTableSpan master = hashTables.getMasterHashTable();
+        written = GodHashTables::writeTableBlock(partFd, GodHashTables::masterHashTableOffset(), master.data);
+    }
+
+    // Blocos zerados no fim da parte não foram escritos: fixar o tamanho
+    if (written && blocksInPart > 0) {
+        off64_t partSize = (off64_t)(dataBlockOffset(blocksInPart - 1) + BLOCK_SIZE);
+        if (ftruncate64(partFd, partSize) != 0) {
+            LOGE("Failed to set size of part %u: %s", partCount - 1, strerror(errno));
+            written = false;
+        }
+    }
+
+    // Checkpoint: a parte tem que estar no disco antes de ser anunciada
+    checkpoint = checkpoint && written && partCompleteCallback;
+    if (checkpoint && fdatasync(partFd) != 0) {
+        LOGE("Failed to sync part %u: %s", partCount - 1, strerror(errno));
+        checkpoint = false;
+    }
+
+    if (!written) {
+        LOGE("Failed to write hash tables of part %u", partCount - 1);
+    }
+
+    close(partFd);
+    partFd = -1;
+
+    if (checkpoint) {
+        uint8_t digest[HashUtils::SHA1_DIGEST_SIZE];
+        masterDigest(hashTables.getMasterHashTable().data, digest);
+        partCompleteCallback(partCount - 1, digest);
+    }
+    return written;
+}
+
+void GodLayoutWriter::resumeAfter(uint32_t completedParts) {
+    partCount = completedParts;
+    resumedParts = completedParts;
+    totalBlocks = (uint64_t)completedParts * BLOCK_PER_PART;
+}
+
+bool GodLayoutWriter::verifyPart(uint32_t index, const uint8_t* expectedDigest) const {
+    std::string path = partPath(index);
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("Completed part missing: %s", path.c_str());
+        return false;
+    }
+
+    uint8_t master[BLOCK_SIZE];
+    uint8_t table[BLOCK_SIZE];
+    uint8_t digest[HashUtils::SHA1_DIGEST_SIZE];
+    struct stat st;
+
+    bool valid = fstat(fd, &st) == 0 &&
+                 (uint64_t)st.st_size == dataBlockOffset(BLOCK_PER_PART - 1) + BLOCK_SIZE &&
+                 GodHashTables::readTableBlock(fd, GodHashTables::masterHashTableOffset(), master);
+
+    if (valid) {
+        masterDigest(master, digest);
+        valid = memcmp(digest, expectedDigest, sizeof(digest)) == 0;
+    }
+
+    // Cada SHT tem que bater com a sua entrada na MHT
+    for (uint32_t i = 0; valid && i < SHT_PER_MHT; i++) {
+        valid = GodHashTables::readTableBlock(fd, GodHashTables::subHashTableOffset(i), table);
+        if (valid) {
+            HashUtils::calculateSHA1(table, BLOCK_SIZE, digest);
+            valid = memcmp(digest, master + (size_t)i * GodHashTables::HASH_SIZE, sizeof(digest)) == 0;
+        }
+    }
+    close(fd);
+
+    if (!valid) {
+        LOGE("Completed part %u failed validation, converting again from there", index);
+    }
+    return valid;
+}
+
+bool GodLayoutWriter::writePayload(
+    uint64_t outOffset,
+    const uint8_t* zeroFlags,
+    const uint8_t* data,
+    uint64_t isoOffset,
+    uint32_t blockCount,
+    uint32_t payloadBytes
+) {
+    uint32_t block = 0;
+
+    while (block < blockCount) {
+        // Sequência de blocos todos zerados ou todos com dados
+        bool zero = zeroFlags && zeroFlags[block];
+        uint32_t end = block + 1;
+        if (!zeroFlags) {
+            end = blockCount;
+        }
+        while (end < blockCount && (zeroFlags[end] != 0) == zero) {
+            end++;
+        }
+
+        uint32_t start = block * BLOCK_SIZE;
+        if (zero) {
+            zeroBlocks += end - block;
+        } else if (start < payloadBytes) {
+            // O resto do bloco parcial fica para o ftruncate em closePart()
+            uint32_t stop = end * BLOCK_SIZE < payloadBytes ? end * BLOCK_SIZE : payloadBytes;
+            if (!copier.copy(partFd, outOffset + start, isoOffset + start, data + start, stop - start)) {
+                LOGE("Failed to write block %llu to data file", (unsigned long long)(totalBlocks + block));
+                return false;
+            }
+        }
+
+        block = end;
+    }
+
+    return true;
+}
+
+bool GodLayoutWriter::writeBlocks(
+    const uint8_t* hashes,
+    const uint8_t* zeroFlags,
+    const uint8_t* data,
+    uint64_t isoOffset,
+    uint32_t blockCount,
+    uint32_t payloadBytes
+) {
+    while (blockCount > 0) {
+        // Abrir a próxima parte só quando houver dados para ela
+        if (partFd < 0 || blocksInPart >= BLOCK_PER_PART) {
+            if (partFd >= 0 && !closePart(true)) {
+                return false;
+            }
+            if (!openNextPart()) {
+                return false;
+            }
+        }
+
+        // Blocos contíguos no arquivo: até o fim da sub hash table atual
+        uint32_t blocksLeftInSub = BLOCK_PER_SHT - blocksInPart % BLOCK_PER_SHT;
+        uint32_t run = blockCount < blocksLeftInSub ? blockCount : blocksLeftInSub;
+        uint32_t runBytes = run * BLOCK_SIZE;
+        uint32_t runPayload = payloadBytes < runBytes ? payloadBytes : runBytes;
+        uint64_t outOffset = dataBlockOffset(blocksInPart);
+
+        if (!writePayload(outOffset, zeroFlags, data, isoOffset, run, runPayload)) {
+            return false;
+        }
+
+        // A SHT é gravada (e descartada) assim que completa
+        hashTables.addBlockHashes(hashes, run);
+        if (hashTables.isSubTableFull() && !flushSubTable()) {
+            return false;
+        }
+
+        hashes += (size_t)run * HashUtils::SHA1_DIGEST_SIZE;
+        if (zeroFlags) {
+            zeroFlags += run;
+        }
+        data += runBytes;
+        isoOffset += runBytes;
+        payloadBytes -= runPayload;
+        blockCount -= run;
+        blocksInPart += run;
+        totalBlocks += run;
+    }
+
+    return true;
+}
+
+bool GodLayoutWriter::finish() {
+    if (partFd >= 0 && !closePart(false)) {
+        return false;
+    }
+
+    if (partCount == 0) {
+        return true;
+    }
+
+    // Encadear de trás para frente: a MHT da parte i recebe, logo depois
+    // das 203 entradas, o SHA-1 da MHT (já encadeada) da parte i + 1. Só a
+    // MHT da parte seguinte fica em memória.
+    const size_t chainOffset = (size_t)SHT_PER_MHT * GodHashTables::HASH_SIZE;
+    uint8_t nextMaster[BLOCK_SIZE];
+    uint8_t master[BLOCK_SIZE];
+
+    if (partCount > resumedParts) {
+        HashTableSpan lastMaster = hashTables.getMasterHashTable();
+        memcpy(nextMaster, lastMaster.data, BLOCK_SIZE);
+    } else {
+        // Retomada sem nada novo: a última parte só existe no disco
+        std::string path = partPath(partCount - 1);
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        bool loaded = fd >= 0 &&
+                      GodHashTables::readTableBlock(fd, GodHashTables::masterHashTableOffset(), nextMaster);
+        if (fd >= 0) {
+            close(fd);
+        }
+        if (!loaded) {
+            LOGE("Failed to read last Data file: %s", path.c_str());
+            return false;
+        }
+    }
+
+    for (uint32_t i = partCount - 1; i-- > 0; ) {
+        std::string path = partPath(i);
+        int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0) {
+            LOGE("Failed to reopen Data file: %s (%s)", path.c_str(), strerror(errno));
+            return false;
+        }
+
+        bool written = GodHashTables::readTableBlock(fd, GodHashTables::masterHashTableOffset(), master);
+        if (written) {
+            HashUtils::calculateSHA1(nextMaster, BLOCK_SIZE, master + chainOffset);
+            written = GodHashTables::writeTableBlock(fd, GodHashTables::masterHashTableOffset(), master);
+        }
+        close(fd);
+
+        if (!written) {
+            return false;
+        }
+
+        memcpy(nextMaster, master, BLOCK_SIZE);
+    }
+
+    LOGD("GOD layout complete: %u parts, %llu blocks (%llu zero blocks left as holes)",
+         partCount, (unsigned long long)totalBlocks, (unsigned long long)zeroBlocks);
+    return true;
+}
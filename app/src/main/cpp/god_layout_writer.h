@@ -0,0 +1,107 @@
+#ifndef GOD_LAYOUT_WRITER_H
+#define GOD_LAYOUT_WRITER_H
+
+#include "god_hash_tables.h"
+#include "payload_copier.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Escreve as partes DataNNNN do GOD numa única passada sobre o ISO.
+//
+// Os blocos de dados vão direto para a posição final na parte; os blocos
+// da MHT e de cada SHT ficam reservados (buracos no arquivo). Cada SHT é
+// gravada com pwrite assim que os seus 204 blocos completam, e a MHT
+// quando a parte fecha. No fim, finish() encadeia as partes: a MHT de cada
+// parte recebe o SHA-1 da MHT da parte seguinte, o que relê e regrava só
+// 4 KiB por parte. A memória das tabelas é a de uma parte, qualquer que
+// seja o tamanho do ISO.
+//
+// Blocos todos zerados não são escritos: a parte é criada vazia, então a
+// faixa pulada fica como buraco (arquivo esparso) ou, em sistemas de
+// arquivos sem suporte, é preenchida com zeros pelo próprio kernel. Ao
+// fechar a parte o tamanho é fixado com ftruncate, o que cobre também um
+// bloco zerado ou parcial no final.
+//
+// Cada parte cheia fechada durante a conversão é sincronizada no disco e
+// anunciada pelo PartCompleteCallback (checkpoint para retomar depois);
+// resumeAfter() continua a partir da primeira parte não concluída.
+using PartCompleteCallback = std::function<void(uint32_t partIndex, const uint8_t* masterDigest)>;
+
+class GodLayoutWriter {
+public:
+    static const uint32_t BLOCK_SIZE = 4096;
+    static const uint32_t BLOCK_PER_SHT = 204;
+    static const uint32_t SHT_PER_MHT = 203;
+    static const uint32_t BLOCK_PER_PART = 41412;   // BLOCK_PER_SHT * SHT_PER_MHT
+
+    GodLayoutWriter(const std::string& dataBasePath, PayloadCopier& copier);
+    ~GodLayoutWriter();
+
+    // Próximos blockCount blocos do ISO, em ordem. hashes tem o SHA-1 de
+    // cada bloco e zeroFlags (opcional) marca os blocos todos zerados;
+    // data e isoOffset apontam para os mesmos bytes na memória e no ISO.
+    // payloadBytes < blockCount * BLOCK_SIZE só no último bloco do ISO,
+    // que é completado com zeros.
+    bool writeBlocks(
+        const uint8_t* hashes,
+        const uint8_t* zeroFlags,
+        const uint8_t* data,
+        uint64_t isoOffset,
+        uint32_t blockCount,
+        uint32_t payloadBytes
+    );
+
+    // Fecha a última parte e grava o encadeamento das MHTs
+    bool finish();
+
+    // As partes 0..completedParts-1 já estão prontas no disco: a próxima
+    // escrita abre a parte completedParts. Chamar antes de writeBlocks().
+    void resumeAfter(uint32_t completedParts);
+
+    // Confere uma parte cheia já gravada: tamanho, digest da MHT e o hash
+    // de cada SHT. Não relê os blocos de dados.
+    bool verifyPart(uint32_t index, const uint8_t* masterDigest) const;
+
+    void setPartCompleteCallback(PartCompleteCallback callback) { partCompleteCallback = callback; }
+
+    uint32_t getPartCount() const { return partCount; }
+    uint64_t getBlockCount() const { return totalBlocks; }
+
+    // Blocos zerados deixados como buraco em vez de escritos
+    uint64_t getZeroBlockCount() const { return zeroBlocks; }
+
+    // Offset do bloco de dados blockInPart dentro da parte
+    static uint64_t dataBlockOffset(uint32_t blockInPart);
+
+    // SHA-1 da MHT sem o hash de encadeamento (gravado só em finish())
+    static void masterDigest(const uint8_t* master, uint8_t* digestOut);
+
+private:
+    std::string dataBasePath;
+    PayloadCopier& copier;
+    GodHashTables hashTables;
+    PartCompleteCallback partCompleteCallback;
+
+    int partFd;
+    uint32_t partCount;
+    uint32_t resumedParts;
+    uint32_t blocksInPart;
+    uint64_t totalBlocks;
+    uint64_t zeroBlocks;
+
+    std::string partPath(uint32_t index) const;
+    bool openNextPart();
+    bool flushSubTable();
+    bool writePayload(
+        uint64_t outOffset,
+        const uint8_t* zeroFlags,
+        const uint8_t* data,
+        uint64_t isoOffset,
+        uint32_t blockCount,
+        uint32_t payloadBytes
+    );
+    bool closePart(bool checkpoint);
+};
+
+#endif // GOD_LAYOUT_WRITER_H
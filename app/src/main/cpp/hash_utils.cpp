@@ -1,52 +1,58 @@
 #include "hash_utils.h"
-#include <android/log.h>
+#include "sha1_backends.h"
+#include "native_log.h"
 #include <sstream>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__aarch64__) && !defined(HWCAP_SHA1)
+#define HWCAP_SHA1 (1 << 5)
+#endif
+
+#if defined(__arm__) && !defined(HWCAP_NEON)
+#define HWCAP_NEON (1 << 12)
+#endif
 
 #define LOG_TAG "HashUtils"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 // Rotação à esquerda de 32 bits
 #define ROL32(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
 
-// Implementação SHA-1 conforme RFC 3174
-void HashUtils::calculateSHA1(const uint8_t* data, size_t size, uint8_t* hashOut) {
-    // Inicialização das constantes H
-    uint32_t h0 = 0x67452301;
-    uint32_t h1 = 0xEFCDAB89;
-    uint32_t h2 = 0x98BADCFE;
-    uint32_t h3 = 0x10325476;
-    uint32_t h4 = 0xC3D2E1F0;
-    
-    // Padding
-    uint64_t originalSize = size;
-    uint64_t paddedSize = ((size + 8) / 64 + 1) * 64;
-    uint8_t* paddedData = new uint8_t[paddedSize];
-    
-    memcpy(paddedData, data, size);
-    paddedData[size] = 0x80;
-    
-    for (size_t i = size + 1; i < paddedSize - 8; i++) {
-        paddedData[i] = 0;
-    }
+// Implementação de referência (RFC 3174), usada como oráculo no self-test
+static void sha1ProcessBlocksReference(uint32_t state[5], const uint8_t* data, size_t numBlocks) {
+    uint32_t h0 = state[0];
+    uint32_t h1 = state[1];
+    uint32_t h2 = state[2];
+    uint32_t h3 = state[3];
+    uint32_t h4 = state[4];
     
-    // Adicionar tamanho original em bits (big-endian)
-    uint64_t bitLength = originalSize * 8;
-    for (int i = 0; i < 8; i++) {
-        paddedData[paddedSize - 1 - i] = (bitLength >> (i * 8)) & 0xFF;
-    }
-    
-    // Processar cada chunk de 512 bits (64 bytes)
-    for (size_t chunk = 0; chunk < paddedSize; chunk += 64) {
+    for (size_t chunk = 0; chunk < numBlocks; chunk++, data += 64) {
         uint32_t w[80];
         
         // Dividir chunk em 16 palavras de 32 bits (big-endian)
         for (int i = 0; i < 16; i++) {
-            w[i] = (paddedData[chunk + i * 4] << 24) |
-                   (paddedData[chunk + i * 4 + 1] << 16) |
-                   (paddedData[chunk + i * 4 + 2] << 8) |
-                   (paddedData[chunk + i * 4 + 3]);
+            w[i] = ((uint32_t)data[i * 4] << 24) |
+                   ((uint32_t)data[i * 4 + 1] << 16) |
+                   ((uint32_t)data[i * 4 + 2] << 8) |
+                   ((uint32_t)data[i * 4 + 3]);
         }
         
         // Estender as 16 palavras para 80
@@ -95,33 +101,577 @@ void HashUtils::calculateSHA1(const uint8_t* data, size_t size, uint8_t* hashOut
         h4 += e;
     }
     
-    delete[] paddedData;
+    state[0] = h0;
+    state[1] = h1;
+    state[2] = h2;
+    state[3] = h3;
+    state[4] = h4;
+}
+
+// Funções de round do SHA-1
+#define SHA1_F0(b, c, d) ((((c) ^ (d)) & (b)) ^ (d))
+#define SHA1_F1(b, c, d) ((b) ^ (c) ^ (d))
+#define SHA1_F2(b, c, d) ((((b) | (c)) & (d)) | ((b) & (c)))
+
+// Palavra i da mensagem: as 16 primeiras vêm do bloco, as demais são
+// expandidas em um buffer circular de 16 posições
+#define SHA1_WORD(i) ((i) < 16 ? w[(i) & 15] :                                       \
+    (w[(i) & 15] = ROL32(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^                     \
+                         w[((i) + 2) & 15] ^ w[(i) & 15], 1)))
+
+#define SHA1_ROUND(a, b, c, d, e, i, f, k) \
+    e += f(b, c, d) + SHA1_WORD(i) + (k) + ROL32(a, 5); b = ROL32(b, 30)
+
+// 5 rounds com rotação das variáveis (a, b, c, d, e)
+#define SHA1_ROUNDS5(i, f, k)                      \
+    SHA1_ROUND(a, b, c, d, e, (i) + 0, f, k);      \
+    SHA1_ROUND(e, a, b, c, d, (i) + 1, f, k);      \
+    SHA1_ROUND(d, e, a, b, c, (i) + 2, f, k);      \
+    SHA1_ROUND(c, d, e, a, b, (i) + 3, f, k);      \
+    SHA1_ROUND(b, c, d, e, a, (i) + 4, f, k)
+
+// Fallback escalar: 80 rounds desenrolados, sem seletor de round no loop
+static void sha1ProcessBlocksUnrolled(uint32_t state[5], const uint8_t* data, size_t numBlocks) {
+    for (size_t chunk = 0; chunk < numBlocks; chunk++, data += 64) {
+        uint32_t w[16];
+        
+        for (int i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)data[i * 4] << 24) |
+                   ((uint32_t)data[i * 4 + 1] << 16) |
+                   ((uint32_t)data[i * 4 + 2] << 8) |
+                   ((uint32_t)data[i * 4 + 3]);
+        }
+        
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        
+        SHA1_ROUNDS5(0, SHA1_F0, 0x5A827999);
+        SHA1_ROUNDS5(5, SHA1_F0, 0x5A827999);
+        SHA1_ROUNDS5(10, SHA1_F0, 0x5A827999);
+        SHA1_ROUNDS5(15, SHA1_F0, 0x5A827999);
+        SHA1_ROUNDS5(20, SHA1_F1, 0x6ED9EBA1);
+        SHA1_ROUNDS5(25, SHA1_F1, 0x6ED9EBA1);
+        SHA1_ROUNDS5(30, SHA1_F1, 0x6ED9EBA1);
+        SHA1_ROUNDS5(35, SHA1_F1, 0x6ED9EBA1);
+        SHA1_ROUNDS5(40, SHA1_F2, 0x8F1BBCDC);
+        SHA1_ROUNDS5(45, SHA1_F2, 0x8F1BBCDC);
+        SHA1_ROUNDS5(50, SHA1_F2, 0x8F1BBCDC);
+        SHA1_ROUNDS5(55, SHA1_F2, 0x8F1BBCDC);
+        SHA1_ROUNDS5(60, SHA1_F1, 0xCA62C1D6);
+        SHA1_ROUNDS5(65, SHA1_F1, 0xCA62C1D6);
+        SHA1_ROUNDS5(70, SHA1_F1, 0xCA62C1D6);
+        SHA1_ROUNDS5(75, SHA1_F1, 0xCA62C1D6);
+        
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+#undef SHA1_ROUNDS5
+#undef SHA1_ROUND
+#undef SHA1_WORD
+#undef SHA1_F2
+#undef SHA1_F1
+#undef SHA1_F0
+
+// Detecção de CPU
+#if defined(ISO2GOD_HAVE_SHA1_MB_SSSE3)
+static bool cpuHasSsse3() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & (1u << 9)) != 0;
+}
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_SHANI)
+static bool cpuHasShaNi() {
+    unsigned int eax, ebx, ecx, edx;
+    
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    bool hasSsse3 = (ecx & (1u << 9)) != 0;
+    bool hasSse41 = (ecx & (1u << 19)) != 0;
+    
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    bool hasSha = (ebx & (1u << 29)) != 0;
+    
+    return hasSsse3 && hasSse41 && hasSha;
+}
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_AVX2)
+static bool cpuHasAvx2() {
+    unsigned int eax, ebx, ecx, edx;
+    
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    // O SO precisa salvar os registradores YMM (OSXSAVE + XCR0)
+    bool hasOsxsave = (ecx & (1u << 27)) != 0;
+    bool hasAvx = (ecx & (1u << 28)) != 0;
+    if (!hasOsxsave || !hasAvx) {
+        return false;
+    }
+    
+    unsigned int xcr0Low, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    if ((xcr0Low & 0x6) != 0x6) {
+        return false;
+    }
+    
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx & (1u << 5)) != 0;
+}
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_ARMV8)
+static bool cpuHasArmv8Sha1() {
+    return (getauxval(AT_HWCAP) & HWCAP_SHA1) != 0;
+}
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_NEON)
+static bool cpuHasNeon() {
+#if defined(__aarch64__)
+    return true; // NEON é obrigatório em AArch64
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+}
+#endif
+
+static bool cpuAlwaysSupported() {
+    return true;
+}
+
+struct Sha1Backend {
+    const char* name;
+    Sha1BlockFunc processBlocks;
+    bool (*isSupported)();
+    bool hardware;
+};
+
+// Em ordem de preferência; o último sempre está disponível
+static const Sha1Backend kSha1Backends[] = {
+#if defined(ISO2GOD_HAVE_SHA1_ARMV8)
+    { "armv8-crypto", sha1ProcessBlocksArmv8, cpuHasArmv8Sha1, true },
+#endif
+#if defined(ISO2GOD_HAVE_SHA1_SHANI)
+    { "sha-ni", sha1ProcessBlocksShaNi, cpuHasShaNi, true },
+#endif
+    { "scalar-unrolled", sha1ProcessBlocksUnrolled, cpuAlwaysSupported, false },
+};
+
+struct Sha1MultiBufferBackend {
+    const char* name;
+    size_t lanes;
+    Sha1MultiBufferFunc hashMessages;
+    bool (*isSupported)();
+};
+
+static const size_t MAX_MULTI_BUFFER_LANES = 8;
+
+// Usados apenas quando a CPU não tem instruções SHA; em ordem de preferência
+static const Sha1MultiBufferBackend kSha1MultiBufferBackends[] = {
+#if defined(ISO2GOD_HAVE_SHA1_MB_AVX2)
+    { "avx2-x8", 8, sha1HashMultiBufferAvx2x8, cpuHasAvx2 },
+#endif
+#if defined(ISO2GOD_HAVE_SHA1_MB_SSSE3)
+    { "ssse3-x4", 4, sha1HashMultiBufferSsse3x4, cpuHasSsse3 },
+#endif
+#if defined(ISO2GOD_HAVE_SHA1_MB_NEON)
+    { "neon-x4", 4, sha1HashMultiBufferNeonx4, cpuHasNeon },
+#endif
+    { nullptr, 0, nullptr, nullptr }
+};
+
+static Sha1BlockFunc gSha1ProcessBlocks = sha1ProcessBlocksReference;
+static const char* gSha1BackendName = "scalar-reference";
+static const Sha1MultiBufferBackend* gSha1MultiBuffer = nullptr;
+
+// Compara um kernel com a implementação de referência em vários tamanhos
+// e estados iniciais
+static bool sha1BackendMatchesReference(Sha1BlockFunc processBlocks) {
+    const size_t MAX_TEST_BLOCKS = 9;
+    uint8_t data[MAX_TEST_BLOCKS * 64];
+    
+    uint32_t seed = 0x9E3779B9;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1664525 + 1013904223;
+        data[i] = (uint8_t)(seed >> 24);
+    }
+    
+    for (size_t numBlocks = 1; numBlocks <= MAX_TEST_BLOCKS; numBlocks++) {
+        uint32_t expected[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+        for (int i = 0; i < 5; i++) {
+            expected[i] ^= (uint32_t)(numBlocks * 0x01010101u * i);
+        }
+        uint32_t actual[5];
+        memcpy(actual, expected, sizeof(actual));
+        
+        sha1ProcessBlocksReference(expected, data, numBlocks);
+        processBlocks(actual, data, numBlocks);
+        
+        if (memcmp(expected, actual, sizeof(actual)) != 0) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Known-answer test da referência: SHA-1("abc")
+static bool sha1ReferenceKnownAnswer() {
+    static const uint8_t expected[20] = {
+        0xA9, 0x99, 0x3E, 0x36, 0x47, 0x06, 0x81, 0x6A, 0xBA, 0x3E,
+        0x25, 0x71, 0x78, 0x50, 0xC2, 0x6C, 0x9C, 0xD0, 0xD8, 0x9D
+    };
+    
+    uint8_t block[64] = { 'a', 'b', 'c', 0x80 };
+    block[63] = 24; // tamanho em bits
+    
+    uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    sha1ProcessBlocksReference(state, block, 1);
+    
+    for (int i = 0; i < 5; i++) {
+        if ((uint8_t)(state[i] >> 24) != expected[i * 4] ||
+            (uint8_t)(state[i] >> 16) != expected[i * 4 + 1] ||
+            (uint8_t)(state[i] >> 8) != expected[i * 4 + 2] ||
+            (uint8_t)state[i] != expected[i * 4 + 3]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compara um kernel multi-buffer com o SHA-1 de uma mensagem por vez,
+// com tamanhos que cobrem os casos de padding em 1 e 2 blocos
+static bool sha1MultiBufferMatchesSingle(const Sha1MultiBufferBackend& backend) {
+    static const size_t TEST_SIZES[] = { 0, 3, 55, 56, 64, 119, 4096 };
+    const size_t MAX_TEST_SIZE = 4096;
+    std::vector<uint8_t> data(MAX_MULTI_BUFFER_LANES * MAX_TEST_SIZE);
+    
+    uint32_t seed = 0x7F4A7C15;
+    for (size_t i = 0; i < data.size(); i++) {
+        seed = seed * 1664525 + 1013904223;
+        data[i] = (uint8_t)(seed >> 24);
+    }
+    
+    const uint8_t* messages[MAX_MULTI_BUFFER_LANES];
+    for (size_t lane = 0; lane < MAX_MULTI_BUFFER_LANES; lane++) {
+        messages[lane] = data.data() + lane * MAX_TEST_SIZE;
+    }
+    
+    for (size_t size : TEST_SIZES) {
+        uint8_t actual[MAX_MULTI_BUFFER_LANES * 20];
+        backend.hashMessages(messages, size, actual);
+        
+        for (size_t lane = 0; lane < backend.lanes; lane++) {
+            uint8_t expected[20];
+            HashUtils::calculateSHA1(messages[lane], size, expected);
+            if (memcmp(expected, actual + lane * 20, 20) != 0) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+static void selectSha1MultiBufferBackend() {
+    for (const auto& backend : kSha1MultiBufferBackends) {
+        if (!backend.hashMessages || !backend.isSupported()) {
+            continue;
+        }
+        
+        if (!sha1MultiBufferMatchesSingle(backend)) {
+            LOGE("SHA-1 multi-buffer backend %s failed self-test, skipping", backend.name);
+            continue;
+        }
+        
+        gSha1MultiBuffer = &backend;
+        LOGD("SHA-1 multi-buffer backend selected: %s", backend.name);
+        return;
+    }
+}
+
+// Escolhe o kernel mais rápido suportado pela CPU que passe no self-test
+static void selectSha1Backend() {
+    if (!sha1ReferenceKnownAnswer()) {
+        LOGE("SHA-1 reference implementation failed known-answer test");
+        return;
+    }
+    
+    for (const auto& backend : kSha1Backends) {
+        if (!backend.isSupported()) {
+            continue;
+        }
+        
+        if (!sha1BackendMatchesReference(backend.processBlocks)) {
+            LOGE("SHA-1 backend %s failed self-test, skipping", backend.name);
+            continue;
+        }
+        
+        gSha1ProcessBlocks = backend.processBlocks;
+        gSha1BackendName = backend.name;
+        LOGD("SHA-1 backend selected: %s", backend.name);
+        
+        // Com instruções SHA, um bloco por vez já é mais rápido que
+        // o multi-buffer escalar-em-SIMD
+        if (!backend.hardware) {
+            selectSha1MultiBufferBackend();
+        }
+        return;
+    }
+}
+
+// Seleção feita uma única vez, no carregamento da biblioteca
+namespace {
+struct Sha1BackendSelector {
+    Sha1BackendSelector() { selectSha1Backend(); }
+} gSha1BackendSelector;
+}
+
+// SHA-1 de 4096 bytes zerados
+static const uint8_t ZERO_BLOCK_SHA1[HashUtils::SHA1_DIGEST_SIZE] = {
+    0x1c, 0xea, 0xf7, 0x3d, 0xf4, 0x0e, 0x53, 0x1d, 0xf3, 0xbf,
+    0xb2, 0x6b, 0x4f, 0xb7, 0xcd, 0x95, 0xfb, 0x7b, 0xff, 0x1d
+};
+
+static bool zeroBlockSha1Matches() {
+    static const uint8_t zeros[HashUtils::ZERO_BLOCK_SIZE] = {0};
+    uint8_t hash[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1(zeros, sizeof(zeros), hash);
+    return memcmp(hash, ZERO_BLOCK_SHA1, sizeof(hash)) == 0;
+}
+
+bool HashUtils::runSha1SelfTest() {
+    if (!sha1ReferenceKnownAnswer()) {
+        LOGE("SHA-1 self-test: reference failed known-answer test");
+        return false;
+    }
+    
+    if (!zeroBlockSha1Matches()) {
+        LOGE("SHA-1 self-test: precomputed zero block hash mismatch");
+        return false;
+    }
+    
+    bool allPassed = true;
+    
+    for (const auto& backend : kSha1Backends) {
+        if (!backend.isSupported()) {
+            LOGD("SHA-1 self-test: %s not supported by this CPU", backend.name);
+            continue;
+        }
+        
+        bool passed = sha1BackendMatchesReference(backend.processBlocks);
+        LOGD("SHA-1 self-test: %s %s", backend.name, passed ? "OK" : "FAILED");
+        allPassed = allPassed && passed;
+    }
+    
+    for (const auto& backend : kSha1MultiBufferBackends) {
+        if (!backend.hashMessages) {
+            continue;
+        }
+        if (!backend.isSupported()) {
+            LOGD("SHA-1 self-test: %s not supported by this CPU", backend.name);
+            continue;
+        }
+        
+        bool passed = sha1MultiBufferMatchesSingle(backend);
+        LOGD("SHA-1 self-test: %s %s", backend.name, passed ? "OK" : "FAILED");
+        allPassed = allPassed && passed;
+    }
+    
+    return allPassed;
+}
+
+const char* HashUtils::getSha1BackendName() {
+    return gSha1BackendName;
+}
+
+const char* HashUtils::getSha1BatchBackendName() {
+    return gSha1MultiBuffer ? gSha1MultiBuffer->name : gSha1BackendName;
+}
+
+void HashUtils::sha1Init(SHA1Context& ctx) {
+    // Inicialização das constantes H
+    ctx.state[0] = 0x67452301;
+    ctx.state[1] = 0xEFCDAB89;
+    ctx.state[2] = 0x98BADCFE;
+    ctx.state[3] = 0x10325476;
+    ctx.state[4] = 0xC3D2E1F0;
+    ctx.totalBytes = 0;
+    ctx.bufferLength = 0;
+}
+
+void HashUtils::sha1Update(SHA1Context& ctx, const uint8_t* data, size_t size) {
+    ctx.totalBytes += size;
+    
+    // Completar bloco parcial pendente
+    if (ctx.bufferLength > 0) {
+        size_t fill = std::min(size, SHA1_BLOCK_SIZE - ctx.bufferLength);
+        memcpy(ctx.buffer + ctx.bufferLength, data, fill);
+        ctx.bufferLength += fill;
+        data += fill;
+        size -= fill;
+        
+        if (ctx.bufferLength < SHA1_BLOCK_SIZE) {
+            return;
+        }
+        
+        gSha1ProcessBlocks(ctx.state, ctx.buffer, 1);
+        ctx.bufferLength = 0;
+    }
+    
+    // Blocos completos direto da entrada, sem cópia
+    size_t fullBlocks = size / SHA1_BLOCK_SIZE;
+    if (fullBlocks > 0) {
+        gSha1ProcessBlocks(ctx.state, data, fullBlocks);
+        data += fullBlocks * SHA1_BLOCK_SIZE;
+        size -= fullBlocks * SHA1_BLOCK_SIZE;
+    }
+    
+    // Guardar o resto para o próximo update/final
+    if (size > 0) {
+        memcpy(ctx.buffer, data, size);
+        ctx.bufferLength = size;
+    }
+}
+
+void HashUtils::sha1Final(SHA1Context& ctx, uint8_t* hashOut) {
+    uint64_t bitLength = ctx.totalBytes * 8;
+    
+    // Padding: 0x80, zeros e tamanho em bits (big-endian) no buffer final
+    ctx.buffer[ctx.bufferLength++] = 0x80;
+    
+    if (ctx.bufferLength > SHA1_BLOCK_SIZE - 8) {
+        memset(ctx.buffer + ctx.bufferLength, 0, SHA1_BLOCK_SIZE - ctx.bufferLength);
+        gSha1ProcessBlocks(ctx.state, ctx.buffer, 1);
+        ctx.bufferLength = 0;
+    }
+    
+    memset(ctx.buffer + ctx.bufferLength, 0, SHA1_BLOCK_SIZE - 8 - ctx.bufferLength);
+    for (int i = 0; i < 8; i++) {
+        ctx.buffer[SHA1_BLOCK_SIZE - 1 - i] = (bitLength >> (i * 8)) & 0xFF;
+    }
+    gSha1ProcessBlocks(ctx.state, ctx.buffer, 1);
+    ctx.bufferLength = 0;
     
     // Converter para bytes (big-endian)
-    hashOut[0] = (h0 >> 24) & 0xFF;
-    hashOut[1] = (h0 >> 16) & 0xFF;
-    hashOut[2] = (h0 >> 8) & 0xFF;
-    hashOut[3] = h0 & 0xFF;
-    
-    hashOut[4] = (h1 >> 24) & 0xFF;
-    hashOut[5] = (h1 >> 16) & 0xFF;
-    hashOut[6] = (h1 >> 8) & 0xFF;
-    hashOut[7] = h1 & 0xFF;
-    
-    hashOut[8] = (h2 >> 24) & 0xFF;
-    hashOut[9] = (h2 >> 16) & 0xFF;
-    hashOut[10] = (h2 >> 8) & 0xFF;
-    hashOut[11] = h2 & 0xFF;
-    
-    hashOut[12] = (h3 >> 24) & 0xFF;
-    hashOut[13] = (h3 >> 16) & 0xFF;
-    hashOut[14] = (h3 >> 8) & 0xFF;
-    hashOut[15] = h3 & 0xFF;
-    
-    hashOut[16] = (h4 >> 24) & 0xFF;
-    hashOut[17] = (h4 >> 16) & 0xFF;
-    hashOut[18] = (h4 >> 8) & 0xFF;
-    hashOut[19] = h4 & 0xFF;
+    for (int i = 0; i < 5; i++) {
+        hashOut[i * 4] = (ctx.state[i] >> 24) & 0xFF;
+        hashOut[i * 4 + 1] = (ctx.state[i] >> 16) & 0xFF;
+        hashOut[i * 4 + 2] = (ctx.state[i] >> 8) & 0xFF;
+        hashOut[i * 4 + 3] = ctx.state[i] & 0xFF;
+    }
+}
+
+// Implementação SHA-1 conforme RFC 3174
+void HashUtils::calculateSHA1(const uint8_t* data, size_t size, uint8_t* hashOut) {
+    SHA1Context ctx;
+    sha1Init(ctx);
+    sha1Update(ctx, data, size);
+    sha1Final(ctx, hashOut);
+}
+
+void HashUtils::calculateSHA1Batch(
+    const uint8_t* const* blocks,
+    size_t count,
+    size_t blockSize,
+    uint8_t* hashesOut
+) {
+    size_t i = 0;
+    const Sha1MultiBufferBackend* multiBuffer = gSha1MultiBuffer;
+    
+    if (multiBuffer) {
+        const size_t lanes = multiBuffer->lanes;
+        
+        for (; i + lanes <= count; i += lanes) {
+            multiBuffer->hashMessages(blocks + i, blockSize, hashesOut + i * SHA1_DIGEST_SIZE);
+        }
+        
+        // Sobra de pelo menos meia largura: completar as lanes repetindo o
+        // último bloco e descartar os digests extras
+        size_t remaining = count - i;
+        if (remaining > 0 && remaining * 2 >= lanes) {
+            const uint8_t* laneBlocks[MAX_MULTI_BUFFER_LANES];
+            uint8_t laneHashes[MAX_MULTI_BUFFER_LANES * SHA1_DIGEST_SIZE];
+            
+            for (size_t lane = 0; lane < lanes; lane++) {
+                laneBlocks[lane] = blocks[std::min(i + lane, count - 1)];
+            }
+            
+            multiBuffer->hashMessages(laneBlocks, blockSize, laneHashes);
+            memcpy(hashesOut + i * SHA1_DIGEST_SIZE, laneHashes, remaining * SHA1_DIGEST_SIZE);
+            i = count;
+        }
+    }
+    
+    for (; i < count; i++) {
+        calculateSHA1(blocks[i], blockSize, hashesOut + i * SHA1_DIGEST_SIZE);
+    }
+}
+
+const uint8_t* HashUtils::getZeroBlockSHA1() {
+    return ZERO_BLOCK_SHA1;
+}
+
+bool HashUtils::isZeroBlock(const uint8_t* data, size_t size) {
+    size_t i = 0;
+    
+    // 64 bytes por iteração: OR de quatro vetores e um único teste
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 64 <= size; i += 64) {
+        __m128i acc = _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128((const __m128i*)(data + i)),
+                         _mm_loadu_si128((const __m128i*)(data + i + 16))),
+            _mm_or_si128(_mm_loadu_si128((const __m128i*)(data + i + 32)),
+                         _mm_loadu_si128((const __m128i*)(data + i + 48))));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, zero)) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 64 <= size; i += 64) {
+        uint8x16_t acc = vorrq_u8(
+            vorrq_u8(vld1q_u8(data + i), vld1q_u8(data + i + 16)),
+            vorrq_u8(vld1q_u8(data + i + 32), vld1q_u8(data + i + 48)));
+        uint64x2_t wide = vreinterpretq_u64_u8(acc);
+        if ((vgetq_lane_u64(wide, 0) | vgetq_lane_u64(wide, 1)) != 0) {
+            return false;
+        }
+    }
+#endif
+    
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word != 0) {
+            return false;
+        }
+    }
+    
+    for (; i < size; i++) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
 std::string HashUtils::hashToHexString(const uint8_t* hash, size_t size) {
@@ -2,21 +2,64 @@
 #define HASH_UTILS_H
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
 
 // Utilitários para SHA-1 hashing (necessário para GOD format)
-// TODO: Implementar SHA-1 completo ou usar biblioteca existente
+
+// Estado incremental do SHA-1. Fica inteiramente na stack: o padding final
+// é montado no buffer de 64 bytes, sem cópia do dado de entrada.
+struct SHA1Context {
+    uint32_t state[5];
+    uint64_t totalBytes;
+    uint8_t buffer[64];
+    uint32_t bufferLength;
+};
 
 class HashUtils {
 public:
+    static const size_t SHA1_DIGEST_SIZE = 20;
+    static const size_t SHA1_BLOCK_SIZE = 64;
+    
+    // API incremental: init → update (n vezes) → final
+    static void sha1Init(SHA1Context& ctx);
+    static void sha1Update(SHA1Context& ctx, const uint8_t* data, size_t size);
+    static void sha1Final(SHA1Context& ctx, uint8_t* hashOut);
+    
     // Calcula SHA-1 de dados
     static void calculateSHA1(const uint8_t* data, size_t size, uint8_t* hashOut);
     
+    // Calcula o SHA-1 de count blocos independentes de blockSize bytes
+    // cada (multi-buffer quando a CPU não tem instruções SHA).
+    // hashesOut recebe count digests de 20 bytes em sequência.
+    static void calculateSHA1Batch(
+        const uint8_t* const* blocks,
+        size_t count,
+        size_t blockSize,
+        uint8_t* hashesOut
+    );
+    
+    // Blocos de 4 KiB todos zerados (padding do ISO) têm sempre o mesmo
+    // SHA-1: quem chama pode pular o hash e usar getZeroBlockSHA1()
+    static const size_t ZERO_BLOCK_SIZE = 4096;
+    static const uint8_t* getZeroBlockSHA1();
+    
+    // true se os size bytes são todos zero (SSE2/NEON, para no primeiro
+    // vetor com algum byte diferente)
+    static bool isZeroBlock(const uint8_t* data, size_t size);
+    
+    // Confere todos os kernels SHA-1 suportados pela CPU contra a
+    // implementação de referência
+    static bool runSha1SelfTest();
+    
+    // Nome do kernel SHA-1 escolhido no carregamento da biblioteca
+    static const char* getSha1BackendName();
+    
+    // Nome do kernel usado por calculateSHA1Batch
+    static const char* getSha1BatchBackendName();
+    
     // Converte hash para string hex
     static std::string hashToHexString(const uint8_t* hash, size_t size);
-    
-private:
-    // TODO: Implementar SHA-1 algorithm
 };
 
 #endif // HASH_UTILS_H
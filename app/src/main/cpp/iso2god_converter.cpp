@@ -2,17 +2,24 @@
 #include "gdf_parser.h"
 #include "xex_parser.h"
 #include "hash_utils.h"
-#include "god_hash_tables.h"
-#include <fstream>
+#include "god_layout_writer.h"
+#include "data_pipeline.h"
+#include "iso_source.h"
+#include "payload_copier.h"
+#include "conversion_journal.h"
+#include "iso_metadata_cache.h"
+#include "iso_session.h"
+#include "native_log.h"
 #include <cstring>
+#include <algorithm>
+#include <thread>
 #include <sys/stat.h>
-#include <android/log.h>
 
 #define LOG_TAG "Iso2God-Native"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-Iso2GodConverter::Iso2GodConverter() : cancelled(false) {
+Iso2GodConverter::Iso2GodConverter() : externalCancelToken(nullptr), activeProfiler(nullptr) {
     LOGD("Iso2GodConverter initialized");
 }
 
@@ -23,48 +30,129 @@ Iso2GodConverter::~Iso2GodConverter() {
 int Iso2GodConverter::convertIsoToGod(
     const std::string& isoPath,
     const std::string& outputPath,
-    ProgressCallback progressCallback
+    ProgressCallback progressCallback,
+    const ConversionOptions& options
 ) {
-    cancelled = false;
+    return startConversion(isoPath, nullptr, outputPath, progressCallback, options);
+}
+
+int Iso2GodConverter::convertIsoToGod(
+    IsoSession& session,
+    const std::string& outputPath,
+    ProgressCallback progressCallback,
+    const ConversionOptions& options
+) {
+    return startConversion(session.getPath(), &session, outputPath, progressCallback, options);
+}
+
+int Iso2GodConverter::startConversion(
+    const std::string& isoPath,
+    IsoSession* session,
+    const std::string& outputPath,
+    ProgressCallback progressCallback,
+    const ConversionOptions& options
+) {
+    cancelToken.reset();
+    externalCancelToken = options.cancelToken;
+    lastStats = ConversionStats();
+    progressTracker.start();
+    
+    bool traceEnabled = !options.traceFilePath.empty();
+    profiler.reset(traceEnabled);
+    activeProfiler = (options.collectMetrics || traceEnabled) ? &profiler : nullptr;
+    
+    // Sem callback (conversão assíncrona) o andamento sai só do tracker
+    ProgressCallback reportedCallback = progressCallback;
+    if (activeProfiler) {
+        activeProfiler->setThreadName("converter");
+        
+        // Tempo gasto no callback (na JNI, a volta para a thread Java)
+        if (progressCallback) {
+            reportedCallback = [this, &progressCallback](float progress, const std::string& status) {
+                ProfileScope scope(activeProfiler, ConversionStage::Progress);
+                progressCallback(progress, status);
+            };
+        }
+    }
     
+    int result = runConversion(isoPath, session, outputPath, reportedCallback, options);
+    
+    if (traceEnabled) {
+        profiler.writeTrace(options.traceFilePath);
+    }
+    activeProfiler = nullptr;
+    externalCancelToken = nullptr;
+    progressTracker.finish(result);
+    return result;
+}
+
+void Iso2GodConverter::reportPhase(
+    ConversionPhase phase,
+    float progress,
+    const char* status,
+    const ProgressCallback& progressCallback
+) {
+    progressTracker.setPhase(phase, progress);
+    if (progressCallback) {
+        progressCallback(progress, status);
+    }
+}
+
+int Iso2GodConverter::runConversion(
+    const std::string& isoPath,
+    IsoSession* session,
+    const std::string& outputPath,
+    ProgressCallback progressCallback,
+    const ConversionOptions& options
+) {
     LOGD("=== Starting ISO to GOD Conversion ===");
     LOGD("ISO: %s", isoPath.c_str());
     LOGD("Output: %s", outputPath.c_str());
     
     try {
-        progressCallback(0.05f, "Analisando ISO...");
+        reportPhase(ConversionPhase::Analyzing, 0.05f, "Analisando ISO...", progressCallback);
         
-        IsoInfo info;
-        if (!readIsoHeader(isoPath, info)) {
-            LOGE("Failed to read ISO header");
-            return -1;
+        // Sem sessão do chamador: uma só para esta conversão (um único
+        // IsoSource para o cabeçalho e os dados)
+        std::unique_ptr<IsoSession> ownedSession;
+        if (!session) {
+            ownedSession = openSession(isoPath, options.metadataCacheDir);
+            if (!ownedSession) {
+                LOGE("Failed to read ISO header");
+                return -1;
+            }
+            session = ownedSession.get();
         }
+        const IsoInfo& info = session->getInfo();
         
-        if (cancelled) return -4;
+        if (isCancelled()) return -4;
         
         LOGD("ISO Information:");
         LOGD("  Game: %s", info.gameName.c_str());
         LOGD("  Title ID: %s", info.titleId.c_str());
         LOGD("  Media ID: %s", info.mediaId.c_str());
-        LOGD("  Size: %llu MB", info.sizeBytes / 1024 / 1024);
+        LOGD("  Size: %llu MB", (unsigned long long)(info.sizeBytes / 1024 / 1024));
         
-        progressCallback(0.1f, "Criando estrutura GOD...");
+        reportPhase(ConversionPhase::Preparing, 0.1f, "Criando estrutura GOD...", progressCallback);
         
         if (!createGodStructure(outputPath, info)) {
             LOGE("Failed to create GOD structure");
             return -2;
         }
         
-        if (cancelled) return -4;
+        if (isCancelled()) return -4;
         
-        progressCallback(0.15f, "Convertendo dados...");
+        reportPhase(ConversionPhase::Copying, 0.15f, "Convertendo dados...", progressCallback);
         
-        if (!convertData(isoPath, outputPath, info, progressCallback)) {
+        if (!convertData(session->getSource(), outputPath, info, progressCallback, options)) {
+            if (isCancelled()) return -4;
             LOGE("Failed to convert data");
             return -3;
         }
         
-        progressCallback(1.0f, "Conversão concluída!");
+        if (progressCallback) {
+            progressCallback(1.0f, "Conversão concluída!");
+        }
         LOGD("=== Conversion completed successfully ===");
         return 0;
         
@@ -74,119 +162,213 @@ int Iso2GodConverter::convertIsoToGod(
     }
 }
 
-IsoInfo* Iso2GodConverter::getIsoInfo(const std::string& isoPath) {
+std::unique_ptr<IsoSession> Iso2GodConverter::openSession(
+    const std::string& isoPath,
+    const std::string& metadataCacheDir
+) {
+    std::unique_ptr<IsoSource> source = IsoSource::open(isoPath, false);
+    if (!source) {
+        LOGE("Failed to open ISO: %s", isoPath.c_str());
+        return nullptr;
+    }
+    
+    std::unique_ptr<IsoSession> session(new IsoSession(std::move(source)));
+    if (!readIsoHeader(*session, IsoMetadataCache(metadataCacheDir))) {
+        LOGE("Failed to read ISO header");
+        return nullptr;
+    }
+    
+    LOGD("ISO session opened: %s (%s)", isoPath.c_str(), session->isFromCache() ? "cached" : "parsed");
+    return session;
+}
+
+IsoInfo* Iso2GodConverter::getIsoInfo(const std::string& isoPath, const std::string& metadataCacheDir) {
     LOGD("Getting ISO info: %s", isoPath.c_str());
     
     IsoInfo* info = new IsoInfo();
     
-    if (!readIsoHeader(isoPath, *info)) {
-        LOGE("Failed to read ISO header");
+    // Só stat(): listar uma biblioteca já vista não abre nenhum ISO
+    IsoMetadataCache metadataCache(metadataCacheDir);
+    if (metadataCache.lookup(isoPath, *info)) {
+        return info;
+    }
+    
+    // Só metadados: alguns KiB espalhados, lidos com pread sem mapear o ISO
+    std::unique_ptr<IsoSession> session = openSession(isoPath, metadataCacheDir);
+    if (!session) {
         delete info;
         return nullptr;
     }
     
+    *info = session->getInfo();
     return info;
 }
 
-void Iso2GodConverter::cancelConversion() {
-    LOGD("Cancellation requested");
-    cancelled = true;
+bool Iso2GodConverter::getTitleMetadata(const std::string& isoPath, TitleMetadata& metadata) {
+    LOGD("Getting title metadata: %s", isoPath.c_str());
+    
+    std::unique_ptr<IsoSession> session = openSession(isoPath);
+    return session && getTitleMetadata(*session, metadata);
 }
 
-bool Iso2GodConverter::readIsoHeader(const std::string& isoPath, IsoInfo& info) {
-    LOGD("Reading ISO header: %s", isoPath.c_str());
+bool Iso2GodConverter::getTitleMetadata(IsoSession& session, TitleMetadata& metadata) {
+    std::lock_guard<std::mutex> lock(session.xexMutex);
     
-    // Verificar se arquivo existe e é acessível
-    std::ifstream testFile(isoPath, std::ios::binary);
-    if (!testFile.is_open()) {
-        LOGE("Cannot open ISO file: %s", isoPath.c_str());
+    // Sessão vinda do cache: o XEX só é lido agora
+    if (!session.xexParsed && !parseDefaultXex(session)) {
         return false;
     }
-    testFile.close();
+    XexParser& xexParser = session.xex;
     
-    GDFParser gdfParser;
-    if (!gdfParser.parse(isoPath)) {
-        LOGE("Failed to parse GDF");
-        return false;
-    }
+    metadata.info = session.getInfo();
     
-    GDFEntry* xexEntry = gdfParser.findFile("default.xex");
-    if (!xexEntry) {
-        LOGE("default.xex not found in ISO");
-        return false;
-    }
+    XexExecutionInfo execInfo = xexParser.getExecutionInfo();
+    metadata.version = execInfo.version;
+    metadata.baseVersion = execInfo.baseVersion;
+    metadata.discNumber = execInfo.discNumber;
+    metadata.discCount = execInfo.discCount;
     
-    LOGD("Found default.xex at sector %u, size %u", xexEntry->sector, xexEntry->size);
+    xexParser.getSystemFlags(metadata.systemFlags);
+    xexParser.getGameRatings(metadata.gameRatings);
     
-    // Limitar tamanho do XEX para evitar alocar memória demais
-    if (xexEntry->size > 100 * 1024 * 1024) { // Máximo 100MB para XEX
-        LOGE("XEX file too large: %u bytes", xexEntry->size);
-        delete xexEntry;
-        return false;
+    XexSecurityInfo security;
+    if (xexParser.getSecurityInfo(security)) {
+        metadata.gameRegions = security.gameRegions;
+        metadata.allowedMediaTypes = security.allowedMediaTypes;
     }
     
-    std::ifstream iso(isoPath, std::ios::binary);
-    if (!iso.is_open()) {
-        LOGE("Failed to open ISO for reading XEX");
-        delete xexEntry;
-        return false;
+    std::vector<uint32_t> alternateIds;
+    xexParser.getAlternateTitleIds(alternateIds);
+    metadata.alternateTitleIds.clear();
+    for (uint32_t titleId : alternateIds) {
+        char hex[9];
+        snprintf(hex, sizeof(hex), "%08X", titleId);
+        metadata.alternateTitleIds.push_back(hex);
     }
     
-    // Usar ROOT_OFFSET do GDF (XGD2 = 0xFDA000)
-    const uint32_t ROOT_OFFSET = 0xFDA000;
-    const uint32_t SECTOR_SIZE = 2048;
+    // Opcionais: imagens com LZX ou sem XDBF ficam sem nome e ícone
+    if (!xexParser.getTitleName(metadata.titleName)) {
+        metadata.titleName.clear();
+    }
+    if (!xexParser.getTitleIcon(metadata.iconPng)) {
+        metadata.iconPng.clear();
+    }
     
-    uint64_t xexOffset = ROOT_OFFSET + (uint64_t)xexEntry->sector * SECTOR_SIZE;
-    LOGD("Reading XEX from offset: 0x%llX", xexOffset);
+    LOGD("Title metadata: '%s', icon %zu bytes, %llu XEX bytes read",
+         metadata.titleName.c_str(), metadata.iconPng.size(),
+         (unsigned long long)session.xexBytes->getBytesRead());
+    return true;
+}
+
+void Iso2GodConverter::cancelConversion() {
+    LOGD("Cancellation requested");
+    cancelToken.cancel();
+}
+
+bool Iso2GodConverter::readIsoHeader(IsoSession& session, const IsoMetadataCache& cache) {
+    IsoSource& source = session.getSource();
+    LOGD("Reading ISO header: %s", source.getPath().c_str());
+    
+    // Com o ISO aberto a consulta confere também as amostras do arquivo e
+    // traz a árvore GDF já indexada
+    if (cache.lookup(source, session.info, &session.gdf)) {
+        session.fromCache = true;
+        return true;
+    }
     
-    iso.seekg(xexOffset);
-    if (iso.fail()) {
-        LOGE("Failed to seek to XEX offset");
-        iso.close();
-        delete xexEntry;
+    if (!parseTitle(session)) {
         return false;
     }
     
-    uint8_t* xexData = new uint8_t[xexEntry->size];
-    iso.read((char*)xexData, xexEntry->size);
+    cache.store(source, session.info, session.gdf);
     
-    if (iso.gcount() != xexEntry->size) {
-        LOGE("Failed to read complete XEX data (read %ld of %u)", iso.gcount(), xexEntry->size);
-        delete[] xexData;
-        iso.close();
-        delete xexEntry;
+    LOGD("ISO Header read successfully");
+    return true;
+}
+
+bool Iso2GodConverter::parseTitle(IsoSession& session) {
+    IsoSource& source = session.getSource();
+    GDFParser& gdfParser = session.gdf;
+    IsoInfo& info = session.info;
+    
+    bool parsed;
+    {
+        ProfileScope scope(activeProfiler, ConversionStage::GdfParse);
+        parsed = gdfParser.parse(source);
+    }
+    if (!parsed) {
+        LOGE("Failed to parse GDF");
         return false;
     }
     
-    iso.close();
-    
-    XexParser xexParser;
-    if (!xexParser.parse(xexData, xexEntry->size)) {
-        LOGE("Failed to parse XEX");
-        delete[] xexData;
-        delete xexEntry;
+    std::lock_guard<std::mutex> lock(session.xexMutex);
+    if (!parseDefaultXex(session)) {
         return false;
     }
     
-    info.titleId = xexParser.getTitleIdString();
-    info.mediaId = xexParser.getMediaIdString();
-    info.gameName = xexEntry->name;
+    info.titleId = session.xex.getTitleIdString();
+    info.mediaId = session.xex.getMediaIdString();
+    info.gameName = gdfParser.getName(*gdfParser.findFile("default.xex"));
     info.platform = "Xbox 360";
+    info.sizeBytes = source.getSize();
     
-    // Obter tamanho do arquivo
-    std::ifstream isoFile(isoPath, std::ios::binary);
-    isoFile.seekg(0, std::ios::end);
-    info.sizeBytes = isoFile.tellg();
-    isoFile.close();
+    LOGD("ISO size: %llu bytes (%.2f GB)", (unsigned long long)info.sizeBytes, (double)info.sizeBytes / (1024*1024*1024));
     
-    LOGD("ISO size: %llu bytes (%.2f GB)", info.sizeBytes, (double)info.sizeBytes / (1024*1024*1024));
+    info.gamePartitionOffset = gdfParser.getRootOffset();
+    info.gamePartitionEnd = gdfParser.getGamePartitionEnd();
+    
+    if (!gdfParser.isComplete()) {
+        LOGE("GDF tree not fully parsed, game partition extends to end of ISO");
+        info.gamePartitionEnd = info.sizeBytes;
+    } else if (info.gamePartitionEnd > info.sizeBytes) {
+        LOGE("GDF references data past end of ISO (0x%llX > 0x%llX), image may be truncated",
+             (unsigned long long)info.gamePartitionEnd, (unsigned long long)info.sizeBytes);
+        info.gamePartitionEnd = info.sizeBytes;
+    }
+    if (info.gamePartitionOffset > info.gamePartitionEnd) {
+        info.gamePartitionOffset = info.gamePartitionEnd;
+    }
+    
+    LOGD("Game partition: 0x%llX-0x%llX", (unsigned long long)info.gamePartitionOffset,
+         (unsigned long long)info.gamePartitionEnd);
     
     info.volumeDescriptor = "XBOX360";
+    return true;
+}
+
+bool Iso2GodConverter::parseDefaultXex(IsoSession& session) {
+    const GDFParser& gdfParser = session.gdf;
+    
+    // Só o default.xex da raiz (não um homônimo em subpasta)
+    std::optional<GDFEntry> xexEntry = gdfParser.findFile("default.xex");
+    if (!xexEntry) {
+        LOGE("default.xex not found in ISO");
+        return false;
+    }
     
-    delete[] xexData;
-    delete xexEntry;
+    LOGD("Found default.xex at sector %u, size %u", xexEntry->sector, xexEntry->size);
     
-    LOGD("ISO Header read successfully");
+    // rootOffset detectado pelo GDF (XGD2 = 0xFDA000, XGD3 = 0x2080000)
+    uint64_t xexOffset = gdfParser.getRootOffset() + (uint64_t)xexEntry->sector * gdfParser.getSectorSize();
+    LOGD("Reading XEX from offset: 0x%llX", (unsigned long long)xexOffset);
+    
+    // Só o cabeçalho XEX2 e os registros que o parse usa são lidos (alguns
+    // KiB), não o executável inteiro
+    session.xexBytes.reset(new XexByteSource(session.getSource(), xexOffset, xexEntry->size));
+    bool xexParsed;
+    {
+        ProfileScope scope(activeProfiler, ConversionStage::XexParse);
+        xexParsed = session.xex.parse(*session.xexBytes);
+        scope.setBytes(session.xexBytes->getBytesRead());
+    }
+    
+    if (!xexParsed) {
+        LOGE("Failed to parse XEX (%u bytes at 0x%llX)", xexEntry->size, (unsigned long long)xexOffset);
+        return false;
+    }
+    
+    LOGD("XEX header read: %llu of %u bytes", (unsigned long long)session.xexBytes->getBytesRead(), xexEntry->size);
+    session.xexParsed = true;
     return true;
 }
 
@@ -221,174 +403,213 @@ bool Iso2GodConverter::createGodStructure(
 }
 
 bool Iso2GodConverter::convertData(
-    const std::string& isoPath,
+    IsoSource& source,
     const std::string& outputPath,
     const IsoInfo& info,
-    ProgressCallback progressCallback
+    ProgressCallback progressCallback,
+    const ConversionOptions& options
 ) {
     LOGD("Starting data conversion with hash tables");
     
-    std::ifstream isoFile(isoPath, std::ios::binary);
-    if (!isoFile.is_open()) {
-        LOGE("Failed to open ISO for reading");
-        return false;
-    }
-    
     std::string dataBasePath = outputPath + "/" + info.titleId + "/Content/0000000000000000/Data";
     
-    uint64_t totalBytes = info.sizeBytes;
+    // Faixa do ISO que vai para as partes Data
+    uint64_t startOffset = 0;
+    uint64_t endOffset = info.sizeBytes;
+    if (options.gamePartitionOnly) {
+        startOffset = info.gamePartitionOffset;
+        endOffset = info.gamePartitionEnd;
+    }
+    
+    uint64_t totalBytes = endOffset - startOffset;
     uint64_t processedBytes = 0;
-    uint32_t currentPart = 0;
-    uint32_t bytesInCurrentPart = 0;
-    uint32_t totalBlocks = 0;
+    
+    lastStats.skippedBytes = info.sizeBytes - totalBytes;
+    if (lastStats.skippedBytes > 0) {
+        LOGD("Converting game partition only: 0x%llX-0x%llX, skipping %llu MB",
+             (unsigned long long)startOffset, (unsigned long long)endOffset,
+             (unsigned long long)(lastStats.skippedBytes / 1024 / 1024));
+    }
     
     // Limitar tamanho máximo para evitar processamento infinito (15GB = tamanho máximo de DVD Xbox 360)
     const uint64_t MAX_ISO_SIZE = 15ULL * 1024ULL * 1024ULL * 1024ULL;
     if (totalBytes > MAX_ISO_SIZE) {
-        LOGE("ISO too large: %llu bytes (max: %llu)", totalBytes, MAX_ISO_SIZE);
-        isoFile.close();
+        LOGE("ISO too large: %llu bytes (max: %llu)", (unsigned long long)totalBytes, (unsigned long long)MAX_ISO_SIZE);
         return false;
     }
     
-    const uint32_t MAX_PART_SIZE = BLOCK_PER_PART * BLOCK_SIZE;
     const uint64_t expectedBlocks = (totalBytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
     
-    LOGD("Total bytes: %llu, Expected blocks: %llu", totalBytes, expectedBlocks);
-    
-    GodHashTables hashTables;
+    LOGD("Total bytes: %llu, Expected blocks: %llu", (unsigned long long)totalBytes, (unsigned long long)expectedBlocks);
     
-    uint8_t* block = new uint8_t[BLOCK_SIZE];
-    
-    char partName[256];
-    snprintf(partName, sizeof(partName), "%s%04d", dataBasePath.c_str(), currentPart);
-    
-    std::ofstream dataFile(partName, std::ios::binary);
-    if (!dataFile.is_open()) {
-        LOGE("Failed to create Data file: %s", partName);
-        delete[] block;
-        isoFile.close();
-        return false;
+    // Leitura e SHA-1 rodam no pipeline; aqui fica só a escrita, em ordem
+    uint32_t threadCount = options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
     }
     
-    LOGD("Processing ISO blocks...");
+    // Os bytes do ISO vão para as partes sem alteração: no modo KernelCopy
+    // o kernel copia e o pipeline só lê para calcular os hashes
+    PayloadCopier payloadCopier(source, options.payloadCopyMode);
     
-    uint32_t consecutiveFailures = 0;
-    const uint32_t MAX_CONSECUTIVE_FAILURES = 10;
+    // Blocos de dados e hash tables no layout final, numa passada só
+    GodLayoutWriter layoutWriter(dataBasePath, payloadCopier);
     
-    while (processedBytes < totalBytes && !cancelled) {
-        // Verificar se ultrapassou o número esperado de blocos (proteção contra loop infinito)
-        if (totalBlocks > expectedBlocks + 100) {
-            LOGE("Block count exceeded expected (%u > %llu)", totalBlocks, expectedBlocks);
-            break;
-        }
-        
-        memset(block, 0, BLOCK_SIZE);
+    // Checkpoint a cada parte concluída; na retomada, as partes do journal
+    // que ainda conferem no disco não são convertidas de novo
+    ConversionJournal journal(outputPath + "/" + info.titleId + ".journal");
+    bool journalReady = journal.begin(source, startOffset, endOffset);
+    uint32_t resumedParts = 0;
+    
+    if (journalReady && options.resume && journal.load()) {
+        const uint64_t partBytes = (uint64_t)GodLayoutWriter::BLOCK_PER_PART * BLOCK_SIZE;
         
-        size_t toRead = std::min((uint64_t)BLOCK_SIZE, totalBytes - processedBytes);
-        isoFile.read((char*)block, toRead);
-        size_t actualRead = isoFile.gcount();
+        const uint32_t journaledParts = journal.getCompletedParts();
         
-        if (actualRead == 0) {
-            consecutiveFailures++;
-            if (consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
-                LOGE("Too many consecutive read failures at offset %llu", processedBytes);
-                break;
-            }
-            if (processedBytes < totalBytes) {
-                LOGE("Failed to read from ISO at offset %llu (attempt %u)", processedBytes, consecutiveFailures);
-                continue;
-            } else {
-                break;
-            }
+        reportPhase(ConversionPhase::Verifying, 0.15f, "Verificando partes já convertidas...", progressCallback);
+        while (resumedParts < journaledParts && !isCancelled() &&
+               (uint64_t)(resumedParts + 1) * partBytes < totalBytes &&
+               layoutWriter.verifyPart(resumedParts, journal.getPartDigest(resumedParts))) {
+            resumedParts++;
         }
         
-        consecutiveFailures = 0;
-        
-        uint8_t hash[20];
-        HashUtils::calculateSHA1(block, BLOCK_SIZE, hash);
-        hashTables.addBlockHash(hash);
+        // Sem truncar o journal: as partes não conferidas ainda valem
+        if (isCancelled()) {
+            LOGD("Conversion cancelled while verifying journaled parts");
+            return false;
+        }
+        journal.truncate(resumedParts);
         
-        if (!dataFile.write((char*)block, BLOCK_SIZE)) {
-            LOGE("Failed to write block %u to data file", totalBlocks);
-            delete[] block;
-            dataFile.close();
-            isoFile.close();
+        LOGD("Resuming after %u of %u journaled parts", resumedParts, journaledParts);
+    } else if (!options.resume) {
+        journal.remove();
+    }
+    
+    if (journalReady) {
+        layoutWriter.setPartCompleteCallback([&journal](uint32_t partIndex, const uint8_t* masterDigest) {
+            // Falha no journal não interrompe a conversão, só a retomada
+            journal.addPart(partIndex, masterDigest);
+        });
+    } else {
+        LOGE("Conversion journal unavailable, this conversion cannot be resumed");
+    }
+    
+    layoutWriter.resumeAfter(resumedParts);
+    lastStats.resumedParts = resumedParts;
+    
+    uint64_t resumeOffset = startOffset + (uint64_t)resumedParts * GodLayoutWriter::BLOCK_PER_PART * BLOCK_SIZE;
+    processedBytes = resumeOffset - startOffset;
+    
+    DataPipeline pipeline(source, resumeOffset, endOffset, threadCount, options.readChunkSize, activeProfiler);
+    if (!pipeline.start()) {
+        LOGE("Failed to open ISO for reading");
+        return false;
+    }
+    
+    LOGD("Processing ISO blocks (%u hash threads, %u KiB reads, SHA-1 batch backend: %s, payload: %s)...",
+         pipeline.getHashThreadCount(), pipeline.getChunkSize() / 1024,
+         HashUtils::getSha1BatchBackendName(), payloadCopier.getMethodName());
+    
+    progressTracker.beginCopy(totalBytes, expectedBlocks, processedBytes, layoutWriter.getBlockCount());
+    
+    uint32_t blocksSinceProgress = 0;
+    PipelineChunk* chunk;
+    
+    while (!isCancelled() && pipeline.next(chunk)) {
+        bool written;
+        {
+            ProfileScope scope(activeProfiler, ConversionStage::Write, chunk->dataBytes, chunk->blockCount);
+            written = layoutWriter.writeBlocks(chunk->hashes, chunk->zeroFlags, chunk->data, chunk->offset,
+                                               chunk->blockCount, chunk->dataBytes);
+        }
+        if (!written) {
+            pipeline.release(chunk);
             return false;
         }
         
-        processedBytes += actualRead;
-        bytesInCurrentPart += BLOCK_SIZE;
-        totalBlocks++;
+        blocksSinceProgress += chunk->blockCount;
+        processedBytes += chunk->dataBytes;
+        pipeline.release(chunk);
         
-        if (bytesInCurrentPart >= MAX_PART_SIZE && processedBytes < totalBytes) {
-            dataFile.close();
-            currentPart++;
-            bytesInCurrentPart = 0;
-            
-            snprintf(partName, sizeof(partName), "%s%04d", dataBasePath.c_str(), currentPart);
-            dataFile.open(partName, std::ios::binary);
-            
-            if (!dataFile.is_open()) {
-                LOGE("Failed to create Data file: %s", partName);
-                delete[] block;
-                isoFile.close();
-                return false;
-            }
-            
-            LOGD("Created Data file part %u: %s", currentPart, partName);
-        }
+        // Foto atômica a cada lote; o texto e o callback só a cada 1000
+        // blocos e só se houver callback
+        float progress = 0.15f + (0.75f * ((float)processedBytes / (float)totalBytes));
+        progressTracker.update(processedBytes, layoutWriter.getBlockCount(), progress);
         
-        if (totalBlocks % 1000 == 0 || processedBytes >= totalBytes) {
-            float progress = 0.15f + (0.75f * ((float)processedBytes / (float)totalBytes));
+        if (progressCallback && (blocksSinceProgress >= 1000 || processedBytes >= totalBytes)) {
+            blocksSinceProgress = 0;
+            
             char status[128];
-            snprintf(status, sizeof(status), "Bloco %u de %llu (%.1f%%)",
-                     totalBlocks, expectedBlocks,
+            snprintf(status, sizeof(status), "Bloco %llu de %llu (%.1f%%)",
+                     (unsigned long long)layoutWriter.getBlockCount(), (unsigned long long)expectedBlocks,
                      (float)processedBytes * 100.0f / (float)totalBytes);
             progressCallback(progress, status);
             
-            LOGD("Progress: %u/%llu blocks, %llu/%llu bytes (%.1f%%)",
-                 totalBlocks, expectedBlocks, processedBytes, totalBytes,
+            LOGD("Progress: %llu/%llu blocks, %llu/%llu bytes (%.1f%%)",
+                 (unsigned long long)layoutWriter.getBlockCount(), (unsigned long long)expectedBlocks,
+                 (unsigned long long)processedBytes, (unsigned long long)totalBytes,
                  (float)processedBytes * 100.0f / (float)totalBytes);
         }
     }
     
-    delete[] block;
-    dataFile.close();
-    isoFile.close();
+    pipeline.stop();
     
-    if (cancelled) {
-        LOGD("Conversion cancelled by user");
-        return false;
+    PipelineReadStats readStats = pipeline.getReadStats();
+    lastStats.readBytes = readStats.bytesRead;
+    lastStats.readCalls = readStats.readCalls;
+    lastStats.readSeconds = readStats.readNanos / 1e9;
+    lastStats.elapsedSeconds = readStats.wallNanos / 1e9;
+    if (readStats.wallNanos > 0) {
+        lastStats.readThroughputMBps = (readStats.bytesRead / (1024.0 * 1024.0)) / lastStats.elapsedSeconds;
     }
     
-    LOGD("Data conversion completed");
-    LOGD("  Total blocks: %u", totalBlocks);
-    LOGD("  Data files created: %u", currentPart + 1);
+    LOGD("Read throughput: %.1f MB/s (%llu MB in %.2fs, %llu reads, %.2fs in pread)",
+         lastStats.readThroughputMBps, (unsigned long long)(readStats.bytesRead / 1024 / 1024),
+         lastStats.elapsedSeconds, (unsigned long long)readStats.readCalls, lastStats.readSeconds);
     
-    progressCallback(0.9f, "Finalizando hash tables...");
+    lastStats.kernelCopiedBytes = payloadCopier.getKernelCopiedBytes();
+    lastStats.writtenBytes = payloadCopier.getWrittenBytes();
+    LOGD("Payload output: %llu MB copied by the kernel (%s), %llu MB written from memory",
+         (unsigned long long)(lastStats.kernelCopiedBytes / 1024 / 1024), payloadCopier.getMethodName(),
+         (unsigned long long)(lastStats.writtenBytes / 1024 / 1024));
     
-    hashTables.finalize();
+    lastStats.zeroBlocks = layoutWriter.getZeroBlockCount();
+    LOGD("Zero blocks: %llu of %llu (%llu MB not hashed nor written)",
+         (unsigned long long)lastStats.zeroBlocks, (unsigned long long)layoutWriter.getBlockCount(),
+         (unsigned long long)(lastStats.zeroBlocks * BLOCK_SIZE / 1024 / 1024));
     
-    progressCallback(0.95f, "Escrevendo hash tables...");
+    if (isCancelled()) {
+        LOGD("Conversion cancelled by user");
+        return false;
+    }
     
-    if (!writeHashTables(outputPath, info)) {
-        LOGE("Failed to write hash tables");
+    // Leitura que falhou (ou faixa incompleta): sem finish() e com o
+    // journal mantido, para não gerar um GOD truncado com hash tables
+    // válidas e a retomada continuar da última parte concluída
+    if (pipeline.hasFailed() || processedBytes != totalBytes) {
+        LOGE("ISO data ended early: %llu of %llu bytes converted",
+             (unsigned long long)processedBytes, (unsigned long long)totalBytes);
         return false;
     }
     
-    return true;
-}
-
-bool Iso2GodConverter::writeHashTables(
-    const std::string& outputPath,
-    const IsoInfo& info
-) {
-    LOGD("Writing hash tables");
+    reportPhase(ConversionPhase::Finishing, 0.9f, "Escrevendo hash tables...", progressCallback);
     
-    std::string data0000Path = outputPath + "/" + info.titleId + "/Content/0000000000000000/Data0000";
+    // Última parte e encadeamento das MHTs (só os blocos de hash)
+    bool finished;
+    {
+        ProfileScope scope(activeProfiler, ConversionStage::Finish);
+        finished = layoutWriter.finish();
+    }
+    if (!finished) {
+        LOGE("Failed to write hash tables");
+        return false;
+    }
     
-    LOGD("TODO: Write hash tables to beginning of Data0000");
-    LOGD("  File: %s", data0000Path.c_str());
+    journal.remove();
+    
+    LOGD("Data conversion completed");
+    LOGD("  Total blocks: %llu", (unsigned long long)layoutWriter.getBlockCount());
+    LOGD("  Data files created: %u", layoutWriter.getPartCount());
     
     return true;
 }
@@ -1,9 +1,18 @@
 #ifndef ISO2GOD_CONVERTER_H
 #define ISO2GOD_CONVERTER_H
 
+#include "cancellation_token.h"
+#include "conversion_profiler.h"
+#include "conversion_progress.h"
+#include "payload_copier.h"
 #include <string>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <vector>
+
+class IsoMetadataCache;
+class IsoSession;
 
 struct IsoInfo {
     std::string gameName;
@@ -12,10 +21,85 @@ struct IsoInfo {
     std::string platform;
     uint64_t sizeBytes;
     std::string volumeDescriptor;
+    
+    // Partição do jogo: do rootOffset do GDF até o fim do último setor
+    // referenciado (o ISO inteiro se a árvore GDF não foi lida por completo)
+    uint64_t gamePartitionOffset = 0;
+    uint64_t gamePartitionEnd = 0;
 };
 
+// Metadados completos do título para a tela de detalhes: o IsoInfo mais o
+// que o cabeçalho do default.xex e o XDBF embutido nele trazem
+struct TitleMetadata {
+    IsoInfo info;
+    std::string titleName;            // do XDBF; vazio se indisponível
+    std::vector<uint8_t> iconPng;     // do XDBF; vazio se indisponível
+    uint32_t version = 0;
+    uint32_t baseVersion = 0;
+    uint32_t discNumber = 0;
+    uint32_t discCount = 0;
+    uint32_t systemFlags = 0;
+    uint32_t gameRegions = 0;
+    uint32_t allowedMediaTypes = 0;
+    std::vector<uint8_t> gameRatings; // um byte por órgão de classificação (0xFF = sem)
+    std::vector<std::string> alternateTitleIds;
+};
+
+// Pode ser vazio: o andamento fica então só em getProgress()
 using ProgressCallback = std::function<void(float progress, const std::string& status)>;
 
+struct ConversionOptions {
+    // Threads de hashing (0 = automático, 1 = tudo na thread chamadora)
+    uint32_t threadCount = 0;
+    
+    // Tamanho de cada leitura do ISO em bytes (0 = padrão de 4 MiB,
+    // limitado a 1-16 MiB)
+    uint32_t readChunkSize = 0;
+    
+    // Cópia dos bytes do ISO para as partes Data (KernelCopy cai para
+    // escrita normal quando o kernel/sistema de arquivos não suporta)
+    PayloadCopyMode payloadCopyMode = PayloadCopyMode::KernelCopy;
+    
+    // Converter só a partição do jogo (pula a partição de vídeo/sistema
+    // do XGD e o padding depois do último setor usado)
+    bool gamePartitionOnly = false;
+    
+    // Retomar uma conversão interrompida: as partes registradas no
+    // journal ao lado da saída são conferidas e a conversão continua da
+    // primeira parte não concluída (o journal é gravado sempre)
+    bool resume = false;
+    
+    // Contadores e timers por etapa (getProfiler()); desligado o custo é
+    // só um teste de ponteiro nos pontos instrumentados
+    bool collectMetrics = false;
+    
+    // Se não vazio, grava no fim um trace do Chrome (trace-event JSON)
+    // com cada leitura, sub-lote de hashing, escrita e espera (implica
+    // collectMetrics)
+    std::string traceFilePath;
+    
+    // Pasta do cache de metadados (IsoMetadataCache); vazio = sem cache
+    std::string metadataCacheDir;
+    
+    // Token de quem chama (job assíncrono, lote): deve durar até o fim da
+    // conversão. Sem ele só cancelConversion() interrompe a conversão
+    const CancellationToken* cancelToken = nullptr;
+};
+
+// Números da última conversão
+struct ConversionStats {
+    uint64_t readBytes = 0;
+    uint64_t readCalls = 0;
+    double readSeconds = 0.0;       // tempo dentro de pread
+    double elapsedSeconds = 0.0;    // duração da leitura do ISO inteiro
+    double readThroughputMBps = 0.0;
+    uint64_t kernelCopiedBytes = 0;  // copy_file_range/sendfile
+    uint64_t writtenBytes = 0;       // escritos a partir da memória
+    uint64_t skippedBytes = 0;       // bytes do ISO fora da faixa convertida
+    uint64_t zeroBlocks = 0;         // blocos zerados: sem SHA-1 e sem escrita
+    uint32_t resumedParts = 0;       // partes reaproveitadas de uma conversão interrompida
+};
+
 class Iso2GodConverter {
 public:
     Iso2GodConverter();
@@ -24,30 +108,95 @@ public:
     int convertIsoToGod(
         const std::string& isoPath,
         const std::string& outputPath,
-        ProgressCallback progressCallback
+        ProgressCallback progressCallback,
+        const ConversionOptions& options = ConversionOptions()
+    );
+    
+    // Conversão de uma sessão já aberta: sem abrir o ISO nem ler GDF/XEX
+    // de novo (options.metadataCacheDir não é usado)
+    int convertIsoToGod(
+        IsoSession& session,
+        const std::string& outputPath,
+        ProgressCallback progressCallback,
+        const ConversionOptions& options = ConversionOptions()
     );
     
-    IsoInfo* getIsoInfo(const std::string& isoPath);
+    // Abre o ISO e lê os metadados uma vez (pelo cache, se a pasta não for
+    // vazia), para getTitleMetadata e convertIsoToGod reaproveitarem.
+    // Sempre com pread, sem mmap: a sessão alimenta a cópia dos dados, e
+    // ler uma página mapeada depois de um erro de mídia, ISO truncado ou
+    // cartão removido mata o processo com SIGBUS em vez de falhar a
+    // leitura. nullptr se o ISO não puder ser aberto ou não for um título
+    // válido.
+    std::unique_ptr<IsoSession> openSession(
+        const std::string& isoPath,
+        const std::string& metadataCacheDir = std::string()
+    );
     
+    // Com metadataCacheDir, um ISO já visto (mesmo caminho, tamanho e
+    // mtime) sai do cache sem abrir o arquivo
+    IsoInfo* getIsoInfo(const std::string& isoPath, const std::string& metadataCacheDir = std::string());
+    
+    // Tudo numa passada: GDF, cabeçalho do XEX e, se o título tiver, nome
+    // e ícone do XDBF (só os trechos da imagem PE que eles ocupam)
+    bool getTitleMetadata(const std::string& isoPath, TitleMetadata& metadata);
+    bool getTitleMetadata(IsoSession& session, TitleMetadata& metadata);
+    
+    // Interrompe a conversão em andamento nesta instância (de qualquer
+    // thread). Cada instância converte um ISO por vez; para conversões
+    // simultâneas, uma instância por conversão
     void cancelConversion();
     
+    const ConversionStats& getLastConversionStats() const { return lastStats; }
+    
+    // Métricas por etapa da conversão em andamento ou da última (só com
+    // collectMetrics ou traceFilePath)
+    const ConversionProfiler& getProfiler() const { return profiler; }
+    
+    // Andamento da conversão em andamento ou da última; pode ser chamado
+    // de qualquer thread sem atrasar a conversão
+    ConversionProgress getProgress() const { return progressTracker.snapshot(); }
+    
 private:
-    bool cancelled;
+    CancellationToken cancelToken;               // cancelConversion()
+    const CancellationToken* externalCancelToken; // options.cancelToken da conversão atual
+    ConversionStats lastStats;
+    ConversionProfiler profiler;
+    ConversionProfiler* activeProfiler;   // nullptr com a coleta desligada
+    ConversionProgressTracker progressTracker;
     
     static const uint32_t BLOCK_SIZE = 4096;
-    static const uint32_t SHT_PER_MHT = 203;
-    static const uint32_t BLOCK_PER_SHT = 204;
-    static const uint32_t BLOCK_PER_PART = 41412;
     
-    bool readIsoHeader(const std::string& isoPath, IsoInfo& info);
+    int startConversion(
+        const std::string& isoPath,
+        IsoSession* session,
+        const std::string& outputPath,
+        ProgressCallback progressCallback,
+        const ConversionOptions& options
+    );
+    int runConversion(
+        const std::string& isoPath,
+        IsoSession* session,
+        const std::string& outputPath,
+        ProgressCallback progressCallback,
+        const ConversionOptions& options
+    );
+    bool isCancelled() const {
+        return cancelToken.isCancelled() || (externalCancelToken && externalCancelToken->isCancelled());
+    }
+    void reportPhase(ConversionPhase phase, float progress, const char* status,
+                     const ProgressCallback& progressCallback);
+    bool readIsoHeader(IsoSession& session, const IsoMetadataCache& cache);
+    bool parseTitle(IsoSession& session);
+    bool parseDefaultXex(IsoSession& session);
     bool createGodStructure(const std::string& outputPath, const IsoInfo& info);
     bool convertData(
-        const std::string& isoPath,
+        IsoSource& source,
         const std::string& outputPath,
         const IsoInfo& info,
-        ProgressCallback progressCallback
+        ProgressCallback progressCallback,
+        const ConversionOptions& options
     );
-    bool writeHashTables(const std::string& outputPath, const IsoInfo& info);
 };
 
 #endif // ISO2GOD_CONVERTER_H
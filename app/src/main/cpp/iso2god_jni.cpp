@@ -1,14 +1,128 @@
 #include <jni.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <android/log.h>
+#include <vector>
 #include "iso2god_converter.h"
+#include "iso_session.h"
+#include "cancellation_token.h"
+#include "conversion_job.h"
+#include "batch_converter.h"
+#include "library_scanner.h"
+#include "native_log.h"
 
 #define LOG_TAG "Iso2God-JNI"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// Referência global ao conversor
-static Iso2GodConverter* gConverter = nullptr;
+// Conversão síncrona (nativeSessionConvert) com conversor e token
+// próprios: duas chamadas simultâneas não dividem estado e
+// nativeCancelConversion alcança todas
+struct SyncConversion {
+    Iso2GodConverter converter;
+    CancellationToken cancelToken;
+};
+
+// Estado nativo de uma instância Kotlin de Iso2GodConverter, criado por
+// nativeCreate e achado pelo handle em cada chamada: as conversões
+// síncronas, as sessões, os jobs assíncronos, o lote e a varredura. Nada
+// é compartilhado entre instâncias, então conversões de instâncias (ou
+// jobs) diferentes rodam em paralelo. Tudo o que pode ser liberado
+// enquanto outra thread usa fica em shared_ptr, copiado sob o mutex.
+struct NativeConverter {
+    std::mutex mutex;
+    std::condition_variable idleCondition;
+    uint32_t activeCalls = 0;                              // NativeCall em andamento
+    std::vector<std::shared_ptr<SyncConversion>> conversions;
+    std::shared_ptr<SyncConversion> lastConversion;        // nativeGetConversionMetrics
+    std::map<jlong, std::shared_ptr<IsoSession>> sessions;
+    jlong nextSessionHandle = 1;
+    std::map<jint, std::shared_ptr<ConversionJob>> jobs;
+    jint nextJobId = 1;
+    std::shared_ptr<BatchConverter> batch;
+    std::shared_ptr<LibraryScanner> scanner;
+};
+
+// Instâncias vivas por handle. Um handle já destruído (ou usado por uma
+// chamada que correu com close()) não acha nada, em vez de apontar para
+// memória liberada
+static std::mutex registryMutex;
+static std::map<jlong, std::shared_ptr<NativeConverter>> registry;
+static jlong nextConverterHandle = 1;
+
+// Referência à instância durante uma chamada JNI. nativeDestroy tira a
+// instância do registro, cancela o que estiver rodando e espera as
+// chamadas em andamento saírem antes de liberar o estado
+class NativeCall {
+public:
+    explicit NativeCall(jlong handle) {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto it = registry.find(handle);
+            if (it == registry.end()) {
+                LOGE("Invalid native converter handle: %lld", (long long)handle);
+                return;
+            }
+            native = it->second;
+        }
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->activeCalls++;
+    }
+    
+    ~NativeCall() {
+        if (!native) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(native->mutex);
+        if (--native->activeCalls == 0) {
+            native->idleCondition.notify_all();
+        }
+    }
+    
+    NativeCall(const NativeCall&) = delete;
+    NativeCall& operator=(const NativeCall&) = delete;
+    
+    explicit operator bool() const { return native != nullptr; }
+    NativeConverter& operator*() const { return *native; }
+    NativeConverter* operator->() const { return native.get(); }
+    
+private:
+    std::shared_ptr<NativeConverter> native;
+};
+
+static std::shared_ptr<IsoSession> findSession(NativeConverter& native, jlong handle) {
+    std::lock_guard<std::mutex> lock(native.mutex);
+    auto it = native.sessions.find(handle);
+    if (it == native.sessions.end()) {
+        LOGE("Invalid ISO session handle: %lld", (long long)handle);
+        return nullptr;
+    }
+    return it->second;
+}
+
+static std::shared_ptr<ConversionJob> findJob(NativeConverter& native, jint jobId) {
+    std::lock_guard<std::mutex> lock(native.mutex);
+    auto it = native.jobs.find(jobId);
+    if (it == native.jobs.end()) {
+        LOGE("Invalid conversion job id: %d", jobId);
+        return nullptr;
+    }
+    return it->second;
+}
+
+static std::shared_ptr<BatchConverter> getBatch(NativeConverter& native) {
+    std::lock_guard<std::mutex> lock(native.mutex);
+    return native.batch;
+}
+
+static std::shared_ptr<LibraryScanner> getScanner(NativeConverter& native) {
+    std::lock_guard<std::mutex> lock(native.mutex);
+    return native.scanner;
+}
 
 // Helper para converter jstring para std::string
 std::string jstringToString(JNIEnv* env, jstring jStr) {
@@ -26,27 +140,379 @@ jstring stringToJstring(JNIEnv* env, const std::string& str) {
     return env->NewStringUTF(str.c_str());
 }
 
+// Cria um com.x360games.archivedownloader.utils.IsoInfo (nullptr se a
+// classe ou o construtor não forem encontrados)
+static jobject newIsoInfoObject(JNIEnv* env, const IsoInfo& info) {
+    jclass isoInfoClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/IsoInfo"
+    );
+    
+    if (!isoInfoClass) {
+        LOGE("Failed to find IsoInfo class");
+        return nullptr;
+    }
+    
+    jmethodID constructor = env->GetMethodID(
+        isoInfoClass,
+        "<init>",
+        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JLjava/lang/String;)V"
+    );
+    
+    if (!constructor) {
+        LOGE("Failed to find IsoInfo constructor");
+        env->DeleteLocalRef(isoInfoClass);
+        return nullptr;
+    }
+    
+    // Converter strings C++ para jstring
+    jstring jGameName = stringToJstring(env, info.gameName);
+    jstring jTitleId = stringToJstring(env, info.titleId);
+    jstring jMediaId = stringToJstring(env, info.mediaId);
+    jstring jPlatform = stringToJstring(env, info.platform);
+    jstring jVolumeDescriptor = stringToJstring(env, info.volumeDescriptor);
+    jlong jSizeBytes = (jlong)info.sizeBytes;
+    
+    // Criar objeto
+    jobject isoInfoObj = env->NewObject(
+        isoInfoClass,
+        constructor,
+        jGameName,
+        jTitleId,
+        jMediaId,
+        jPlatform,
+        jSizeBytes,
+        jVolumeDescriptor
+    );
+    
+    // Limpar referências locais
+    env->DeleteLocalRef(jGameName);
+    env->DeleteLocalRef(jTitleId);
+    env->DeleteLocalRef(jMediaId);
+    env->DeleteLocalRef(jPlatform);
+    env->DeleteLocalRef(jVolumeDescriptor);
+    env->DeleteLocalRef(isoInfoClass);
+    
+    return isoInfoObj;
+}
+
+static jobject newConversionProgressObject(JNIEnv* env, const ConversionProgress& progress) {
+    jclass progressClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/ConversionProgress"
+    );
+    if (!progressClass) {
+        LOGE("Failed to find ConversionProgress class");
+        return nullptr;
+    }
+    
+    jmethodID constructor = env->GetMethodID(
+        progressClass,
+        "<init>",
+        "(IFJJJJDDDI)V"
+    );
+    if (!constructor) {
+        LOGE("Failed to find ConversionProgress constructor");
+        env->DeleteLocalRef(progressClass);
+        return nullptr;
+    }
+    
+    jobject progressObj = env->NewObject(
+        progressClass,
+        constructor,
+        (jint)progress.phase,
+        (jfloat)progress.progress,
+        (jlong)progress.bytesDone,
+        (jlong)progress.totalBytes,
+        (jlong)progress.blocksDone,
+        (jlong)progress.totalBlocks,
+        (jdouble)progress.elapsedSeconds,
+        (jdouble)progress.throughputMBps,
+        (jdouble)progress.etaSeconds,
+        (jint)progress.result
+    );
+    env->DeleteLocalRef(progressClass);
+    return progressObj;
+}
+
+static jbyteArray newByteArray(JNIEnv* env, const std::vector<uint8_t>& bytes) {
+    jbyteArray array = env->NewByteArray((jsize)bytes.size());
+    if (array && !bytes.empty()) {
+        env->SetByteArrayRegion(array, 0, (jsize)bytes.size(), (const jbyte*)bytes.data());
+    }
+    return array;
+}
+
+static jobject newTitleMetadataObject(JNIEnv* env, const TitleMetadata& metadata) {
+    jclass metadataClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/TitleMetadata"
+    );
+    if (!metadataClass) {
+        LOGE("Failed to find TitleMetadata class");
+        return nullptr;
+    }
+    
+    jmethodID constructor = env->GetMethodID(
+        metadataClass,
+        "<init>",
+        "(Lcom/x360games/archivedownloader/utils/IsoInfo;Ljava/lang/String;[BIIIIIII[B[Ljava/lang/String;)V"
+    );
+    if (!constructor) {
+        LOGE("Failed to find TitleMetadata constructor");
+        env->DeleteLocalRef(metadataClass);
+        return nullptr;
+    }
+    
+    jobject jInfo = newIsoInfoObject(env, metadata.info);
+    jstring jTitleName = stringToJstring(env, metadata.titleName);
+    jbyteArray jIcon = metadata.iconPng.empty() ? nullptr : newByteArray(env, metadata.iconPng);
+    jbyteArray jRatings = newByteArray(env, metadata.gameRatings);
+    
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray jAlternateIds = env->NewObjectArray((jsize)metadata.alternateTitleIds.size(), stringClass, nullptr);
+    for (size_t i = 0; i < metadata.alternateTitleIds.size(); i++) {
+        jstring jId = stringToJstring(env, metadata.alternateTitleIds[i]);
+        env->SetObjectArrayElement(jAlternateIds, (jsize)i, jId);
+        env->DeleteLocalRef(jId);
+    }
+    
+    jobject metadataObj = env->NewObject(
+        metadataClass,
+        constructor,
+        jInfo,
+        jTitleName,
+        jIcon,
+        (jint)metadata.version,
+        (jint)metadata.baseVersion,
+        (jint)metadata.discNumber,
+        (jint)metadata.discCount,
+        (jint)metadata.systemFlags,
+        (jint)metadata.gameRegions,
+        (jint)metadata.allowedMediaTypes,
+        jRatings,
+        jAlternateIds
+    );
+    
+    env->DeleteLocalRef(jAlternateIds);
+    env->DeleteLocalRef(stringClass);
+    env->DeleteLocalRef(jRatings);
+    if (jIcon) {
+        env->DeleteLocalRef(jIcon);
+    }
+    env->DeleteLocalRef(jTitleName);
+    if (jInfo) {
+        env->DeleteLocalRef(jInfo);
+    }
+    env->DeleteLocalRef(metadataClass);
+    
+    return metadataObj;
+}
+
+// Cria um ConversionStageMetrics[] com uma entrada por etapa do profiler
+static jobjectArray newStageMetricsArray(JNIEnv* env, const ConversionProfiler& profiler) {
+    jclass metricsClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/ConversionStageMetrics"
+    );
+    if (!metricsClass) {
+        LOGE("Failed to find ConversionStageMetrics class");
+        return nullptr;
+    }
+    
+    jmethodID constructor = env->GetMethodID(
+        metricsClass,
+        "<init>",
+        "(Ljava/lang/String;JJJJJJJ[J)V"
+    );
+    if (!constructor) {
+        LOGE("Failed to find ConversionStageMetrics constructor");
+        env->DeleteLocalRef(metricsClass);
+        return nullptr;
+    }
+    
+    // Uma entrada por etapa, na ordem de ConversionStage; pode ser chamada
+    // durante a conversão (os contadores são atômicos)
+    const jsize stageCount = (jsize)ConversionStage::Count;
+    jobjectArray result = env->NewObjectArray(stageCount, metricsClass, nullptr);
+    
+    for (jsize i = 0; i < stageCount; i++) {
+        ConversionStage stage = (ConversionStage)i;
+        StageMetrics metrics = profiler.getStageMetrics(stage);
+        
+        jlong histogram[StageMetrics::HISTOGRAM_BUCKETS];
+        for (uint32_t bucket = 0; bucket < StageMetrics::HISTOGRAM_BUCKETS; bucket++) {
+            histogram[bucket] = (jlong)metrics.histogram[bucket];
+        }
+        jlongArray jHistogram = env->NewLongArray(StageMetrics::HISTOGRAM_BUCKETS);
+        env->SetLongArrayRegion(jHistogram, 0, StageMetrics::HISTOGRAM_BUCKETS, histogram);
+        
+        jstring jName = stringToJstring(env, ConversionProfiler::getStageName(stage));
+        jobject metricsObj = env->NewObject(
+            metricsClass,
+            constructor,
+            jName,
+            (jlong)metrics.ops,
+            (jlong)metrics.bytes,
+            (jlong)metrics.blocks,
+            (jlong)metrics.totalNanos,
+            (jlong)metrics.maxNanos,
+            (jlong)metrics.stalls,
+            (jlong)metrics.stallNanos,
+            jHistogram
+        );
+        env->SetObjectArrayElement(result, i, metricsObj);
+        
+        env->DeleteLocalRef(metricsObj);
+        env->DeleteLocalRef(jName);
+        env->DeleteLocalRef(jHistogram);
+    }
+    
+    env->DeleteLocalRef(metricsClass);
+    return result;
+}
+
 extern "C" {
 
-JNIEXPORT jint JNICALL
-Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertIso(
+JNIEXPORT jlong JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeCreate(
+    JNIEnv* env,
+    jobject thiz
+) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    jlong handle = nextConverterHandle++;
+    registry[handle] = std::make_shared<NativeConverter>();
+    LOGD("nativeCreate: %lld", (long long)handle);
+    return handle;
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeDestroy(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    std::shared_ptr<NativeConverter> native;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = registry.find(jConverter);
+        if (it == registry.end()) {
+            return;
+        }
+        native = std::move(it->second);
+        registry.erase(it);
+    }
+    LOGD("nativeDestroy: %lld", (long long)jConverter);
+    
+    // Nenhuma chamada nova acha a instância; as em andamento são
+    // canceladas e esperadas (as que esperam andamento saem no timeout)
+    {
+        std::unique_lock<std::mutex> lock(native->mutex);
+        for (const std::shared_ptr<SyncConversion>& conversion : native->conversions) {
+            conversion->cancelToken.cancel();
+        }
+        for (auto& entry : native->jobs) {
+            entry.second->cancel();
+        }
+        if (native->batch) {
+            native->batch->cancelAll();
+        }
+        if (native->scanner) {
+            native->scanner->cancel();
+        }
+        native->idleCondition.wait(lock, [&native] { return native->activeCalls == 0; });
+    }
+    
+    // Jobs, lote e varredura são esperados pelos destrutores
+    native.reset();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeSessionOpen(
     JNIEnv* env,
     jobject thiz,
+    jlong jConverter,
     jstring jIsoPath,
+    jstring jMetadataCacheDir
+) {
+    LOGD("nativeSessionOpen called");
+    
+    std::string isoPath = jstringToString(env, jIsoPath);
+    std::string metadataCacheDir = jstringToString(env, jMetadataCacheDir);
+    
+    // Só metadados: um conversor local, sem estado compartilhado
+    Iso2GodConverter converter;
+    std::unique_ptr<IsoSession> session = converter.openSession(isoPath, metadataCacheDir);
+    if (!session) {
+        LOGE("Failed to open ISO session");
+        return 0;
+    }
+    
+    NativeCall native(jConverter);
+    if (!native) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(native->mutex);
+    jlong handle = native->nextSessionHandle++;
+    native->sessions[handle] = std::move(session);
+    return handle;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeSessionGetInfo(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jlong jHandle
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<IsoSession> session = findSession(*native, jHandle);
+    if (!session) {
+        return nullptr;
+    }
+    return newIsoInfoObject(env, session->getInfo());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeSessionConvert(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jlong jHandle,
     jstring jOutputPath,
+    jint jThreadCount,
+    jint jReadChunkSizeMb,
+    jboolean jKernelCopy,
+    jboolean jGamePartitionOnly,
+    jboolean jResume,
+    jboolean jCollectMetrics,
+    jstring jTracePath,
     jobject jProgressCallback
 ) {
-    LOGD("nativeConvertIso called");
+    LOGD("nativeSessionConvert called");
+    
+    NativeCall native(jConverter);
+    if (!native) {
+        return -1;
+    }
+    // Mantida viva até o fim da conversão, mesmo se fechada no meio
+    std::shared_ptr<IsoSession> session = findSession(*native, jHandle);
+    if (!session) {
+        return -1;
+    }
     
-    std::string isoPath = jstringToString(env, jIsoPath);
     std::string outputPath = jstringToString(env, jOutputPath);
     
-    LOGD("ISO: %s, Output: %s", isoPath.c_str(), outputPath.c_str());
+    ConversionOptions options;
+    options.threadCount = jThreadCount > 0 ? (uint32_t)jThreadCount : 0;
+    options.readChunkSize = jReadChunkSizeMb > 0 ? (uint32_t)jReadChunkSizeMb * 1024 * 1024 : 0;
+    options.payloadCopyMode = jKernelCopy ? PayloadCopyMode::KernelCopy : PayloadCopyMode::Buffered;
+    options.gamePartitionOnly = jGamePartitionOnly;
+    options.resume = jResume;
+    options.collectMetrics = jCollectMetrics;
+    options.traceFilePath = jstringToString(env, jTracePath);
     
-    // Criar conversor se não existir
-    if (!gConverter) {
-        gConverter = new Iso2GodConverter();
-    }
+    LOGD("ISO: %s, Output: %s, Threads: %u, Read chunk: %d MB", session->getPath().c_str(), outputPath.c_str(),
+         options.threadCount, jReadChunkSizeMb);
     
     // Obter referência global para o callback
     jobject gCallbackRef = env->NewGlobalRef(jProgressCallback);
@@ -80,8 +546,23 @@ Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertIso(
         env->DeleteLocalRef(jStatus);
     };
     
+    // Conversor e token próprios desta chamada, registrados para que
+    // nativeCancelConversion e nativeDestroy a alcancem
+    std::shared_ptr<SyncConversion> conversion = std::make_shared<SyncConversion>();
+    options.cancelToken = &conversion->cancelToken;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->conversions.push_back(conversion);
+        native->lastConversion = conversion;
+    }
+    
     // Executar conversão
-    int result = gConverter->convertIsoToGod(isoPath, outputPath, progressCallback);
+    int result = conversion->converter.convertIsoToGod(*session, outputPath, progressCallback, options);
+    
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->conversions.erase(std::find(native->conversions.begin(), native->conversions.end(), conversion));
+    }
     
     // Liberar referência global
     env->DeleteGlobalRef(gCallbackRef);
@@ -90,93 +571,686 @@ Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertIso(
     return result;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertStart(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jlong jHandle,
+    jstring jOutputPath,
+    jint jThreadCount,
+    jint jReadChunkSizeMb,
+    jboolean jKernelCopy,
+    jboolean jGamePartitionOnly,
+    jboolean jResume,
+    jboolean jCollectMetrics,
+    jstring jTracePath
+) {
+    LOGD("nativeConvertStart called");
+    
+    NativeCall native(jConverter);
+    if (!native) {
+        return -1;
+    }
+    std::shared_ptr<IsoSession> session = findSession(*native, jHandle);
+    if (!session) {
+        return -1;
+    }
+    
+    std::string outputPath = jstringToString(env, jOutputPath);
+    
+    ConversionOptions options;
+    options.threadCount = jThreadCount > 0 ? (uint32_t)jThreadCount : 0;
+    options.readChunkSize = jReadChunkSizeMb > 0 ? (uint32_t)jReadChunkSizeMb * 1024 * 1024 : 0;
+    options.payloadCopyMode = jKernelCopy ? PayloadCopyMode::KernelCopy : PayloadCopyMode::Buffered;
+    options.gamePartitionOnly = jGamePartitionOnly;
+    options.resume = jResume;
+    options.collectMetrics = jCollectMetrics;
+    options.traceFilePath = jstringToString(env, jTracePath);
+    
+    LOGD("ISO: %s, Output: %s, Threads: %u, Read chunk: %d MB", session->getPath().c_str(), outputPath.c_str(),
+         options.threadCount, jReadChunkSizeMb);
+    
+    // A thread do job não chama a JVM: o andamento é lido por nativeConvertWaitProgress
+    std::shared_ptr<ConversionJob> job = std::make_shared<ConversionJob>(session, outputPath, options);
+    
+    jint jobId;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        jobId = native->nextJobId++;
+        native->jobs[jobId] = job;
+    }
+    job->start();
+    return jobId;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertWaitProgress(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId,
+    jint jTimeoutMs
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<ConversionJob> job = findJob(*native, jJobId);
+    if (!job) {
+        return nullptr;
+    }
+    
+    ConversionProgress progress = jTimeoutMs > 0 ? job->waitProgress((uint32_t)jTimeoutMs) : job->getProgress();
+    return newConversionProgressObject(env, progress);
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertCancel(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<ConversionJob> job = findJob(*native, jJobId);
+    if (job) {
+        LOGD("nativeConvertCancel: job %d", jJobId);
+        job->cancel();
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertRelease(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<ConversionJob> job;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        auto it = native->jobs.find(jJobId);
+        if (it == native->jobs.end()) {
+            return;
+        }
+        job = std::move(it->second);
+        native->jobs.erase(it);
+    }
+    // Um job ainda rodando é cancelado; o destrutor espera a thread fora do lock
+    LOGD("nativeConvertRelease: job %d", jJobId);
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeSessionClose(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jlong jHandle
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<IsoSession> session;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        auto it = native->sessions.find(jHandle);
+        if (it == native->sessions.end()) {
+            return;
+        }
+        session = std::move(it->second);
+        native->sessions.erase(it);
+    }
+    LOGD("nativeSessionClose: %s", session->getPath().c_str());
+}
+
 JNIEXPORT jobject JNICALL
 Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeGetIsoInfo(
     JNIEnv* env,
     jobject thiz,
-    jstring jIsoPath
+    jlong jConverter,
+    jstring jIsoPath,
+    jstring jMetadataCacheDir
 ) {
     LOGD("nativeGetIsoInfo called");
     
     std::string isoPath = jstringToString(env, jIsoPath);
+    std::string metadataCacheDir = jstringToString(env, jMetadataCacheDir);
     
-    // Criar conversor se não existir
-    if (!gConverter) {
-        gConverter = new Iso2GodConverter();
-    }
-    
-    // Obter informações do ISO
-    IsoInfo* info = gConverter->getIsoInfo(isoPath);
+    // Obter informações do ISO (conversor local: chamadas simultâneas
+    // não dividem estado)
+    Iso2GodConverter converter;
+    IsoInfo* info = converter.getIsoInfo(isoPath, metadataCacheDir);
     if (!info) {
         LOGE("Failed to get ISO info");
         return nullptr;
     }
     
     // Criar objeto IsoInfo em Java
-    jclass isoInfoClass = env->FindClass(
-        "com/x360games/archivedownloader/utils/IsoInfo"
+    jobject isoInfoObj = newIsoInfoObject(env, *info);
+    
+    delete info;
+    
+    LOGD("ISO info retrieved successfully");
+    return isoInfoObj;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeGetTitleMetadata(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jstring jIsoPath
+) {
+    LOGD("nativeGetTitleMetadata called");
+    
+    std::string isoPath = jstringToString(env, jIsoPath);
+    
+    Iso2GodConverter converter;
+    TitleMetadata metadata;
+    if (!converter.getTitleMetadata(isoPath, metadata)) {
+        LOGE("Failed to get title metadata");
+        return nullptr;
+    }
+    
+    return newTitleMetadataObject(env, metadata);
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeSessionGetTitleMetadata(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jlong jHandle
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<IsoSession> session = findSession(*native, jHandle);
+    if (!session) {
+        return nullptr;
+    }
+    
+    Iso2GodConverter converter;
+    TitleMetadata metadata;
+    if (!converter.getTitleMetadata(*session, metadata)) {
+        LOGE("Failed to get title metadata");
+        return nullptr;
+    }
+    
+    return newTitleMetadataObject(env, metadata);
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeCancelConversion(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    LOGD("nativeCancelConversion called");
+    
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    
+    // Todas as conversões síncronas em andamento desta instância
+    std::lock_guard<std::mutex> lock(native->mutex);
+    for (const std::shared_ptr<SyncConversion>& conversion : native->conversions) {
+        conversion->cancelToken.cancel();
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeGetConversionMetrics(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    // Métricas da última conversão síncrona, mantida viva enquanto lê
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<SyncConversion> conversion;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        conversion = native->lastConversion;
+    }
+    if (!conversion) {
+        return nullptr;
+    }
+    
+    return newStageMetricsArray(env, conversion->converter.getProfiler());
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeConvertGetMetrics(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<ConversionJob> job = findJob(*native, jJobId);
+    if (!job) {
+        return nullptr;
+    }
+    return newStageMetricsArray(env, job->getProfiler());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchCreate(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jMaxConcurrentJobs,
+    jint jThreadCount,
+    jint jReadChunkSizeMb,
+    jboolean jKernelCopy,
+    jboolean jGamePartitionOnly,
+    jboolean jResume,
+    jstring jMetadataCacheDir
+) {
+    LOGD("nativeBatchCreate called: %d concurrent jobs", jMaxConcurrentJobs);
+    
+    ConversionOptions options;
+    options.threadCount = jThreadCount > 0 ? (uint32_t)jThreadCount : 0;
+    options.readChunkSize = jReadChunkSizeMb > 0 ? (uint32_t)jReadChunkSizeMb * 1024 * 1024 : 0;
+    options.payloadCopyMode = jKernelCopy ? PayloadCopyMode::KernelCopy : PayloadCopyMode::Buffered;
+    options.gamePartitionOnly = jGamePartitionOnly;
+    options.resume = jResume;
+    options.metadataCacheDir = jstringToString(env, jMetadataCacheDir);
+    
+    std::shared_ptr<BatchConverter> batch = std::make_shared<BatchConverter>(
+        jMaxConcurrentJobs > 0 ? (uint32_t)jMaxConcurrentJobs : 1, options);
+    
+    // Um lote por vez: o anterior é cancelado e descartado (fora do lock)
+    NativeCall native(jConverter);
+    if (!native) {
+        return JNI_FALSE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->batch.swap(batch);
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchSubmit(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jstring jIsoPath,
+    jstring jOutputPath
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return -1;
+    }
+    std::shared_ptr<BatchConverter> batch = getBatch(*native);
+    if (!batch) {
+        LOGE("nativeBatchSubmit called without a batch");
+        return -1;
+    }
+    
+    std::string isoPath = jstringToString(env, jIsoPath);
+    std::string outputPath = jstringToString(env, jOutputPath);
+    return (jint)batch->submit(isoPath, outputPath);
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchGetJobStatus(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<BatchConverter> batch = getBatch(*native);
+    BatchJobStatus status;
+    if (!batch || jJobId < 0 || !batch->getJobStatus((uint32_t)jJobId, status)) {
+        return nullptr;
+    }
+    
+    jclass statusClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/BatchJobStatus"
     );
+    if (!statusClass) {
+        LOGE("Failed to find BatchJobStatus class");
+        return nullptr;
+    }
     
-    if (!isoInfoClass) {
-        LOGE("Failed to find IsoInfo class");
-        delete info;
+    jmethodID constructor = env->GetMethodID(
+        statusClass,
+        "<init>",
+        "(IIFLjava/lang/String;IJDD)V"
+    );
+    if (!constructor) {
+        LOGE("Failed to find BatchJobStatus constructor");
+        return nullptr;
+    }
+    
+    jstring jStatus = stringToJstring(env, status.status);
+    jobject statusObj = env->NewObject(
+        statusClass,
+        constructor,
+        (jint)status.id,
+        (jint)status.state,
+        (jfloat)status.progress,
+        jStatus,
+        (jint)status.result,
+        (jlong)status.isoBytes,
+        (jdouble)status.seconds,
+        (jdouble)status.stats.readThroughputMBps
+    );
+    env->DeleteLocalRef(jStatus);
+    
+    return statusObj;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchGetStats(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<BatchConverter> batch = getBatch(*native);
+    if (!batch) {
+        return nullptr;
+    }
+    
+    BatchStats stats = batch->getStats();
+    
+    jclass statsClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/BatchStats"
+    );
+    if (!statsClass) {
+        LOGE("Failed to find BatchStats class");
         return nullptr;
     }
     
     jmethodID constructor = env->GetMethodID(
-        isoInfoClass,
+        statsClass,
         "<init>",
-        "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JLjava/lang/String;)V"
+        "(IIIIIJDD)V"
     );
+    if (!constructor) {
+        LOGE("Failed to find BatchStats constructor");
+        return nullptr;
+    }
+    
+    return env->NewObject(
+        statsClass,
+        constructor,
+        (jint)stats.queued,
+        (jint)stats.running,
+        (jint)stats.done,
+        (jint)stats.failed,
+        (jint)stats.cancelled,
+        (jlong)stats.bytesConverted,
+        (jdouble)stats.elapsedSeconds,
+        (jdouble)stats.throughputMBps
+    );
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchCancel(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jJobId
+) {
+    LOGD("nativeBatchCancel called: %d", jJobId);
+    
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<BatchConverter> batch = getBatch(*native);
+    if (!batch) {
+        return;
+    }
     
+    // -1 = lote inteiro
+    if (jJobId < 0) {
+        batch->cancelAll();
+    } else {
+        batch->cancelJob((uint32_t)jJobId);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeBatchRelease(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    LOGD("nativeBatchRelease called");
+    
+    // Cancela o que ainda estiver rodando; os executores são esperados
+    // quando a última referência (esta ou a de uma chamada em andamento) sai
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<BatchConverter> batch;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        batch.swap(native->batch);
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeScanStart(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jobjectArray jPaths,
+    jint jWorkerThreads,
+    jint jIoPerDevice,
+    jboolean jRecursive,
+    jstring jMetadataCacheDir
+) {
+    std::vector<std::string> roots;
+    jsize count = jPaths ? env->GetArrayLength(jPaths) : 0;
+    for (jsize i = 0; i < count; i++) {
+        jstring jPath = (jstring)env->GetObjectArrayElement(jPaths, i);
+        roots.push_back(jstringToString(env, jPath));
+        env->DeleteLocalRef(jPath);
+    }
+    
+    LOGD("nativeScanStart called: %zu paths", roots.size());
+    
+    LibraryScanOptions options;
+    options.workerThreads = jWorkerThreads > 0 ? (uint32_t)jWorkerThreads : 0;
+    options.ioPerDevice = jIoPerDevice > 0 ? (uint32_t)jIoPerDevice : options.ioPerDevice;
+    options.recursive = jRecursive;
+    options.metadataCacheDir = jstringToString(env, jMetadataCacheDir);
+    
+    std::shared_ptr<LibraryScanner> scanner = std::make_shared<LibraryScanner>(roots, options);
+    
+    // Uma varredura por vez: a anterior é cancelada e descartada (fora do lock)
+    NativeCall native(jConverter);
+    if (!native) {
+        return JNI_FALSE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->scanner.swap(scanner);
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeScanNext(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter,
+    jint jTimeoutMs
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<LibraryScanner> scanner = getScanner(*native);
+    if (!scanner) {
+        return nullptr;
+    }
+    
+    // Tudo o que terminou desde a última chamada; null quando acabou
+    std::vector<LibraryScanResult> results;
+    if (!scanner->nextResults(results, jTimeoutMs > 0 ? (uint32_t)jTimeoutMs : 0)) {
+        return nullptr;
+    }
+    
+    jclass resultClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/IsoScanResult"
+    );
+    if (!resultClass) {
+        LOGE("Failed to find IsoScanResult class");
+        return nullptr;
+    }
+    
+    jmethodID constructor = env->GetMethodID(
+        resultClass,
+        "<init>",
+        "(ILjava/lang/String;Lcom/x360games/archivedownloader/utils/IsoInfo;ZD)V"
+    );
     if (!constructor) {
-        LOGE("Failed to find IsoInfo constructor");
-        delete info;
+        LOGE("Failed to find IsoScanResult constructor");
         return nullptr;
     }
     
-    // Converter strings C++ para jstring
-    jstring jGameName = stringToJstring(env, info->gameName);
-    jstring jTitleId = stringToJstring(env, info->titleId);
-    jstring jMediaId = stringToJstring(env, info->mediaId);
-    jstring jPlatform = stringToJstring(env, info->platform);
-    jstring jVolumeDescriptor = stringToJstring(env, info->volumeDescriptor);
-    jlong jSizeBytes = (jlong)info->sizeBytes;
+    jobjectArray array = env->NewObjectArray((jsize)results.size(), resultClass, nullptr);
     
-    // Criar objeto
-    jobject isoInfoObj = env->NewObject(
-        isoInfoClass,
-        constructor,
-        jGameName,
-        jTitleId,
-        jMediaId,
-        jPlatform,
-        jSizeBytes,
-        jVolumeDescriptor
+    for (size_t i = 0; i < results.size(); i++) {
+        const LibraryScanResult& result = results[i];
+        
+        jstring jPath = stringToJstring(env, result.isoPath);
+        jobject jInfo = result.ok ? newIsoInfoObject(env, result.info) : nullptr;
+        jobject resultObj = env->NewObject(
+            resultClass,
+            constructor,
+            (jint)result.index,
+            jPath,
+            jInfo,
+            (jboolean)result.fromCache,
+            (jdouble)result.seconds
+        );
+        env->SetObjectArrayElement(array, (jsize)i, resultObj);
+        
+        env->DeleteLocalRef(resultObj);
+        if (jInfo) {
+            env->DeleteLocalRef(jInfo);
+        }
+        env->DeleteLocalRef(jPath);
+    }
+    
+    return array;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeScanGetProgress(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    NativeCall native(jConverter);
+    if (!native) {
+        return nullptr;
+    }
+    std::shared_ptr<LibraryScanner> scanner = getScanner(*native);
+    if (!scanner) {
+        return nullptr;
+    }
+    
+    LibraryScanProgress progress = scanner->getProgress();
+    
+    jclass progressClass = env->FindClass(
+        "com/x360games/archivedownloader/utils/LibraryScanProgress"
     );
+    if (!progressClass) {
+        LOGE("Failed to find LibraryScanProgress class");
+        return nullptr;
+    }
     
-    // Limpar referências locais
-    env->DeleteLocalRef(jGameName);
-    env->DeleteLocalRef(jTitleId);
-    env->DeleteLocalRef(jMediaId);
-    env->DeleteLocalRef(jPlatform);
-    env->DeleteLocalRef(jVolumeDescriptor);
+    jmethodID constructor = env->GetMethodID(
+        progressClass,
+        "<init>",
+        "(IIIIZD)V"
+    );
+    if (!constructor) {
+        LOGE("Failed to find LibraryScanProgress constructor");
+        return nullptr;
+    }
     
-    delete info;
+    return env->NewObject(
+        progressClass,
+        constructor,
+        (jint)progress.discovered,
+        (jint)progress.completed,
+        (jint)progress.failed,
+        (jint)progress.cacheHits,
+        (jboolean)progress.discoveryDone,
+        (jdouble)progress.elapsedSeconds
+    );
+}
+
+JNIEXPORT void JNICALL
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeScanCancel(
+    JNIEnv* env,
+    jobject thiz,
+    jlong jConverter
+) {
+    LOGD("nativeScanCancel called");
     
-    LOGD("ISO info retrieved successfully");
-    return isoInfoObj;
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<LibraryScanner> scanner = getScanner(*native);
+    if (scanner) {
+        scanner->cancel();
+    }
 }
 
 JNIEXPORT void JNICALL
-Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeCancelConversion(
+Java_com_x360games_archivedownloader_utils_Iso2GodConverter_nativeScanRelease(
     JNIEnv* env,
-    jobject thiz
+    jobject thiz,
+    jlong jConverter
 ) {
-    LOGD("nativeCancelConversion called");
+    LOGD("nativeScanRelease called");
     
-    if (gConverter) {
-        gConverter->cancelConversion();
+    NativeCall native(jConverter);
+    if (!native) {
+        return;
+    }
+    std::shared_ptr<LibraryScanner> scanner;
+    {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        scanner.swap(native->scanner);
     }
 }
 
@@ -191,11 +1265,6 @@ JNI_OnLoad(JavaVM* vm, void* reserved) {
 JNIEXPORT void JNICALL
 JNI_OnUnload(JavaVM* vm, void* reserved) {
     LOGD("Iso2God native library unloaded");
-    
-    if (gConverter) {
-        delete gConverter;
-        gConverter = nullptr;
-    }
 }
 
 } // extern "C"
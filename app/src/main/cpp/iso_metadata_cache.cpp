@@ -0,0 +1,378 @@
+#include "iso_metadata_cache.h"
+#include "gdf_parser.h"
+#include "hash_utils.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "IsoMetadataCache"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// magic, versão e tamanho do cabeçalho vêm antes de tudo
+static const size_t PREFIX_SIZE = 4 + 4 + 4;
+
+// O primeiro pread pega o cabeçalho inteiro na prática (nomes curtos)
+static const size_t FIRST_READ_SIZE = 4096;
+
+template <typename T>
+static void appendValue(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void appendString(std::vector<uint8_t>& out, const std::string& value) {
+    appendValue(out, (uint32_t)value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Leitura com limite: qualquer campo fora do buffer invalida o registro
+class RecordReader {
+public:
+    RecordReader(const uint8_t* data, size_t size) : in(data), end(data + size), ok(true) {}
+
+    template <typename T>
+    T value() {
+        T result = T();
+        if (!ok || (size_t)(end - in) < sizeof(T)) {
+            ok = false;
+            return result;
+        }
+        memcpy(&result, in, sizeof(T));
+        in += sizeof(T);
+        return result;
+    }
+
+    std::string string() {
+        uint32_t length = value<uint32_t>();
+        if (!ok || (size_t)(end - in) < length) {
+            ok = false;
+            return std::string();
+        }
+        std::string result((const char*)in, length);
+        in += length;
+        return result;
+    }
+
+    void bytes(uint8_t* out, size_t size) {
+        if (!ok || (size_t)(end - in) < size) {
+            ok = false;
+            return;
+        }
+        memcpy(out, in, size);
+        in += size;
+    }
+
+    bool isOk() const { return ok; }
+
+private:
+    const uint8_t* in;
+    const uint8_t* end;
+    bool ok;
+};
+
+static bool readFully(int fd, uint8_t* buffer, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, buffer, size, (off_t)offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+static bool writeFully(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+IsoMetadataCache::IsoMetadataCache(const std::string& directory)
+    : directory(directory) {
+}
+
+std::string IsoMetadataCache::getEntryPath(const std::string& isoPath) const {
+    uint8_t digest[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1((const uint8_t*)isoPath.data(), isoPath.size(), digest);
+    return directory + "/" + HashUtils::hashToHexString(digest, 8) + ".meta";
+}
+
+bool IsoMetadataCache::readRecord(int fd, Record& record) const {
+    std::vector<uint8_t> header(FIRST_READ_SIZE);
+    ssize_t n;
+    do {
+        n = pread(fd, header.data(), header.size(), 0);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < (ssize_t)PREFIX_SIZE) {
+        return false;
+    }
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    memcpy(&magic, header.data(), 4);
+    memcpy(&version, header.data() + 4, 4);
+    memcpy(&headerSize, header.data() + 8, 4);
+
+    if (magic != MAGIC || version != VERSION) {
+        LOGD("Ignoring cache entry with unknown format (magic 0x%08X, version %u)", magic, version);
+        return false;
+    }
+    if (headerSize < PREFIX_SIZE + HashUtils::SHA1_DIGEST_SIZE || headerSize > MAX_HEADER_SIZE) {
+        return false;
+    }
+
+    // Cabeçalho maior que a primeira leitura (caminho ou nomes longos)
+    if (headerSize > (size_t)n) {
+        header.resize(headerSize);
+        if (!readFully(fd, header.data() + n, headerSize - n, n)) {
+            return false;
+        }
+    }
+
+    size_t bodySize = headerSize - HashUtils::SHA1_DIGEST_SIZE;
+    uint8_t checksum[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1(header.data(), bodySize, checksum);
+    if (memcmp(checksum, header.data() + bodySize, sizeof(checksum)) != 0) {
+        LOGE("Cache entry checksum mismatch, ignoring");
+        return false;
+    }
+
+    RecordReader reader(header.data() + PREFIX_SIZE, bodySize - PREFIX_SIZE);
+    record.isoPath = reader.string();
+    record.isoSize = reader.value<uint64_t>();
+    record.mtimeSec = reader.value<int64_t>();
+    record.mtimeNsec = reader.value<int64_t>();
+    reader.bytes(record.fingerprint, sizeof(record.fingerprint));
+    record.info.gameName = reader.string();
+    record.info.titleId = reader.string();
+    record.info.mediaId = reader.string();
+    record.info.platform = reader.string();
+    record.info.volumeDescriptor = reader.string();
+    record.info.sizeBytes = reader.value<uint64_t>();
+    record.info.gamePartitionOffset = reader.value<uint64_t>();
+    record.info.gamePartitionEnd = reader.value<uint64_t>();
+    record.gdfSize = reader.value<uint32_t>();
+    record.headerSize = headerSize;
+
+    return reader.isOk();
+}
+
+bool IsoMetadataCache::matches(const Record& record, const std::string& isoPath, uint64_t size,
+                               int64_t mtimeSec, int64_t mtimeNsec) const {
+    return record.isoPath == isoPath && record.isoSize == size &&
+           record.mtimeSec == mtimeSec && record.mtimeNsec == mtimeNsec;
+}
+
+bool IsoMetadataCache::lookup(const std::string& isoPath, IsoInfo& info) const {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    struct stat st;
+    if (stat(isoPath.c_str(), &st) != 0) {
+        return false;
+    }
+
+    int fd = open(getEntryPath(isoPath).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    Record record;
+    bool hit = readRecord(fd, record) &&
+               matches(record, isoPath, (uint64_t)st.st_size, st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    close(fd);
+
+    if (!hit) {
+        return false;
+    }
+
+    info = record.info;
+    LOGD("Cache hit: %s (%s)", isoPath.c_str(), info.titleId.c_str());
+    return true;
+}
+
+bool IsoMetadataCache::lookup(IsoSource& source, IsoInfo& info, GDFParser* gdf) const {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(source.getFd(), &st) != 0) {
+        return false;
+    }
+
+    int fd = open(getEntryPath(source.getPath()).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    Record record;
+    bool hit = readRecord(fd, record) &&
+               matches(record, source.getPath(), source.getSize(), st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+
+    // Mesmo caminho, tamanho e mtime: conferir as amostras
+    if (hit) {
+        uint8_t fingerprint[IsoSource::FINGERPRINT_SIZE];
+        hit = source.computeFingerprint(fingerprint) &&
+              memcmp(fingerprint, record.fingerprint, sizeof(fingerprint)) == 0;
+        if (!hit) {
+            LOGD("Cache entry fingerprint mismatch: %s", source.getPath().c_str());
+        }
+    }
+
+    if (hit && gdf) {
+        std::vector<uint8_t> gdfIndex((size_t)record.gdfSize + HashUtils::SHA1_DIGEST_SIZE);
+        uint8_t checksum[HashUtils::SHA1_DIGEST_SIZE];
+
+        hit = readFully(fd, gdfIndex.data(), gdfIndex.size(), record.headerSize);
+        if (hit) {
+            HashUtils::calculateSHA1(gdfIndex.data(), record.gdfSize, checksum);
+            hit = memcmp(checksum, gdfIndex.data() + record.gdfSize, sizeof(checksum)) == 0 &&
+                  gdf->loadIndex(gdfIndex.data(), record.gdfSize);
+        }
+        if (!hit) {
+            LOGE("Cached GDF index unusable: %s", source.getPath().c_str());
+        }
+    }
+    close(fd);
+
+    if (!hit) {
+        return false;
+    }
+
+    info = record.info;
+    LOGD("Cache hit (verified): %s (%s)", source.getPath().c_str(), info.titleId.c_str());
+    return true;
+}
+
+void IsoMetadataCache::serialize(const Record& record, const std::vector<uint8_t>& gdfIndex,
+                                 std::vector<uint8_t>& out) const {
+    out.clear();
+    appendValue(out, MAGIC);
+    appendValue(out, VERSION);
+    appendValue(out, (uint32_t)0);   // tamanho do cabeçalho, preenchido abaixo
+    appendString(out, record.isoPath);
+    appendValue(out, record.isoSize);
+    appendValue(out, record.mtimeSec);
+    appendValue(out, record.mtimeNsec);
+    out.insert(out.end(), record.fingerprint, record.fingerprint + sizeof(record.fingerprint));
+    appendString(out, record.info.gameName);
+    appendString(out, record.info.titleId);
+    appendString(out, record.info.mediaId);
+    appendString(out, record.info.platform);
+    appendString(out, record.info.volumeDescriptor);
+    appendValue(out, record.info.sizeBytes);
+    appendValue(out, record.info.gamePartitionOffset);
+    appendValue(out, record.info.gamePartitionEnd);
+    appendValue(out, (uint32_t)gdfIndex.size());
+
+    uint32_t headerSize = (uint32_t)(out.size() + HashUtils::SHA1_DIGEST_SIZE);
+    memcpy(out.data() + 8, &headerSize, sizeof(headerSize));
+
+    uint8_t checksum[HashUtils::SHA1_DIGEST_SIZE];
+    HashUtils::calculateSHA1(out.data(), out.size(), checksum);
+    out.insert(out.end(), checksum, checksum + sizeof(checksum));
+
+    HashUtils::calculateSHA1(gdfIndex.data(), gdfIndex.size(), checksum);
+    out.insert(out.end(), gdfIndex.begin(), gdfIndex.end());
+    out.insert(out.end(), checksum, checksum + sizeof(checksum));
+}
+
+bool IsoMetadataCache::store(IsoSource& source, const IsoInfo& info, const GDFParser& gdf) const {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(source.getFd(), &st) != 0) {
+        return false;
+    }
+
+    Record record;
+    record.isoPath = source.getPath();
+    record.isoSize = source.getSize();
+    record.mtimeSec = st.st_mtim.tv_sec;
+    record.mtimeNsec = st.st_mtim.tv_nsec;
+    record.info = info;
+    if (!source.computeFingerprint(record.fingerprint)) {
+        return false;
+    }
+
+    std::vector<uint8_t> gdfIndex;
+    gdf.saveIndex(gdfIndex);
+
+    std::vector<uint8_t> out;
+    serialize(record, gdfIndex, out);
+
+    // readRecord() recusa cabeçalhos maiores (caminho ou nomes absurdos)
+    if (out.size() - gdfIndex.size() - HashUtils::SHA1_DIGEST_SIZE > MAX_HEADER_SIZE) {
+        LOGE("Metadata too large to cache: %s", record.isoPath.c_str());
+        return false;
+    }
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOGE("Cannot create cache directory: %s (%s)", directory.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Nome temporário único: duas conversões podem gravar o mesmo ISO
+    std::string entryPath = getEntryPath(record.isoPath);
+    std::vector<char> tmpPath(entryPath.begin(), entryPath.end());
+    const char suffix[] = ".XXXXXX";
+    tmpPath.insert(tmpPath.end(), suffix, suffix + sizeof(suffix));
+
+    int fd = mkstemp(tmpPath.data());
+    if (fd < 0) {
+        LOGE("Failed to create cache entry: %s (%s)", entryPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    bool written = writeFully(fd, out.data(), out.size());
+    if (!written) {
+        LOGE("Failed to write cache entry: %s", strerror(errno));
+    }
+    close(fd);
+
+    if (!written || rename(tmpPath.data(), entryPath.c_str()) != 0) {
+        if (written) {
+            LOGE("Failed to replace cache entry: %s", strerror(errno));
+        }
+        unlink(tmpPath.data());
+        return false;
+    }
+
+    LOGD("Cached metadata for %s (%zu bytes)", record.isoPath.c_str(), out.size());
+    return true;
+}
+
+void IsoMetadataCache::remove(const std::string& isoPath) const {
+    if (!isEnabled()) {
+        return;
+    }
+    std::string entryPath = getEntryPath(isoPath);
+    if (unlink(entryPath.c_str()) != 0 && errno != ENOENT) {
+        LOGE("Failed to remove cache entry: %s (%s)", entryPath.c_str(), strerror(errno));
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef ISO_METADATA_CACHE_H
+#define ISO_METADATA_CACHE_H
+
+#include "iso2god_converter.h"
+#include "iso_source.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GDFParser;
+
+// Cache em disco dos metadados de cada ISO (IsoInfo e a árvore GDF já
+// lida), para não repetir o parse do GDF e a leitura do default.xex a
+// cada getIsoInfo() ou conversão.
+//
+// Um arquivo por ISO na pasta do cache, com o nome derivado do caminho.
+// A chave é o caminho, o tamanho e o mtime (ns) do ISO mais o
+// IsoSource::computeFingerprint(). A consulta só pelo caminho confere o
+// que sai de um stat() (caminho, tamanho e mtime), então listar uma
+// biblioteca inteira custa um stat e uma leitura pequena por ISO; a
+// consulta com o ISO aberto, feita antes de converter, confere também as
+// amostras.
+//
+// O cabeçalho (chave + IsoInfo) e o índice GDF têm cada um o seu SHA-1:
+// a consulta rápida lê só o cabeçalho. Um registro inválido ou de outro
+// ISO é só um miss, e as gravações são atômicas (arquivo temporário +
+// rename), então várias conversões podem usar a mesma pasta.
+class IsoMetadataCache {
+public:
+    // Pasta vazia = cache desligado (toda consulta é miss, store não faz nada)
+    explicit IsoMetadataCache(const std::string& directory);
+
+    bool isEnabled() const { return !directory.empty(); }
+
+    // Só stat(): caminho, tamanho e mtime
+    bool lookup(const std::string& isoPath, IsoInfo& info) const;
+
+    // Com o ISO aberto: confere também as amostras. Com gdf, o índice
+    // salvo é carregado nele (miss se não puder ser carregado).
+    bool lookup(IsoSource& source, IsoInfo& info, GDFParser* gdf = nullptr) const;
+
+    bool store(IsoSource& source, const IsoInfo& info, const GDFParser& gdf) const;
+
+    void remove(const std::string& isoPath) const;
+
+    // Arquivo do cache para este ISO
+    std::string getEntryPath(const std::string& isoPath) const;
+
+private:
+    static const uint32_t MAGIC = 0x4D473249;   // "I2GM"
+    static const uint32_t VERSION = 1;
+    static const uint32_t MAX_HEADER_SIZE = 64 * 1024;
+
+    // Cabeçalho de um registro
+    struct Record {
+        std::string isoPath;
+        uint64_t isoSize = 0;
+        int64_t mtimeSec = 0;
+        int64_t mtimeNsec = 0;
+        uint8_t fingerprint[IsoSource::FINGERPRINT_SIZE] = {};
+        IsoInfo info;
+        uint32_t headerSize = 0;   // bytes até o índice GDF
+        uint32_t gdfSize = 0;
+    };
+
+    std::string directory;
+
+    bool readRecord(int fd, Record& record) const;
+    bool matches(const Record& record, const std::string& isoPath, uint64_t size,
+                 int64_t mtimeSec, int64_t mtimeNsec) const;
+    void serialize(const Record& record, const std::vector<uint8_t>& gdfIndex, std::vector<uint8_t>& out) const;
+};
+
+#endif // ISO_METADATA_CACHE_H
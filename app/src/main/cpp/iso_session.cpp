@@ -0,0 +1,16 @@
+#include "iso_session.h"
+#include "native_log.h"
+
+#define LOG_TAG "IsoSession"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+IsoSession::IsoSession(std::unique_ptr<IsoSource> source)
+    : source(std::move(source)),
+      fromCache(false),
+      xexParsed(false) {
+}
+
+IsoSession::~IsoSession() {
+    LOGD("ISO session closed: %s", source->getPath().c_str());
+}
@@ -0,0 +1,51 @@
+#ifndef ISO_SESSION_H
+#define ISO_SESSION_H
+
+#include "gdf_parser.h"
+#include "iso2god_converter.h"
+#include "iso_source.h"
+#include "xex_parser.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+// ISO aberto e analisado uma vez (Iso2GodConverter::openSession) e
+// reaproveitado pelo IsoInfo, pelos metadados do título e pelas
+// conversões: o IsoSource (pread), o IsoInfo com a
+// partição do jogo, a árvore GDF indexada e o cabeçalho do default.xex
+// ficam aqui, então uma conversão a partir da sessão vai direto para a
+// cópia dos dados.
+//
+// Vindo do IsoMetadataCache o XEX não é lido na abertura, só no primeiro
+// pedido de metadados do título. Fora essa parte (protegida por um mutex)
+// nada muda depois da abertura, então a sessão pode ser usada por mais de
+// uma thread ao mesmo tempo.
+class IsoSession {
+public:
+    ~IsoSession();
+
+    const std::string& getPath() const { return source->getPath(); }
+    const IsoInfo& getInfo() const { return info; }
+    IsoSource& getSource() { return *source; }
+    const GDFParser& getGdf() const { return gdf; }
+
+    // IsoInfo e árvore GDF carregados do cache de metadados
+    bool isFromCache() const { return fromCache; }
+
+private:
+    friend class Iso2GodConverter;
+
+    explicit IsoSession(std::unique_ptr<IsoSource> source);
+
+    std::unique_ptr<IsoSource> source;
+    IsoInfo info;
+    GDFParser gdf;
+    bool fromCache;
+
+    std::mutex xexMutex;
+    XexParser xex;
+    std::unique_ptr<XexByteSource> xexBytes;
+    bool xexParsed;
+};
+
+#endif // ISO_SESSION_H
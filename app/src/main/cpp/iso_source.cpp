@@ -0,0 +1,201 @@
+#include "iso_source.h"
+#include "hash_utils.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "IsoSource"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// ISO mapeado inteiro na memória: view() é só aritmética de ponteiro
+class MappedIsoSource : public IsoSource {
+public:
+    MappedIsoSource(const std::string& path, int fd, uint64_t fileSize, uint8_t* base)
+        : IsoSource(path, fd, fileSize), base(base), pageSize(sysconf(_SC_PAGESIZE)) {}
+
+    ~MappedIsoSource() override {
+        munmap(base, (size_t)fileSize);
+    }
+
+    using IsoSource::view;
+
+    bool isMapped() const override { return true; }
+
+    const uint8_t* view(uint64_t offset, size_t length, uint8_t*) override {
+        if (!inRange(offset, length)) {
+            return nullptr;
+        }
+        return base + offset;
+    }
+
+    void adviseSequential() override {
+        madvise(base, (size_t)fileSize, MADV_SEQUENTIAL);
+        posix_fadvise64(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    void willNeed(uint64_t offset, uint64_t length) override {
+        uint8_t* start;
+        size_t size;
+        if (pageRange(offset, length, start, size)) {
+            madvise(start, size, MADV_WILLNEED);
+        }
+    }
+
+    void dontNeed(uint64_t offset, uint64_t length) override {
+        // Primeiro desmapear as páginas deste processo, senão o kernel não
+        // consegue tirá-las do page cache
+        uint8_t* start;
+        size_t size;
+        if (pageRange(offset, length, start, size)) {
+            madvise(start, size, MADV_DONTNEED);
+        }
+        posix_fadvise64(fd, offset, length, POSIX_FADV_DONTNEED);
+    }
+
+private:
+    uint8_t* base;
+    uint64_t pageSize;
+
+    // Faixa alinhada a páginas, limitada ao mapeamento
+    bool pageRange(uint64_t offset, uint64_t length, uint8_t*& start, size_t& size) const {
+        if (offset >= fileSize) {
+            return false;
+        }
+        uint64_t end = (length > fileSize - offset) ? fileSize : offset + length;
+        uint64_t alignedOffset = offset & ~(pageSize - 1);
+        start = base + alignedOffset;
+        size = (size_t)(end - alignedOffset);
+        return true;
+    }
+};
+
+// Fallback: pread no buffer de quem chama
+class PreadIsoSource : public IsoSource {
+public:
+    PreadIsoSource(const std::string& path, int fd, uint64_t fileSize)
+        : IsoSource(path, fd, fileSize) {}
+
+    using IsoSource::view;
+
+    bool isMapped() const override { return false; }
+
+    const uint8_t* view(uint64_t offset, size_t length, uint8_t* scratch) override {
+        if (!inRange(offset, length)) {
+            return nullptr;
+        }
+
+        size_t total = 0;
+        while (total < length) {
+            ssize_t n = pread64(fd, scratch + total, length - total, (off64_t)(offset + total));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                LOGE("pread failed at offset %llu: %s",
+                     (unsigned long long)(offset + total), strerror(errno));
+                return nullptr;
+            }
+            if (n == 0) {
+                LOGE("Unexpected end of file at offset %llu", (unsigned long long)(offset + total));
+                return nullptr;
+            }
+            total += n;
+        }
+
+        return scratch;
+    }
+
+    void adviseSequential() override {
+        posix_fadvise64(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    void willNeed(uint64_t offset, uint64_t length) override {
+        posix_fadvise64(fd, offset, length, POSIX_FADV_WILLNEED);
+    }
+
+    void dontNeed(uint64_t offset, uint64_t length) override {
+        posix_fadvise64(fd, offset, length, POSIX_FADV_DONTNEED);
+    }
+};
+
+} // namespace
+
+IsoSource::~IsoSource() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+const uint8_t* IsoSource::view(uint64_t offset, size_t length, std::vector<uint8_t>& scratch) {
+    if (!isMapped() && scratch.size() < length) {
+        scratch.resize(length);
+    }
+    return view(offset, length, scratch.data());
+}
+
+bool IsoSource::computeFingerprint(uint8_t* digest) {
+    const uint32_t SAMPLE_COUNT = 16;
+    const uint32_t SAMPLE_SIZE = 4096;
+
+    SHA1Context ctx;
+    HashUtils::sha1Init(ctx);
+
+    std::vector<uint8_t> scratch;
+    uint64_t sampleSize = fileSize < SAMPLE_SIZE ? fileSize : SAMPLE_SIZE;
+    uint64_t lastOffset = fileSize - sampleSize;
+
+    for (uint32_t i = 0; i < SAMPLE_COUNT; i++) {
+        uint64_t offset = lastOffset / (SAMPLE_COUNT - 1) * i;
+        if (i == SAMPLE_COUNT - 1) {
+            offset = lastOffset;
+        }
+
+        const uint8_t* sample = view(offset, (size_t)sampleSize, scratch);
+        if (!sample) {
+            LOGE("Failed to read ISO sample at offset %llu", (unsigned long long)offset);
+            return false;
+        }
+        HashUtils::sha1Update(ctx, sample, (size_t)sampleSize);
+    }
+
+    HashUtils::sha1Final(ctx, digest);
+    return true;
+}
+
+std::unique_ptr<IsoSource> IsoSource::open(const std::string& isoPath, bool allowMapping) {
+    int fd = ::open(isoPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("Cannot open ISO file: %s (%s)", isoPath.c_str(), strerror(errno));
+        return nullptr;
+    }
+
+    struct stat64 st;
+    if (fstat64(fd, &st) != 0) {
+        LOGE("Cannot stat ISO file: %s (%s)", isoPath.c_str(), strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    uint64_t fileSize = st.st_size;
+
+    // Mapear o arquivo inteiro quando couber no espaço de endereços
+    if (allowMapping && fileSize > 0 && fileSize <= (uint64_t)SIZE_MAX) {
+        void* base = mmap(nullptr, (size_t)fileSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            LOGD("ISO mapped: %s (%llu bytes)", isoPath.c_str(), (unsigned long long)fileSize);
+            return std::unique_ptr<IsoSource>(
+                new MappedIsoSource(isoPath, fd, fileSize, (uint8_t*)base));
+        }
+        LOGD("mmap failed (%s), falling back to pread", strerror(errno));
+    }
+
+    LOGD("ISO opened with pread: %s (%llu bytes)", isoPath.c_str(), (unsigned long long)fileSize);
+    return std::unique_ptr<IsoSource>(new PreadIsoSource(isoPath, fd, fileSize));
+}
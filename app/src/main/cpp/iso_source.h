@@ -0,0 +1,69 @@
+#ifndef ISO_SOURCE_H
+#define ISO_SOURCE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Acesso somente leitura ao arquivo ISO, aberto uma única vez e
+// compartilhado por GDFParser, XexParser e Iso2GodConverter.
+//
+// Com allowMapping o arquivo inteiro é mapeado (mmap) e os ponteiros vão
+// direto para as páginas mapeadas, sem cópia; quando o mapeamento não é
+// possível (ex.: ISO de 8 GB em processo de 32 bits) usa pread no buffer
+// fornecido por quem chama. Uma página mapeada que não pode ser lida (erro
+// de mídia, arquivo truncado, cartão removido) vira SIGBUS, então a
+// conversão (IsoSession) usa sempre pread, onde a falha é um erro comum.
+class IsoSource {
+public:
+    virtual ~IsoSource();
+
+    // Abre o ISO; nullptr se o arquivo não puder ser aberto. Sem
+    // allowMapping usa sempre pread
+    static std::unique_ptr<IsoSource> open(const std::string& isoPath, bool allowMapping = true);
+
+    const std::string& getPath() const { return path; }
+    uint64_t getSize() const { return fileSize; }
+
+    // Descritor do ISO, para cópias feitas pelo kernel (copy_file_range)
+    int getFd() const { return fd; }
+
+    // true quando view() nunca usa o buffer auxiliar
+    virtual bool isMapped() const = 0;
+
+    // Ponteiro para [offset, offset + length). Com mmap aponta para o
+    // mapeamento; no modo pread os bytes são lidos em scratch (que deve ter
+    // pelo menos length bytes). nullptr se a faixa passar do fim do
+    // arquivo ou a leitura falhar.
+    virtual const uint8_t* view(uint64_t offset, size_t length, uint8_t* scratch) = 0;
+
+    // Mesmo que acima, redimensionando scratch só quando necessário
+    const uint8_t* view(uint64_t offset, size_t length, std::vector<uint8_t>& scratch);
+
+    // SHA-1 de 16 amostras de 4 KiB do início ao fim do ISO: identifica o
+    // arquivo sem lê-lo inteiro (barato mesmo para 15 GB) e pega um ISO
+    // substituído com o mesmo tamanho e mtime
+    static const uint32_t FINGERPRINT_SIZE = 20;
+    bool computeFingerprint(uint8_t* digest);
+
+    // Dicas de acesso para o kernel (page cache / readahead)
+    virtual void adviseSequential() = 0;
+    virtual void willNeed(uint64_t offset, uint64_t length) = 0;
+    virtual void dontNeed(uint64_t offset, uint64_t length) = 0;
+
+protected:
+    IsoSource(const std::string& path, int fd, uint64_t fileSize)
+        : path(path), fd(fd), fileSize(fileSize) {}
+
+    std::string path;
+    int fd;
+    uint64_t fileSize;
+
+    bool inRange(uint64_t offset, size_t length) const {
+        return offset <= fileSize && length <= fileSize - offset;
+    }
+};
+
+#endif // ISO_SOURCE_H
@@ -0,0 +1,278 @@
+#include "library_scanner.h"
+#include "iso_metadata_cache.h"
+#include "iso_session.h"
+#include "native_log.h"
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <memory>
+#include <strings.h>
+#include <sys/stat.h>
+
+#define LOG_TAG "LibraryScanner"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const uint32_t MAX_AUTO_WORKERS = 8;
+
+static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LibraryScanner::LibraryScanner(const std::vector<std::string>& roots, const LibraryScanOptions& options)
+    : roots(roots),
+      options(options),
+      running(0),
+      cancelled(false),
+      stopping(false),
+      startNanos(nowNanos()) {
+    // Trabalho de I/O: mais threads que núcleos não atrapalha, mas o
+    // limite por disco é que decide quantas leem ao mesmo tempo
+    if (this->options.workerThreads == 0) {
+        uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        this->options.workerThreads = std::max(2u, std::min(cores, MAX_AUTO_WORKERS));
+    }
+    this->options.ioPerDevice = std::max(1u, this->options.ioPerDevice);
+
+    for (uint32_t i = 0; i < this->options.workerThreads; i++) {
+        workers.emplace_back(&LibraryScanner::workerLoop, this);
+    }
+    discoveryThread = std::thread(&LibraryScanner::discoveryLoop, this);
+
+    LOGD("Library scan started: %zu roots, %u workers, %u reads per device",
+         roots.size(), this->options.workerThreads, this->options.ioPerDevice);
+}
+
+LibraryScanner::~LibraryScanner() {
+    cancel();
+
+    if (discoveryThread.joinable()) {
+        discoveryThread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    resultsAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    LOGD("Library scan stopped");
+}
+
+bool LibraryScanner::isIsoFileName(const std::string& name) {
+    return name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".iso") == 0;
+}
+
+void LibraryScanner::discoveryLoop() {
+    for (const std::string& root : roots) {
+        discover(root, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.discoveryDone = true;
+    }
+    // Nenhum ISO encontrado: quem espera resultados precisa saber que acabou
+    resultsAvailable.notify_all();
+
+    LOGD("Discovery finished: %u ISOs", getProgress().discovered);
+}
+
+void LibraryScanner::discover(const std::string& path, bool isRoot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) {
+            return;
+        }
+    }
+
+    // Raízes podem ser links; dentro delas links para pastas não são
+    // seguidos (evita ciclos)
+    struct stat st;
+    if ((isRoot ? stat(path.c_str(), &st) : lstat(path.c_str(), &st)) != 0) {
+        return;
+    }
+    if (S_ISLNK(st.st_mode)) {
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            return;
+        }
+    }
+
+    if (S_ISREG(st.st_mode)) {
+        // Um arquivo passado diretamente entra mesmo sem a extensão
+        if (isRoot || isIsoFileName(path)) {
+            enqueue(path, st.st_dev);
+        }
+        return;
+    }
+
+    if (!S_ISDIR(st.st_mode) || (!isRoot && !options.recursive)) {
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        LOGE("Cannot open directory: %s", path.c_str());
+        return;
+    }
+
+    std::vector<std::string> names;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.' &&
+            (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0'))) {
+            continue;
+        }
+        names.emplace_back(entry->d_name);
+    }
+    closedir(dir);
+
+    // Ordem estável entre varreduras
+    std::sort(names.begin(), names.end());
+
+    std::string prefix = path.back() == '/' ? path : path + "/";
+    for (const std::string& name : names) {
+        discover(prefix + name, false);
+    }
+}
+
+void LibraryScanner::enqueue(const std::string& isoPath, dev_t device) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) {
+            return;
+        }
+        queue.push_back({progress.discovered, isoPath, device});
+        progress.discovered++;
+    }
+    workAvailable.notify_one();
+}
+
+bool LibraryScanner::pickNext(PendingIso& pending) {
+    // Primeiro ISO da fila cujo disco ainda tem leituras livres
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        auto busy = busyDevices.find(it->device);
+        if (busy == busyDevices.end() || busy->second < options.ioPerDevice) {
+            pending = std::move(*it);
+            queue.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LibraryScanner::isFinished() const {
+    return progress.discoveryDone && queue.empty() && running == 0;
+}
+
+void LibraryScanner::workerLoop() {
+    Iso2GodConverter converter;
+
+    for (;;) {
+        PendingIso pending;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this, &pending] {
+                return stopping || pickNext(pending);
+            });
+            if (stopping) {
+                return;
+            }
+            running++;
+            busyDevices[pending.device]++;
+        }
+
+        LibraryScanResult result;
+        scanOne(pending, converter, result);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyDevices[pending.device] == 0) {
+                busyDevices.erase(pending.device);
+            }
+            running--;
+
+            progress.completed++;
+            if (!result.ok) {
+                progress.failed++;
+            }
+            if (result.fromCache) {
+                progress.cacheHits++;
+            }
+            results.push_back(std::move(result));
+        }
+        // Disco liberado: outro worker pode ter um ISO que agora cabe
+        workAvailable.notify_all();
+        resultsAvailable.notify_all();
+    }
+}
+
+void LibraryScanner::scanOne(const PendingIso& pending, Iso2GodConverter& converter, LibraryScanResult& result) {
+    uint64_t start = nowNanos();
+
+    result.index = pending.index;
+    result.isoPath = pending.isoPath;
+
+    // Só stat() no acerto. Na falta a sessão abre sem cache (senão
+    // consultaria o mesmo .meta de novo) e o resultado é gravado aqui
+    IsoMetadataCache cache(options.metadataCacheDir);
+    if (cache.lookup(pending.isoPath, result.info)) {
+        result.ok = true;
+        result.fromCache = true;
+    } else {
+        std::unique_ptr<IsoSession> session = converter.openSession(pending.isoPath);
+        if (session) {
+            result.info = session->getInfo();
+            result.ok = true;
+            cache.store(session->getSource(), session->getInfo(), session->getGdf());
+        } else {
+            LOGE("Failed to read ISO info: %s", pending.isoPath.c_str());
+        }
+    }
+
+    result.seconds = (nowNanos() - start) / 1e9;
+}
+
+bool LibraryScanner::nextResults(std::vector<LibraryScanResult>& out, uint32_t timeoutMs) {
+    out.clear();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    resultsAvailable.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+        return !results.empty() || isFinished() || stopping;
+    });
+
+    if (!results.empty()) {
+        out.swap(results);
+        return true;
+    }
+    return !isFinished() && !stopping;
+}
+
+LibraryScanProgress LibraryScanner::getProgress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    LibraryScanProgress snapshot = progress;
+    snapshot.elapsedSeconds = (nowNanos() - startNanos) / 1e9;
+    return snapshot;
+}
+
+void LibraryScanner::cancel() {
+    size_t dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dropped = queue.size();
+        queue.clear();
+        // A descoberta para no próximo arquivo
+        cancelled = true;
+    }
+    resultsAvailable.notify_all();
+
+    if (dropped > 0) {
+        LOGD("Library scan cancelled, %zu ISOs dropped", dropped);
+    }
+}
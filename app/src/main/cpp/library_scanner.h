@@ -0,0 +1,115 @@
+#ifndef LIBRARY_SCANNER_H
+#define LIBRARY_SCANNER_H
+
+#include "iso2god_converter.h"
+#include <sys/types.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LibraryScanOptions {
+    // Threads que leem os ISOs (0 = automático)
+    uint32_t workerThreads = 0;
+
+    // Leituras simultâneas por disco (st_dev): num cartão SD mais de uma ou
+    // duas só disputam a mesma fila e aumentam a latência de cada ISO
+    uint32_t ioPerDevice = 2;
+
+    // Descer nas subpastas das pastas informadas
+    bool recursive = true;
+
+    // Pasta do IsoMetadataCache; vazio = sem cache
+    std::string metadataCacheDir;
+};
+
+// Um ISO examinado (na ordem em que terminou, não na da descoberta)
+struct LibraryScanResult {
+    uint32_t index = 0;          // ordem de descoberta
+    std::string isoPath;
+    bool ok = false;             // info válido
+    bool fromCache = false;
+    IsoInfo info;
+    double seconds = 0.0;        // leitura deste ISO, sem a espera na fila
+};
+
+struct LibraryScanProgress {
+    uint32_t discovered = 0;
+    uint32_t completed = 0;      // inclui as falhas
+    uint32_t failed = 0;
+    uint32_t cacheHits = 0;
+    bool discoveryDone = false;
+    double elapsedSeconds = 0.0;
+};
+
+// Varredura de uma biblioteca de ISOs: descobre os arquivos .iso das
+// pastas (ou caminhos) informados e extrai o IsoInfo de cada um em
+// paralelo.
+//
+// Uma thread de descoberta percorre as pastas e enfileira cada ISO assim
+// que o encontra, e um conjunto fixo de workers consome a fila. Como no
+// BatchConverter, um worker só pega um ISO cujo disco (st_dev) tem menos
+// de ioPerDevice leituras em andamento, então uma pasta no cartão SD e
+// outra no armazenamento interno são lidas ao mesmo tempo sem afogar o
+// cartão. Com o cache de metadados um ISO já visto custa só um stat.
+//
+// Os resultados ficam disponíveis à medida que terminam: nextResults()
+// entrega em lote tudo o que chegou desde a última chamada, o que deixa
+// uma travessia JNI por lote em vez de uma por arquivo.
+class LibraryScanner {
+public:
+    LibraryScanner(const std::vector<std::string>& roots, const LibraryScanOptions& options);
+    ~LibraryScanner();
+
+    // Espera até timeoutMs por resultados novos e os move para out. false
+    // quando a varredura acabou e todos os resultados já foram entregues.
+    bool nextResults(std::vector<LibraryScanResult>& out, uint32_t timeoutMs);
+
+    LibraryScanProgress getProgress() const;
+
+    // Para a descoberta e descarta o que está na fila; as leituras em
+    // andamento terminam e os seus resultados ainda são entregues
+    void cancel();
+
+    static bool isIsoFileName(const std::string& name);
+
+private:
+    struct PendingIso {
+        uint32_t index;
+        std::string isoPath;
+        dev_t device;
+    };
+
+    std::vector<std::string> roots;
+    LibraryScanOptions options;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable resultsAvailable;
+    std::deque<PendingIso> queue;
+    std::vector<LibraryScanResult> results;
+    std::map<dev_t, uint32_t> busyDevices;
+    uint32_t running;
+    bool cancelled;
+    bool stopping;
+
+    LibraryScanProgress progress;
+    uint64_t startNanos;
+
+    std::thread discoveryThread;
+    std::vector<std::thread> workers;
+
+    void discoveryLoop();
+    void discover(const std::string& path, bool isRoot);
+    void enqueue(const std::string& isoPath, dev_t device);
+    bool pickNext(PendingIso& pending);
+    void workerLoop();
+    void scanOne(const PendingIso& pending, Iso2GodConverter& converter, LibraryScanResult& result);
+    bool isFinished() const;
+};
+
+#endif // LIBRARY_SCANNER_H
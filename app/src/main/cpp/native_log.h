@@ -0,0 +1,56 @@
+#ifndef NATIVE_LOG_H
+#define NATIVE_LOG_H
+
+// Log da biblioteca nativa: logcat no Android e stderr no host (Linux),
+// onde o código roda nos benchmarks. No host as mensagens de debug só
+// aparecem com ISO2GOD_LOG_DEBUG=1 no ambiente, para não distorcer as
+// medições.
+//
+// Cada arquivo define LOG_TAG e os seus LOGD/LOGE em cima de NATIVE_LOG.
+
+#if defined(__ANDROID__)
+
+#include <android/log.h>
+
+#define NATIVE_LOG_DEBUG ANDROID_LOG_DEBUG
+#define NATIVE_LOG_ERROR ANDROID_LOG_ERROR
+#define NATIVE_LOG(priority, tag, ...) __android_log_print(priority, tag, __VA_ARGS__)
+
+#else
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define NATIVE_LOG_DEBUG 3
+#define NATIVE_LOG_ERROR 6
+#define NATIVE_LOG(priority, tag, ...) nativeLogPrint(priority, tag, __VA_ARGS__)
+
+__attribute__((format(printf, 3, 4)))
+inline void nativeLogPrint(int priority, const char* tag, const char* format, ...) {
+    static const bool debugEnabled = [] {
+        const char* value = getenv("ISO2GOD_LOG_DEBUG");
+        return value && strcmp(value, "0") != 0;
+    }();
+
+    if (priority < NATIVE_LOG_ERROR && !debugEnabled) {
+        return;
+    }
+
+    // Uma linha por chamada: monta antes de escrever, para threads não
+    // intercalarem pedaços de mensagens
+    char line[1024];
+    int prefix = snprintf(line, sizeof(line), "%c/%s: ", priority >= NATIVE_LOG_ERROR ? 'E' : 'D', tag);
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line + prefix, sizeof(line) - prefix, format, args);
+    va_end(args);
+
+    fprintf(stderr, "%s\n", line);
+}
+
+#endif
+
+#endif // NATIVE_LOG_H
@@ -0,0 +1,192 @@
+#include "payload_copier.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef __ANDROID__
+#include <android/api-level.h>
+#endif
+
+#define LOG_TAG "PayloadCopier"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// Erros que indicam "método não suportado aqui" e não falha de I/O
+static bool isUnsupportedError(int error) {
+    return error == ENOSYS || error == EXDEV || error == EINVAL ||
+           error == EOPNOTSUPP || error == ENOTSUP;
+}
+
+PayloadCopier::PayloadCopier(IsoSource& source, PayloadCopyMode mode)
+    : source(source),
+      method(mode == PayloadCopyMode::KernelCopy ? Method::CopyFileRange : Method::Write),
+      kernelCopiedBytes(0),
+      writtenBytes(0) {
+#ifndef __NR_copy_file_range
+    if (method == Method::CopyFileRange) {
+        method = Method::SendFile;
+    }
+#endif
+#ifdef __ANDROID__
+    // Abaixo da API 34 o filtro seccomp dos apps pode matar o processo com
+    // SIGSYS em vez de devolver ENOSYS: nem tenta, vai direto ao sendfile
+    if (method == Method::CopyFileRange && android_get_device_api_level() < 34) {
+        method = Method::SendFile;
+    }
+#endif
+}
+
+const char* PayloadCopier::getMethodName() const {
+    switch (method) {
+        case Method::CopyFileRange: return "copy_file_range";
+        case Method::SendFile: return "sendfile";
+        case Method::Write: return "write";
+    }
+    return "unknown";
+}
+
+PayloadCopier::CopyResult PayloadCopier::copyFileRange(
+    int outFd,
+    uint64_t& outOffset,
+    uint64_t& isoOffset,
+    size_t& length
+) {
+#ifdef __NR_copy_file_range
+    // Via syscall: o wrapper da bionic só existe a partir da API 34 (o
+    // construtor já descarta o método em aparelhos mais antigos)
+    while (length > 0) {
+        loff_t inOff = isoOffset;
+        loff_t outOff = outOffset;
+        long copied = syscall(__NR_copy_file_range, source.getFd(), &inOff, outFd, &outOff, length, 0u);
+
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (isUnsupportedError(errno)) {
+                return CopyResult::Unsupported;
+            }
+            LOGE("copy_file_range failed at ISO offset %llu: %s",
+                 (unsigned long long)isoOffset, strerror(errno));
+            return CopyResult::Failed;
+        }
+        if (copied == 0) {
+            // Não avançou (ex.: sistema de arquivos sem suporte devolvendo 0)
+            return CopyResult::Unsupported;
+        }
+
+        isoOffset += copied;
+        outOffset += copied;
+        length -= copied;
+        kernelCopiedBytes += copied;
+    }
+    return CopyResult::Done;
+#else
+    (void)outFd;
+    (void)outOffset;
+    (void)isoOffset;
+    (void)length;
+    return CopyResult::Unsupported;
+#endif
+}
+
+PayloadCopier::CopyResult PayloadCopier::sendFile(
+    int outFd,
+    uint64_t& outOffset,
+    uint64_t& isoOffset,
+    size_t& length
+) {
+    // sendfile escreve na posição atual do arquivo de saída
+    if (lseek64(outFd, (off64_t)outOffset, SEEK_SET) < 0) {
+        LOGE("lseek failed on output: %s", strerror(errno));
+        return CopyResult::Failed;
+    }
+
+    while (length > 0) {
+        off64_t inOff = isoOffset;
+        ssize_t copied = sendfile64(outFd, source.getFd(), &inOff, length);
+
+        if (copied < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            if (isUnsupportedError(errno)) {
+                return CopyResult::Unsupported;
+            }
+            LOGE("sendfile failed at ISO offset %llu: %s",
+                 (unsigned long long)isoOffset, strerror(errno));
+            return CopyResult::Failed;
+        }
+        if (copied == 0) {
+            return CopyResult::Unsupported;
+        }
+
+        isoOffset += copied;
+        outOffset += copied;
+        length -= copied;
+        kernelCopiedBytes += copied;
+    }
+    return CopyResult::Done;
+}
+
+bool PayloadCopier::writeFrom(int outFd, uint64_t outOffset, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = pwrite64(outFd, data, length, (off64_t)outOffset);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGE("pwrite failed at output offset %llu: %s",
+                 (unsigned long long)outOffset, strerror(errno));
+            return false;
+        }
+
+        data += written;
+        outOffset += written;
+        length -= written;
+        writtenBytes += written;
+    }
+    return true;
+}
+
+bool PayloadCopier::copy(
+    int outFd,
+    uint64_t outOffset,
+    uint64_t isoOffset,
+    const uint8_t* data,
+    size_t length
+) {
+    const uint64_t startIsoOffset = isoOffset;
+
+    if (method == Method::CopyFileRange) {
+        CopyResult result = copyFileRange(outFd, outOffset, isoOffset, length);
+        if (result == CopyResult::Failed) {
+            return false;
+        }
+        if (result == CopyResult::Unsupported) {
+            LOGD("copy_file_range not supported here, falling back to sendfile");
+            method = Method::SendFile;
+        }
+    }
+
+    if (method == Method::SendFile && length > 0) {
+        CopyResult result = sendFile(outFd, outOffset, isoOffset, length);
+        if (result == CopyResult::Failed) {
+            return false;
+        }
+        if (result == CopyResult::Unsupported) {
+            LOGD("sendfile not supported here, falling back to write");
+            method = Method::Write;
+        }
+    }
+
+    if (length == 0) {
+        return true;
+    }
+
+    // Resto da faixa a partir da memória
+    return writeFrom(outFd, outOffset, data + (isoOffset - startIsoOffset), length);
+}
@@ -0,0 +1,54 @@
+#ifndef PAYLOAD_COPIER_H
+#define PAYLOAD_COPIER_H
+
+#include "iso_source.h"
+#include <cstdint>
+#include <cstddef>
+
+// Como os bytes do ISO chegam às partes DataNNNN
+enum class PayloadCopyMode {
+    Buffered,   // write a partir da memória (mapeamento ou buffer de leitura)
+    KernelCopy  // copy_file_range/sendfile: o kernel copia sem passar pelo processo
+};
+
+// Copia faixas do ISO para os arquivos de saída. No modo KernelCopy tenta
+// copy_file_range (reflink em btrfs/XFS no mesmo sistema de arquivos; no
+// Android só a partir da API 34), depois sendfile, e por fim cai para pwrite a partir da memória. Uma
+// falha de "não suportado" rebaixa o método para o resto da conversão.
+class PayloadCopier {
+public:
+    PayloadCopier(IsoSource& source, PayloadCopyMode mode);
+
+    // Copia length bytes do ISO (a partir de isoOffset) para outFd em
+    // outOffset. data aponta para os mesmos bytes já em memória, usados
+    // quando a cópia pelo kernel não está disponível.
+    bool copy(int outFd, uint64_t outOffset, uint64_t isoOffset, const uint8_t* data, size_t length);
+
+    const char* getMethodName() const;
+    uint64_t getKernelCopiedBytes() const { return kernelCopiedBytes; }
+    uint64_t getWrittenBytes() const { return writtenBytes; }
+
+private:
+    enum class Method {
+        CopyFileRange,
+        SendFile,
+        Write
+    };
+
+    enum class CopyResult {
+        Done,
+        Unsupported,  // faixa restante fica para o próximo método
+        Failed
+    };
+
+    IsoSource& source;
+    Method method;
+    uint64_t kernelCopiedBytes;
+    uint64_t writtenBytes;
+
+    CopyResult copyFileRange(int outFd, uint64_t& outOffset, uint64_t& isoOffset, size_t& length);
+    CopyResult sendFile(int outFd, uint64_t& outOffset, uint64_t& isoOffset, size_t& length);
+    bool writeFrom(int outFd, uint64_t outOffset, const uint8_t* data, size_t length);
+};
+
+#endif // PAYLOAD_COPIER_H
@@ -0,0 +1,100 @@
+#include "sha1_backends.h"
+
+// Este arquivo é compilado com -march=armv8-a+crypto. Não incluir headers
+// da STL aqui: funções inline instanciadas com essas flags poderiam ser
+// escolhidas pelo linker para o resto da biblioteca.
+
+#if defined(ISO2GOD_HAVE_SHA1_ARMV8)
+
+#include <arm_neon.h>
+
+// Um grupo de 4 rounds: eNext = sha1h(a) é o E do próximo grupo,
+// eCur + wk (W + K já somados) alimentam sha1c/sha1p/sha1m.
+#define SHA1_ARM_ROUNDS(op, eCur, eNext, wk)       \
+    eNext = vsha1h_u32(vgetq_lane_u32(abcd, 0));   \
+    abcd = op(abcd, eCur, wk)
+
+void sha1ProcessBlocksArmv8(uint32_t state[5], const uint8_t* data, size_t numBlocks) {
+    const uint32x4_t k0 = vdupq_n_u32(0x5A827999);
+    const uint32x4_t k1 = vdupq_n_u32(0x6ED9EBA1);
+    const uint32x4_t k2 = vdupq_n_u32(0x8F1BBCDC);
+    const uint32x4_t k3 = vdupq_n_u32(0xCA62C1D6);
+
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e0 = state[4];
+    uint32_t e1;
+
+    uint32x4_t msg0, msg1, msg2, msg3;
+    uint32x4_t tmp0, tmp1;
+
+    while (numBlocks--) {
+        const uint32x4_t abcdSaved = abcd;
+        const uint32_t e0Saved = e0;
+
+        // Carregar 16 palavras big-endian
+        msg0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 0)));
+        msg1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+        msg2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+        msg3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+
+        tmp0 = vaddq_u32(msg0, k0);
+        tmp1 = vaddq_u32(msg1, k0);
+
+        // Rounds 0-3
+        SHA1_ARM_ROUNDS(vsha1cq_u32, e0, e1, tmp0);
+        tmp0 = vaddq_u32(msg2, k0);
+        msg0 = vsha1su0q_u32(msg0, msg1, msg2);
+
+        // Rounds 4-63: expansão da mensagem intercalada com os rounds
+#define SHA1_ARM_STEP(op, eCur, eNext, tmp, k, mDone, mSu0, mA, mB) \
+        SHA1_ARM_ROUNDS(op, eCur, eNext, tmp);                       \
+        tmp = vaddq_u32(mB, k);                                      \
+        mDone = vsha1su1q_u32(mDone, mB);                            \
+        mSu0 = vsha1su0q_u32(mSu0, mA, mB)
+
+        SHA1_ARM_STEP(vsha1cq_u32, e1, e0, tmp1, k0, msg0, msg1, msg2, msg3); // 4-7
+        SHA1_ARM_STEP(vsha1cq_u32, e0, e1, tmp0, k0, msg1, msg2, msg3, msg0); // 8-11
+        SHA1_ARM_STEP(vsha1cq_u32, e1, e0, tmp1, k1, msg2, msg3, msg0, msg1); // 12-15
+        SHA1_ARM_STEP(vsha1cq_u32, e0, e1, tmp0, k1, msg3, msg0, msg1, msg2); // 16-19
+        SHA1_ARM_STEP(vsha1pq_u32, e1, e0, tmp1, k1, msg0, msg1, msg2, msg3); // 20-23
+        SHA1_ARM_STEP(vsha1pq_u32, e0, e1, tmp0, k1, msg1, msg2, msg3, msg0); // 24-27
+        SHA1_ARM_STEP(vsha1pq_u32, e1, e0, tmp1, k1, msg2, msg3, msg0, msg1); // 28-31
+        SHA1_ARM_STEP(vsha1pq_u32, e0, e1, tmp0, k2, msg3, msg0, msg1, msg2); // 32-35
+        SHA1_ARM_STEP(vsha1pq_u32, e1, e0, tmp1, k2, msg0, msg1, msg2, msg3); // 36-39
+        SHA1_ARM_STEP(vsha1mq_u32, e0, e1, tmp0, k2, msg1, msg2, msg3, msg0); // 40-43
+        SHA1_ARM_STEP(vsha1mq_u32, e1, e0, tmp1, k2, msg2, msg3, msg0, msg1); // 44-47
+        SHA1_ARM_STEP(vsha1mq_u32, e0, e1, tmp0, k2, msg3, msg0, msg1, msg2); // 48-51
+        SHA1_ARM_STEP(vsha1mq_u32, e1, e0, tmp1, k3, msg0, msg1, msg2, msg3); // 52-55
+        SHA1_ARM_STEP(vsha1mq_u32, e0, e1, tmp0, k3, msg1, msg2, msg3, msg0); // 56-59
+        SHA1_ARM_STEP(vsha1pq_u32, e1, e0, tmp1, k3, msg2, msg3, msg0, msg1); // 60-63
+#undef SHA1_ARM_STEP
+
+        // Rounds 64-67
+        SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, tmp0);
+        tmp0 = vaddq_u32(msg2, k3);
+        msg3 = vsha1su1q_u32(msg3, msg2);
+
+        // Rounds 68-71
+        SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, tmp1);
+        tmp1 = vaddq_u32(msg3, k3);
+
+        // Rounds 72-75
+        SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, tmp0);
+
+        // Rounds 76-79
+        SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, tmp1);
+
+        // Somar ao estado anterior
+        e0 += e0Saved;
+        abcd = vaddq_u32(abcdSaved, abcd);
+
+        data += 64;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e0;
+}
+
+#undef SHA1_ARM_ROUNDS
+
+#endif // ISO2GOD_HAVE_SHA1_ARMV8
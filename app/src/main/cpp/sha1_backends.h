@@ -0,0 +1,43 @@
+#ifndef SHA1_BACKENDS_H
+#define SHA1_BACKENDS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Kernels de compressão SHA-1 (blocos completos de 64 bytes).
+// Uso interno do HashUtils: cada kernel acelerado fica em seu próprio
+// arquivo, compilado com as flags da ISA correspondente, e só é chamado
+// depois da detecção de CPU em runtime.
+
+typedef void (*Sha1BlockFunc)(uint32_t state[5], const uint8_t* data, size_t numBlocks);
+
+#if defined(ISO2GOD_HAVE_SHA1_SHANI)
+// x86 SHA-NI (requer SHA + SSSE3 + SSE4.1)
+void sha1ProcessBlocksShaNi(uint32_t state[5], const uint8_t* data, size_t numBlocks);
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_ARMV8)
+// ARMv8 Crypto Extensions (sha1c/sha1p/sha1m)
+void sha1ProcessBlocksArmv8(uint32_t state[5], const uint8_t* data, size_t numBlocks);
+#endif
+
+// Kernels multi-buffer: SHA-1 completo de N mensagens de mesmo tamanho,
+// uma por lane SIMD. hashesOut recebe N digests de 20 bytes em sequência.
+typedef void (*Sha1MultiBufferFunc)(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut);
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_AVX2)
+// 8 lanes (AVX2)
+void sha1HashMultiBufferAvx2x8(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut);
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_SSSE3)
+// 4 lanes (SSSE3)
+void sha1HashMultiBufferSsse3x4(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut);
+#endif
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_NEON)
+// 4 lanes (NEON)
+void sha1HashMultiBufferNeonx4(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut);
+#endif
+
+#endif // SHA1_BACKENDS_H
@@ -0,0 +1,69 @@
+#include "sha1_backends.h"
+
+// Este arquivo é compilado com -mavx2. Não incluir headers da STL aqui:
+// funções inline instanciadas com essas flags poderiam ser escolhidas pelo
+// linker para o resto da biblioteca.
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_AVX2)
+
+#include "sha1_mb_kernel.h"
+#include <immintrin.h>
+
+namespace {
+
+// 8 lanes de 32 bits em um registrador AVX2
+struct Avx2x8 {
+    typedef __m256i Vec;
+    static const size_t LANES = 8;
+
+    static inline Vec set1(uint32_t x) { return _mm256_set1_epi32((int)x); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static inline Vec bitXor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static inline Vec bitAnd(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static inline Vec bitOr(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static inline Vec rol1(Vec x) { return _mm256_or_si256(_mm256_slli_epi32(x, 1), _mm256_srli_epi32(x, 31)); }
+    static inline Vec rol5(Vec x) { return _mm256_or_si256(_mm256_slli_epi32(x, 5), _mm256_srli_epi32(x, 27)); }
+    static inline Vec rol30(Vec x) { return _mm256_or_si256(_mm256_slli_epi32(x, 30), _mm256_srli_epi32(x, 2)); }
+    static inline void store(uint32_t* out, Vec x) { _mm256_storeu_si256((__m256i*)out, x); }
+
+    // Transpõe 16 bytes de 4 lanes em 4 palavras (uma lane por elemento)
+    static inline void transpose4(const uint8_t* const* lanes, size_t pos, __m128i byteSwap, __m128i out[4]) {
+        __m128i r0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[0] + pos)), byteSwap);
+        __m128i r1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[1] + pos)), byteSwap);
+        __m128i r2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[2] + pos)), byteSwap);
+        __m128i r3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[3] + pos)), byteSwap);
+
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+        out[0] = _mm_unpacklo_epi64(t0, t1);
+        out[1] = _mm_unpackhi_epi64(t0, t1);
+        out[2] = _mm_unpacklo_epi64(t2, t3);
+        out[3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    static inline void loadWords(const uint8_t* const* lanes, size_t offset, Vec w[16]) {
+        const __m128i byteSwap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+        for (int k = 0; k < 4; k++) {
+            __m128i lo[4];
+            __m128i hi[4];
+            transpose4(lanes, offset + k * 16, byteSwap, lo);
+            transpose4(lanes + 4, offset + k * 16, byteSwap, hi);
+
+            for (int j = 0; j < 4; j++) {
+                w[k * 4 + j] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo[j]), hi[j], 1);
+            }
+        }
+    }
+};
+
+} // namespace
+
+void sha1HashMultiBufferAvx2x8(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut) {
+    sha1MultiBufferHash<Avx2x8>(messages, messageSize, hashesOut);
+}
+
+#endif // ISO2GOD_HAVE_SHA1_MB_AVX2
@@ -0,0 +1,152 @@
+#ifndef SHA1_MB_KERNEL_H
+#define SHA1_MB_KERNEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Kernel SHA-1 multi-buffer genérico: V::LANES mensagens de mesmo tamanho
+// processadas em paralelo, uma por lane do vetor SIMD. Incluído apenas
+// pelos arquivos sha1_mb_*.cpp, cada um com o seu tipo V:
+//
+//   V::Vec, V::LANES
+//   set1, add, bitXor, bitAnd, bitOr, rol1, rol5, rol30, store
+//   loadWords(lanes, offset, w) - carrega W[0..15] transpostos e big-endian
+
+#define SHA1_MB_F0(b, c, d) V::bitXor(V::bitAnd(V::bitXor(c, d), b), d)
+#define SHA1_MB_F1(b, c, d) V::bitXor(V::bitXor(b, c), d)
+#define SHA1_MB_F2(b, c, d) V::bitOr(V::bitAnd(V::bitOr(b, c), d), V::bitAnd(b, c))
+
+#define SHA1_MB_WORD(i) ((i) < 16 ? w[(i) & 15] :                                     \
+    (w[(i) & 15] = V::rol1(V::bitXor(V::bitXor(w[((i) + 13) & 15], w[((i) + 8) & 15]), \
+                                     V::bitXor(w[((i) + 2) & 15], w[(i) & 15])))))
+
+#define SHA1_MB_ROUND(a, b, c, d, e, i, f, k)                               \
+    e = V::add(V::add(e, V::add(f(b, c, d), SHA1_MB_WORD(i))),               \
+               V::add(k, V::rol5(a)));                                       \
+    b = V::rol30(b)
+
+#define SHA1_MB_ROUNDS5(i, f, k)                      \
+    SHA1_MB_ROUND(a, b, c, d, e, (i) + 0, f, k);      \
+    SHA1_MB_ROUND(e, a, b, c, d, (i) + 1, f, k);      \
+    SHA1_MB_ROUND(d, e, a, b, c, (i) + 2, f, k);      \
+    SHA1_MB_ROUND(c, d, e, a, b, (i) + 3, f, k);      \
+    SHA1_MB_ROUND(b, c, d, e, a, (i) + 4, f, k)
+
+// Processa numBlocks blocos de 64 bytes de cada lane, a partir de offset
+template <typename V>
+inline void sha1MultiBufferBlocks(
+    typename V::Vec state[5],
+    const uint8_t* const* lanes,
+    size_t offset,
+    size_t numBlocks
+) {
+    typedef typename V::Vec Vec;
+
+    const Vec k0 = V::set1(0x5A827999);
+    const Vec k1 = V::set1(0x6ED9EBA1);
+    const Vec k2 = V::set1(0x8F1BBCDC);
+    const Vec k3 = V::set1(0xCA62C1D6);
+
+    for (size_t block = 0; block < numBlocks; block++, offset += 64) {
+        Vec w[16];
+        V::loadWords(lanes, offset, w);
+
+        Vec a = state[0];
+        Vec b = state[1];
+        Vec c = state[2];
+        Vec d = state[3];
+        Vec e = state[4];
+
+        SHA1_MB_ROUNDS5(0, SHA1_MB_F0, k0);
+        SHA1_MB_ROUNDS5(5, SHA1_MB_F0, k0);
+        SHA1_MB_ROUNDS5(10, SHA1_MB_F0, k0);
+        SHA1_MB_ROUNDS5(15, SHA1_MB_F0, k0);
+        SHA1_MB_ROUNDS5(20, SHA1_MB_F1, k1);
+        SHA1_MB_ROUNDS5(25, SHA1_MB_F1, k1);
+        SHA1_MB_ROUNDS5(30, SHA1_MB_F1, k1);
+        SHA1_MB_ROUNDS5(35, SHA1_MB_F1, k1);
+        SHA1_MB_ROUNDS5(40, SHA1_MB_F2, k2);
+        SHA1_MB_ROUNDS5(45, SHA1_MB_F2, k2);
+        SHA1_MB_ROUNDS5(50, SHA1_MB_F2, k2);
+        SHA1_MB_ROUNDS5(55, SHA1_MB_F2, k2);
+        SHA1_MB_ROUNDS5(60, SHA1_MB_F1, k3);
+        SHA1_MB_ROUNDS5(65, SHA1_MB_F1, k3);
+        SHA1_MB_ROUNDS5(70, SHA1_MB_F1, k3);
+        SHA1_MB_ROUNDS5(75, SHA1_MB_F1, k3);
+
+        state[0] = V::add(state[0], a);
+        state[1] = V::add(state[1], b);
+        state[2] = V::add(state[2], c);
+        state[3] = V::add(state[3], d);
+        state[4] = V::add(state[4], e);
+    }
+}
+
+#undef SHA1_MB_ROUNDS5
+#undef SHA1_MB_ROUND
+#undef SHA1_MB_WORD
+#undef SHA1_MB_F2
+#undef SHA1_MB_F1
+#undef SHA1_MB_F0
+
+// SHA-1 completo de V::LANES mensagens de messageSize bytes cada.
+// O padding final é montado em buffers na stack, um por lane.
+template <typename V>
+inline void sha1MultiBufferHash(
+    const uint8_t* const* messages,
+    size_t messageSize,
+    uint8_t* hashesOut
+) {
+    typedef typename V::Vec Vec;
+    const size_t LANES = V::LANES;
+
+    Vec state[5] = {
+        V::set1(0x67452301),
+        V::set1(0xEFCDAB89),
+        V::set1(0x98BADCFE),
+        V::set1(0x10325476),
+        V::set1(0xC3D2E1F0)
+    };
+
+    size_t fullBlocks = messageSize / 64;
+    sha1MultiBufferBlocks<V>(state, messages, 0, fullBlocks);
+
+    size_t tailBytes = messageSize % 64;
+    size_t tailSize = (tailBytes < 56) ? 64 : 128;
+    uint64_t bitLength = (uint64_t)messageSize * 8;
+
+    uint8_t tails[LANES][128];
+    const uint8_t* tailLanes[LANES];
+
+    for (size_t lane = 0; lane < LANES; lane++) {
+        uint8_t* tail = tails[lane];
+        memcpy(tail, messages[lane] + fullBlocks * 64, tailBytes);
+        tail[tailBytes] = 0x80;
+        memset(tail + tailBytes + 1, 0, tailSize - 8 - tailBytes - 1);
+        for (int i = 0; i < 8; i++) {
+            tail[tailSize - 1 - i] = (bitLength >> (i * 8)) & 0xFF;
+        }
+        tailLanes[lane] = tail;
+    }
+
+    sha1MultiBufferBlocks<V>(state, tailLanes, 0, tailSize / 64);
+
+    uint32_t words[5][LANES];
+    for (int i = 0; i < 5; i++) {
+        V::store(words[i], state[i]);
+    }
+
+    // Converter para bytes (big-endian), 20 bytes por lane
+    for (size_t lane = 0; lane < LANES; lane++) {
+        uint8_t* hashOut = hashesOut + lane * 20;
+        for (int i = 0; i < 5; i++) {
+            hashOut[i * 4] = (words[i][lane] >> 24) & 0xFF;
+            hashOut[i * 4 + 1] = (words[i][lane] >> 16) & 0xFF;
+            hashOut[i * 4 + 2] = (words[i][lane] >> 8) & 0xFF;
+            hashOut[i * 4 + 3] = words[i][lane] & 0xFF;
+        }
+    }
+}
+
+#endif // SHA1_MB_KERNEL_H
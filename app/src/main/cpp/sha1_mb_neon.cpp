@@ -0,0 +1,54 @@
+#include "sha1_backends.h"
+
+// Não incluir headers da STL aqui: em armeabi-v7a este arquivo pode ser
+// compilado com flags de NEON diferentes do resto da biblioteca.
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_NEON)
+
+#include "sha1_mb_kernel.h"
+#include <arm_neon.h>
+
+namespace {
+
+// 4 lanes de 32 bits em um registrador NEON
+struct Neonx4 {
+    typedef uint32x4_t Vec;
+    static const size_t LANES = 4;
+
+    static inline Vec set1(uint32_t x) { return vdupq_n_u32(x); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_u32(a, b); }
+    static inline Vec bitXor(Vec a, Vec b) { return veorq_u32(a, b); }
+    static inline Vec bitAnd(Vec a, Vec b) { return vandq_u32(a, b); }
+    static inline Vec bitOr(Vec a, Vec b) { return vorrq_u32(a, b); }
+    static inline Vec rol1(Vec x) { return vsriq_n_u32(vshlq_n_u32(x, 1), x, 31); }
+    static inline Vec rol5(Vec x) { return vsriq_n_u32(vshlq_n_u32(x, 5), x, 27); }
+    static inline Vec rol30(Vec x) { return vsriq_n_u32(vshlq_n_u32(x, 30), x, 2); }
+    static inline void store(uint32_t* out, Vec x) { vst1q_u32(out, x); }
+
+    // 16 bytes de cada lane → 4 palavras transpostas (uma lane por elemento)
+    static inline void loadWords(const uint8_t* const* lanes, size_t offset, Vec w[16]) {
+        for (int k = 0; k < 4; k++) {
+            size_t pos = offset + k * 16;
+            uint32x4_t r0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(lanes[0] + pos)));
+            uint32x4_t r1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(lanes[1] + pos)));
+            uint32x4_t r2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(lanes[2] + pos)));
+            uint32x4_t r3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(lanes[3] + pos)));
+
+            uint32x4x2_t t01 = vtrnq_u32(r0, r1);
+            uint32x4x2_t t23 = vtrnq_u32(r2, r3);
+
+            w[k * 4 + 0] = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+            w[k * 4 + 1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+            w[k * 4 + 2] = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+            w[k * 4 + 3] = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+        }
+    }
+};
+
+} // namespace
+
+void sha1HashMultiBufferNeonx4(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut) {
+    sha1MultiBufferHash<Neonx4>(messages, messageSize, hashesOut);
+}
+
+#endif // ISO2GOD_HAVE_SHA1_MB_NEON
@@ -0,0 +1,59 @@
+#include "sha1_backends.h"
+
+// Este arquivo é compilado com -mssse3. Não incluir headers da STL aqui:
+// funções inline instanciadas com essas flags poderiam ser escolhidas pelo
+// linker para o resto da biblioteca.
+
+#if defined(ISO2GOD_HAVE_SHA1_MB_SSSE3)
+
+#include "sha1_mb_kernel.h"
+#include <tmmintrin.h>
+
+namespace {
+
+// 4 lanes de 32 bits em um registrador SSE
+struct Ssse3x4 {
+    typedef __m128i Vec;
+    static const size_t LANES = 4;
+
+    static inline Vec set1(uint32_t x) { return _mm_set1_epi32((int)x); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static inline Vec bitXor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static inline Vec bitAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static inline Vec bitOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static inline Vec rol1(Vec x) { return _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31)); }
+    static inline Vec rol5(Vec x) { return _mm_or_si128(_mm_slli_epi32(x, 5), _mm_srli_epi32(x, 27)); }
+    static inline Vec rol30(Vec x) { return _mm_or_si128(_mm_slli_epi32(x, 30), _mm_srli_epi32(x, 2)); }
+    static inline void store(uint32_t* out, Vec x) { _mm_storeu_si128((__m128i*)out, x); }
+
+    // 16 bytes de cada lane → 4 palavras transpostas (uma lane por elemento)
+    static inline void loadWords(const uint8_t* const* lanes, size_t offset, Vec w[16]) {
+        const __m128i byteSwap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+        for (int k = 0; k < 4; k++) {
+            size_t pos = offset + k * 16;
+            __m128i r0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[0] + pos)), byteSwap);
+            __m128i r1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[1] + pos)), byteSwap);
+            __m128i r2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[2] + pos)), byteSwap);
+            __m128i r3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(lanes[3] + pos)), byteSwap);
+
+            __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+            __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+            __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+            __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+            w[k * 4 + 0] = _mm_unpacklo_epi64(t0, t1);
+            w[k * 4 + 1] = _mm_unpackhi_epi64(t0, t1);
+            w[k * 4 + 2] = _mm_unpacklo_epi64(t2, t3);
+            w[k * 4 + 3] = _mm_unpackhi_epi64(t2, t3);
+        }
+    }
+};
+
+} // namespace
+
+void sha1HashMultiBufferSsse3x4(const uint8_t* const* messages, size_t messageSize, uint8_t* hashesOut) {
+    sha1MultiBufferHash<Ssse3x4>(messages, messageSize, hashesOut);
+}
+
+#endif // ISO2GOD_HAVE_SHA1_MB_SSSE3
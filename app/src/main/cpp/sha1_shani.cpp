@@ -0,0 +1,104 @@
+#include "sha1_backends.h"
+
+// Este arquivo é compilado com -msha -mssse3 -msse4.1. Não incluir headers
+// da STL aqui: funções inline instanciadas com essas flags poderiam ser
+// escolhidas pelo linker para o resto da biblioteca.
+
+#if defined(ISO2GOD_HAVE_SHA1_SHANI)
+
+#include <immintrin.h>
+
+// Um grupo de 4 rounds. eNext recebe o E da próxima rodada (sha1nexte),
+// eCur é consumido por sha1rnds4 com a função f do grupo.
+#define SHA1_NI_ROUNDS(eCur, eNext, msg, func) \
+    eCur = _mm_sha1nexte_epu32(eCur, msg);     \
+    eNext = abcd;                              \
+    abcd = _mm_sha1rnds4_epu32(abcd, eCur, func)
+
+void sha1ProcessBlocksShaNi(uint32_t state[5], const uint8_t* data, size_t numBlocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+
+    __m128i abcd = _mm_loadu_si128((const __m128i*)state);
+    __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+
+    __m128i e1;
+    __m128i msg0, msg1, msg2, msg3;
+
+    while (numBlocks--) {
+        const __m128i abcdSaved = abcd;
+        const __m128i e0Saved = e0;
+
+        // Rounds 0-3
+        msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), byteSwap);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        // Rounds 4-7
+        msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), byteSwap);
+        SHA1_NI_ROUNDS(e1, e0, msg1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        // Rounds 8-11
+        msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), byteSwap);
+        SHA1_NI_ROUNDS(e0, e1, msg2, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 12-15
+        msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), byteSwap);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        SHA1_NI_ROUNDS(e1, e0, msg3, 0);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 16-63: expansão da mensagem intercalada com os rounds
+#define SHA1_NI_STEP(eCur, eNext, mCur, mNext, mXor, mMsg1, func) \
+        mNext = _mm_sha1msg2_epu32(mNext, mCur);                  \
+        SHA1_NI_ROUNDS(eCur, eNext, mCur, func);                  \
+        mMsg1 = _mm_sha1msg1_epu32(mMsg1, mCur);                  \
+        mXor = _mm_xor_si128(mXor, mCur)
+
+        SHA1_NI_STEP(e0, e1, msg0, msg1, msg2, msg3, 0); // 16-19
+        SHA1_NI_STEP(e1, e0, msg1, msg2, msg3, msg0, 1); // 20-23
+        SHA1_NI_STEP(e0, e1, msg2, msg3, msg0, msg1, 1); // 24-27
+        SHA1_NI_STEP(e1, e0, msg3, msg0, msg1, msg2, 1); // 28-31
+        SHA1_NI_STEP(e0, e1, msg0, msg1, msg2, msg3, 1); // 32-35
+        SHA1_NI_STEP(e1, e0, msg1, msg2, msg3, msg0, 1); // 36-39
+        SHA1_NI_STEP(e0, e1, msg2, msg3, msg0, msg1, 2); // 40-43
+        SHA1_NI_STEP(e1, e0, msg3, msg0, msg1, msg2, 2); // 44-47
+        SHA1_NI_STEP(e0, e1, msg0, msg1, msg2, msg3, 2); // 48-51
+        SHA1_NI_STEP(e1, e0, msg1, msg2, msg3, msg0, 2); // 52-55
+        SHA1_NI_STEP(e0, e1, msg2, msg3, msg0, msg1, 2); // 56-59
+        SHA1_NI_STEP(e1, e0, msg3, msg0, msg1, msg2, 3); // 60-63
+        SHA1_NI_STEP(e0, e1, msg0, msg1, msg2, msg3, 3); // 64-67
+#undef SHA1_NI_STEP
+
+        // Rounds 68-71
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        SHA1_NI_ROUNDS(e1, e0, msg1, 3);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 72-75
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        SHA1_NI_ROUNDS(e0, e1, msg2, 3);
+
+        // Rounds 76-79
+        SHA1_NI_ROUNDS(e1, e0, msg3, 3);
+
+        // Somar ao estado anterior
+        e0 = _mm_sha1nexte_epu32(e0, e0Saved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+
+        data += 64;
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    _mm_storeu_si128((__m128i*)state, abcd);
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#undef SHA1_NI_ROUNDS
+
+#endif // ISO2GOD_HAVE_SHA1_SHANI
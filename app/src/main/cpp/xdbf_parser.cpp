@@ -0,0 +1,144 @@
+#include "xdbf_parser.h"
+#include "native_log.h"
+
+#define LOG_TAG "XdbfParser"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const uint32_t XDBF_MAGIC = 0x58444246;      // "XDBF"
+static const uint32_t XSTC_MAGIC = 0x58535443;      // "XSTC"
+static const uint32_t XSTR_MAGIC = 0x58535452;      // "XSTR"
+static const uint32_t HEADER_SIZE = 24;
+static const uint32_t ENTRY_SIZE = 18;
+static const uint32_t FREE_ENTRY_SIZE = 8;
+static const uint32_t LANGUAGE_ENGLISH = 1;
+
+static uint16_t readUInt16BE(const uint8_t* data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static uint32_t readUInt32BE(const uint8_t* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+static uint64_t readUInt64BE(const uint8_t* data) {
+    return ((uint64_t)readUInt32BE(data) << 32) | readUInt32BE(data + 4);
+}
+
+XdbfParser::XdbfParser() : size(0), dataOffset(0) {
+}
+
+bool XdbfParser::parse(const XdbfReader& reader, uint32_t size) {
+    this->reader = reader;
+    this->size = size;
+    entries.clear();
+
+    std::vector<uint8_t> header;
+    if (size < HEADER_SIZE || !reader(0, HEADER_SIZE, header)) {
+        LOGE("XDBF too small: %u bytes", size);
+        return false;
+    }
+    if (readUInt32BE(&header[0]) != XDBF_MAGIC) {
+        LOGE("Invalid XDBF magic");
+        return false;
+    }
+
+    uint32_t entryTableLength = readUInt32BE(&header[8]);
+    uint32_t entryCount = readUInt32BE(&header[12]);
+    uint32_t freeTableLength = readUInt32BE(&header[16]);
+
+    uint64_t data = HEADER_SIZE + (uint64_t)entryTableLength * ENTRY_SIZE + (uint64_t)freeTableLength * FREE_ENTRY_SIZE;
+    if (entryCount > entryTableLength || data > size) {
+        LOGE("Invalid XDBF tables: %u of %u entries, data at %llu",
+             entryCount, entryTableLength, (unsigned long long)data);
+        return false;
+    }
+    dataOffset = (uint32_t)data;
+
+    // Só as entradas em uso (ficam no começo da tabela)
+    std::vector<uint8_t> table;
+    if (entryCount > 0 && !reader(HEADER_SIZE, entryCount * ENTRY_SIZE, table)) {
+        LOGE("Failed to read XDBF entry table");
+        return false;
+    }
+
+    entries.reserve(entryCount);
+    for (uint32_t i = 0; i < entryCount; i++) {
+        const uint8_t* raw = &table[i * ENTRY_SIZE];
+        Entry entry;
+        entry.nameSpace = readUInt16BE(raw);
+        entry.id = readUInt64BE(raw + 2);
+        entry.offset = readUInt32BE(raw + 10);
+        entry.length = readUInt32BE(raw + 14);
+
+        if ((uint64_t)dataOffset + entry.offset + entry.length > size) {
+            LOGE("XDBF entry %u out of bounds", i);
+            return false;
+        }
+        entries.push_back(entry);
+    }
+
+    LOGD("XDBF parsed: %u entries", entryCount);
+    return true;
+}
+
+const XdbfParser::Entry* XdbfParser::findEntry(uint16_t nameSpace, uint64_t id) const {
+    for (const Entry& entry : entries) {
+        if (entry.nameSpace == nameSpace && entry.id == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool XdbfParser::readEntry(const Entry& entry, std::vector<uint8_t>& out) {
+    return reader(dataOffset + entry.offset, entry.length, out);
+}
+
+bool XdbfParser::findString(uint32_t language, uint16_t stringId, std::string& value) {
+    const Entry* entry = findEntry(NAMESPACE_STRING_TABLE, language);
+    std::vector<uint8_t> table;
+    if (!entry || entry->length < 14 || !readEntry(*entry, table) ||
+        readUInt32BE(&table[0]) != XSTR_MAGIC) {
+        return false;
+    }
+
+    uint16_t count = readUInt16BE(&table[12]);
+    size_t pos = 14;
+    for (uint16_t i = 0; i < count && pos + 4 <= table.size(); i++) {
+        uint16_t id = readUInt16BE(&table[pos]);
+        uint16_t length = readUInt16BE(&table[pos + 2]);
+        pos += 4;
+        if (pos + length > table.size()) {
+            break;
+        }
+        if (id == stringId) {
+            value.assign((const char*)&table[pos], length);
+            return true;
+        }
+        pos += length;
+    }
+    return false;
+}
+
+bool XdbfParser::getTitleName(std::string& name) {
+    uint32_t language = LANGUAGE_ENGLISH;
+
+    // XSTC: idioma padrão do título
+    const Entry* settings = findEntry(NAMESPACE_METADATA, XSTC_MAGIC);
+    std::vector<uint8_t> xstc;
+    if (settings && settings->length >= 16 && readEntry(*settings, xstc) &&
+        readUInt32BE(&xstc[0]) == XSTC_MAGIC) {
+        language = readUInt32BE(&xstc[12]);
+    }
+
+    if (findString(language, (uint16_t)TITLE_ENTRY_ID, name)) {
+        return true;
+    }
+    return language != LANGUAGE_ENGLISH && findString(LANGUAGE_ENGLISH, (uint16_t)TITLE_ENTRY_ID, name);
+}
+
+bool XdbfParser::getTitleIcon(std::vector<uint8_t>& png) {
+    const Entry* entry = findEntry(NAMESPACE_IMAGE, TITLE_ENTRY_ID);
+    return entry && readEntry(*entry, png);
+}
@@ -0,0 +1,52 @@
+#ifndef XDBF_PARSER_H
+#define XDBF_PARSER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Lê [offset, offset + length) do XDBF em out; false se a leitura falhar
+using XdbfReader = std::function<bool(uint32_t offset, uint32_t length, std::vector<uint8_t>& out)>;
+
+// XDBF do título (o resource SPA embutido no default.xex, nomeado pelo
+// title ID). parse() lê só o cabeçalho e a tabela de entradas; o nome e
+// o ícone buscam depois apenas as entradas de que precisam.
+class XdbfParser {
+public:
+    XdbfParser();
+
+    bool parse(const XdbfReader& reader, uint32_t size);
+
+    // Nome do título no idioma padrão do XDBF (XSTC), ou em inglês
+    bool getTitleName(std::string& name);
+
+    // Ícone do título (PNG)
+    bool getTitleIcon(std::vector<uint8_t>& png);
+
+    static const uint16_t NAMESPACE_METADATA = 1;
+    static const uint16_t NAMESPACE_IMAGE = 2;
+    static const uint16_t NAMESPACE_STRING_TABLE = 3;
+
+    // ID do nome e do ícone do título nas tabelas de strings e imagens
+    static const uint64_t TITLE_ENTRY_ID = 0x8000;
+
+private:
+    struct Entry {
+        uint16_t nameSpace;
+        uint64_t id;
+        uint32_t offset;     // relativo ao início da área de dados
+        uint32_t length;
+    };
+
+    XdbfReader reader;
+    uint32_t size;
+    uint32_t dataOffset;
+    std::vector<Entry> entries;
+
+    const Entry* findEntry(uint16_t nameSpace, uint64_t id) const;
+    bool readEntry(const Entry& entry, std::vector<uint8_t>& out);
+    bool findString(uint32_t language, uint16_t stringId, std::string& value);
+};
+
+#endif // XDBF_PARSER_H
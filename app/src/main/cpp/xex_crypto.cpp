@@ -0,0 +1,194 @@
+#include "xex_crypto.h"
+#include "native_log.h"
+#include <cstring>
+
+#define LOG_TAG "XexCrypto"
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+const uint8_t RETAIL_KEY[XexCrypto::KEY_SIZE] = {
+    0x20, 0xB1, 0x85, 0xA5, 0x9D, 0x28, 0xFD, 0xC3,
+    0x40, 0x58, 0x3F, 0xBB, 0x08, 0x96, 0xBF, 0x91
+};
+
+const uint8_t DEVKIT_KEY[XexCrypto::KEY_SIZE] = {0};
+
+const uint32_t ROUNDS = 10;
+const size_t ROUND_KEYS_SIZE = (ROUNDS + 1) * XexCrypto::BLOCK_SIZE;
+
+// Multiplicação em GF(2^8) com o polinômio do AES
+uint8_t gfMultiply(uint8_t a, uint8_t b) {
+    uint8_t result = 0;
+    while (b) {
+        if (b & 1) {
+            result ^= a;
+        }
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+        b >>= 1;
+    }
+    return result;
+}
+
+uint8_t rotateLeft8(uint8_t value, int bits) {
+    return (uint8_t)((value << bits) | (value >> (8 - bits)));
+}
+
+// S-box e inversa geradas uma vez (inverso multiplicativo + transformação
+// afim), em vez de 512 bytes de tabela no código
+struct AesTables {
+    uint8_t sbox[256];
+    uint8_t invSbox[256];
+
+    AesTables() {
+        uint8_t p = 1;
+        uint8_t q = 1;
+        do {
+            // p *= 3, q /= 3: q percorre os inversos de p
+            p = (uint8_t)(p ^ (p << 1) ^ ((p & 0x80) ? 0x1B : 0));
+            q ^= (uint8_t)(q << 1);
+            q ^= (uint8_t)(q << 2);
+            q ^= (uint8_t)(q << 4);
+            if (q & 0x80) {
+                q ^= 0x09;
+            }
+            uint8_t value = q ^ rotateLeft8(q, 1) ^ rotateLeft8(q, 2) ^ rotateLeft8(q, 3) ^ rotateLeft8(q, 4);
+            sbox[p] = value ^ 0x63;
+        } while (p != 1);
+        sbox[0] = 0x63;
+
+        for (int i = 0; i < 256; i++) {
+            invSbox[sbox[i]] = (uint8_t)i;
+        }
+    }
+};
+
+const AesTables& tables() {
+    static const AesTables instance;
+    return instance;
+}
+
+void expandKey(const uint8_t* key, uint8_t* roundKeys) {
+    const uint8_t* sbox = tables().sbox;
+    memcpy(roundKeys, key, XexCrypto::KEY_SIZE);
+
+    uint8_t rcon = 1;
+    for (size_t i = XexCrypto::KEY_SIZE; i < ROUND_KEYS_SIZE; i += 4) {
+        uint8_t word[4];
+        memcpy(word, roundKeys + i - 4, 4);
+
+        if (i % XexCrypto::KEY_SIZE == 0) {
+            // RotWord + SubWord + Rcon
+            uint8_t first = word[0];
+            word[0] = sbox[word[1]] ^ rcon;
+            word[1] = sbox[word[2]];
+            word[2] = sbox[word[3]];
+            word[3] = sbox[first];
+            rcon = gfMultiply(rcon, 2);
+        }
+
+        for (int j = 0; j < 4; j++) {
+            roundKeys[i + j] = roundKeys[i - XexCrypto::KEY_SIZE + j] ^ word[j];
+        }
+    }
+}
+
+void addRoundKey(uint8_t* state, const uint8_t* roundKey) {
+    for (size_t i = 0; i < XexCrypto::BLOCK_SIZE; i++) {
+        state[i] ^= roundKey[i];
+    }
+}
+
+// InvShiftRows + InvSubBytes (estado em colunas: state[coluna * 4 + linha])
+void invShiftSubstitute(uint8_t* state) {
+    const uint8_t* invSbox = tables().invSbox;
+    uint8_t shifted[XexCrypto::BLOCK_SIZE];
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            shifted[column * 4 + row] = invSbox[state[((column - row + 4) % 4) * 4 + row]];
+        }
+    }
+    memcpy(state, shifted, sizeof(shifted));
+}
+
+void invMixColumns(uint8_t* state) {
+    for (int column = 0; column < 4; column++) {
+        uint8_t* c = state + column * 4;
+        uint8_t a0 = c[0];
+        uint8_t a1 = c[1];
+        uint8_t a2 = c[2];
+        uint8_t a3 = c[3];
+        c[0] = gfMultiply(a0, 14) ^ gfMultiply(a1, 11) ^ gfMultiply(a2, 13) ^ gfMultiply(a3, 9);
+        c[1] = gfMultiply(a0, 9) ^ gfMultiply(a1, 14) ^ gfMultiply(a2, 11) ^ gfMultiply(a3, 13);
+        c[2] = gfMultiply(a0, 13) ^ gfMultiply(a1, 9) ^ gfMultiply(a2, 14) ^ gfMultiply(a3, 11);
+        c[3] = gfMultiply(a0, 11) ^ gfMultiply(a1, 13) ^ gfMultiply(a2, 9) ^ gfMultiply(a3, 14);
+    }
+}
+
+void decryptBlock(const uint8_t* roundKeys, const uint8_t* in, uint8_t* out) {
+    uint8_t state[XexCrypto::BLOCK_SIZE];
+    memcpy(state, in, sizeof(state));
+
+    addRoundKey(state, roundKeys + ROUNDS * XexCrypto::BLOCK_SIZE);
+    for (uint32_t round = ROUNDS - 1; round > 0; round--) {
+        invShiftSubstitute(state);
+        addRoundKey(state, roundKeys + round * XexCrypto::BLOCK_SIZE);
+        invMixColumns(state);
+    }
+    invShiftSubstitute(state);
+    addRoundKey(state, roundKeys);
+
+    memcpy(out, state, sizeof(state));
+}
+
+} // namespace
+
+void XexCrypto::deriveSessionKey(KeyType type, const uint8_t* fileKey, uint8_t* sessionKey) {
+    uint8_t roundKeys[ROUND_KEYS_SIZE];
+    expandKey(type == KeyType::Retail ? RETAIL_KEY : DEVKIT_KEY, roundKeys);
+    decryptBlock(roundKeys, fileKey, sessionKey);
+}
+
+void XexCrypto::decryptCbc(const uint8_t* key, const uint8_t* iv, const uint8_t* in, uint8_t* out, size_t size) {
+    uint8_t roundKeys[ROUND_KEYS_SIZE];
+    expandKey(key, roundKeys);
+
+    uint8_t previous[BLOCK_SIZE];
+    memcpy(previous, iv, BLOCK_SIZE);
+
+    for (size_t offset = 0; offset + BLOCK_SIZE <= size; offset += BLOCK_SIZE) {
+        // Guardar o bloco cifrado antes de sobrescrevê-lo (in == out)
+        uint8_t cipher[BLOCK_SIZE];
+        memcpy(cipher, in + offset, BLOCK_SIZE);
+
+        decryptBlock(roundKeys, cipher, out + offset);
+        for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            out[offset + i] ^= previous[i];
+        }
+        memcpy(previous, cipher, BLOCK_SIZE);
+    }
+}
+
+bool XexCrypto::runSelfTest() {
+    // FIPS-197, apêndice C.1
+    uint8_t key[KEY_SIZE];
+    uint8_t expected[BLOCK_SIZE];
+    for (size_t i = 0; i < KEY_SIZE; i++) {
+        key[i] = (uint8_t)i;
+        expected[i] = (uint8_t)(i * 0x11);
+    }
+    const uint8_t cipher[BLOCK_SIZE] = {
+        0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+        0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+    };
+    const uint8_t zeroIv[BLOCK_SIZE] = {0};
+
+    uint8_t plain[BLOCK_SIZE];
+    decryptCbc(key, zeroIv, cipher, plain, BLOCK_SIZE);
+    if (memcmp(plain, expected, BLOCK_SIZE) != 0) {
+        LOGE("AES-128 self-test failed");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef XEX_CRYPTO_H
+#define XEX_CRYPTO_H
+
+#include <cstdint>
+#include <cstddef>
+
+// AES-128 (só decifrar) para a imagem PE do XEX. A chave do arquivo fica
+// no security info cifrada com a chave do console (retail ou devkit); a
+// imagem é cifrada em CBC com IV zero a partir do início dos dados, então
+// qualquer trecho pode ser decifrado sozinho usando o bloco cifrado
+// anterior como IV.
+class XexCrypto {
+public:
+    static const size_t KEY_SIZE = 16;
+    static const size_t BLOCK_SIZE = 16;
+
+    enum class KeyType {
+        Retail,
+        Devkit
+    };
+
+    // Chave de sessão: fileKey decifrada (ECB) com a chave do console
+    static void deriveSessionKey(KeyType type, const uint8_t* fileKey, uint8_t* sessionKey);
+
+    // Decifra size bytes (múltiplo de BLOCK_SIZE) em CBC. iv é o bloco
+    // cifrado que precede in (zeros no início da imagem); in e out podem
+    // ser o mesmo buffer.
+    static void decryptCbc(const uint8_t* key, const uint8_t* iv, const uint8_t* in, uint8_t* out, size_t size);
+
+    // Confere a implementação contra o vetor do FIPS-197
+    static bool runSelfTest();
+};
+
+#endif // XEX_CRYPTO_H
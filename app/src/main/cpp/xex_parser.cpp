@@ -1,15 +1,96 @@
 #include "xex_parser.h"
-#include <android/log.h>
+#include "iso_source.h"
+#include "native_log.h"
+#include <algorithm>
 #include <cstring>
+#include <strings.h>
 #include <sstream>
 #include <iomanip>
 
 #define LOG_TAG "XexParser"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) NATIVE_LOG(NATIVE_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG(NATIVE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-XexParser::XexParser() : valid(false) {
+// Faixas até esta distância do fim do prefixo o estendem; mais longe vão
+// para a janela
+static const uint64_t MAX_PREFIX_GAP = 64 * 1024;
+
+// Cabeçalhos reais têm poucos KiB (os maiores, com muitas bibliotecas
+// importadas, algumas dezenas)
+static const uint32_t MAX_HEADER_SIZE = 1024 * 1024;
+
+XexByteSource::XexByteSource(const uint8_t* data, uint64_t size)
+    : data(data), source(nullptr), baseOffset(0), size(size), bytesRead(0), windowOffset(0) {
+}
+
+XexByteSource::XexByteSource(IsoSource& source, uint64_t offset, uint64_t size)
+    : data(nullptr), source(&source), baseOffset(offset), size(size), bytesRead(0), windowOffset(0) {
+}
+
+const uint8_t* XexByteSource::fetch(uint64_t offset, uint32_t length) {
+    if (offset > size || length > size - offset) {
+        return nullptr;
+    }
+    
+    if (data) {
+        return data + offset;
+    }
+    
+    // Com o ISO mapeado só as páginas tocadas são lidas pelo kernel
+    if (source->isMapped()) {
+        bytesRead += length;
+        return source->view(baseOffset + offset, length, (uint8_t*)nullptr);
+    }
+    
+    uint64_t end = offset + length;
+    if (end <= prefix.size()) {
+        return prefix.data() + offset;
+    }
+    if (offset <= prefix.size() + MAX_PREFIX_GAP) {
+        return extend(prefix, 0, offset, end);
+    }
+    
+    if (offset >= windowOffset && end <= windowOffset + window.size()) {
+        return window.data() + (offset - windowOffset);
+    }
+    window.clear();
+    windowOffset = offset;
+    return extend(window, windowOffset, offset, end);
+}
+
+const uint8_t* XexByteSource::extend(std::vector<uint8_t>& buffer, uint64_t bufferOffset, uint64_t offset, uint64_t end) {
+    size_t have = buffer.size();
+    uint64_t readOffset = bufferOffset + have;
+    
+    // Leituras em múltiplos de READ_GRANULARITY: o próximo registro quase
+    // sempre cai no que já veio
+    uint64_t readEnd = (end + READ_GRANULARITY - 1) / READ_GRANULARITY * READ_GRANULARITY;
+    if (readEnd > size) {
+        readEnd = size;
+    }
+    
+    buffer.resize((size_t)(readEnd - bufferOffset));
+    if (!source->view(baseOffset + readOffset, (size_t)(readEnd - readOffset), buffer.data() + have)) {
+        LOGE("Failed to read XEX bytes at 0x%llX", (unsigned long long)readOffset);
+        buffer.resize(have);
+        return nullptr;
+    }
+    bytesRead += readEnd - readOffset;
+    
+    return buffer.data() + (offset - bufferOffset);
+}
+
+XexParser::XexParser()
+    : valid(false),
+      bytes(nullptr),
+      peDataOffset(0),
+      securityInfoOffset(0),
+      imageAccess(ImageAccess::Unknown),
+      encrypted(false),
+      imageSize(0),
+      titleResourceState(0) {
     memset(&execInfo, 0, sizeof(XexExecutionInfo));
+    memset(sessionKey, 0, sizeof(sessionKey));
 }
 
 XexParser::~XexParser() {
@@ -23,8 +104,24 @@ uint32_t XexParser::readUInt32BE(const uint8_t* data) {
 }
 
 bool XexParser::parse(const uint8_t* xexData, size_t size) {
-    if (size < 24) {
-        LOGE("XEX file too small: %zu bytes", size);
+    ownedBytes.reset(new XexByteSource(xexData, size));
+    return parse(*ownedBytes);
+}
+
+bool XexParser::parse(XexByteSource& bytes) {
+    this->bytes = &bytes;
+    valid = false;
+    header.clear();
+    optionalHeaders.clear();
+    imageAccess = ImageAccess::Unknown;
+    imageBlocks.clear();
+    imageSize = 0;
+    titleResourceState = 0;
+    
+    uint64_t size = bytes.getSize();
+    const uint8_t* xexData = bytes.fetch(0, 24);
+    if (!xexData) {
+        LOGE("XEX file too small: %llu bytes", (unsigned long long)size);
         return false;
     }
     
@@ -36,61 +133,393 @@ bool XexParser::parse(const uint8_t* xexData, size_t size) {
     
     LOGD("Valid XEX2 header found");
     
+    // Início da imagem PE (offset 8): tudo antes dela é cabeçalho
+    peDataOffset = readUInt32BE(&xexData[8]);
+    
     // Ler offset do certificado (offset 16, big-endian)
-    uint32_t certOffset = readUInt32BE(&xexData[16]);
+    securityInfoOffset = readUInt32BE(&xexData[16]);
     
     // Ler número de optional headers (offset 20, big-endian)
     uint32_t optHeaderCount = readUInt32BE(&xexData[20]);
     
-    LOGD("Certificate offset: 0x%X, Optional headers: %u", certOffset, optHeaderCount);
+    LOGD("Certificate offset: 0x%X, Optional headers: %u", securityInfoOffset, optHeaderCount);
     
-    // Procurar por ExecutionInfo (signature: 0x00040006)
-    const uint8_t execInfoSig[4] = {0x00, 0x04, 0x00, 0x06};
+    // Headers começam no offset 24 e a tabela fica dentro do cabeçalho
+    uint64_t tableEnd = 24 + (uint64_t)optHeaderCount * 8;
+    uint64_t headerSize = peDataOffset;
+    if (tableEnd > peDataOffset || peDataOffset > size || peDataOffset > MAX_HEADER_SIZE) {
+        // Sem um início de PE válido o XEX inteiro (limitado) vale como
+        // cabeçalho, e a imagem fica inacessível
+        LOGD("Invalid PE data offset 0x%X, using whole XEX as header", peDataOffset);
+        headerSize = std::min<uint64_t>(size, MAX_HEADER_SIZE);
+        peDataOffset = 0;
+    }
+    if (tableEnd > headerSize) {
+        LOGE("XEX optional header table out of bounds (%u headers)", optHeaderCount);
+        return false;
+    }
     
-    uint32_t pos = 24; // Headers começam no offset 24
+    // Cabeçalho inteiro numa leitura: os registros apontados pela tabela
+    // e o security info estão todos nele
+    const uint8_t* headerData = bytes.fetch(0, (uint32_t)headerSize);
+    if (!headerData) {
+        LOGE("Failed to read XEX header (%llu bytes)", (unsigned long long)headerSize);
+        return false;
+    }
+    header.assign(headerData, headerData + headerSize);
     
-    for (uint32_t i = 0; i < optHeaderCount && pos + 8 <= size; i++) {
-        // Ler signature (4 bytes, big-endian)
-        uint32_t signature = readUInt32BE(&xexData[pos]);
-        uint32_t dataOffset = readUInt32BE(&xexData[pos + 4]);
+    optionalHeaders.reserve(optHeaderCount);
+    for (uint32_t i = 0; i < optHeaderCount; i++) {
+        XexOptionalHeader entry;
+        entry.key = readUInt32BE(&header[24 + i * 8]);
+        entry.value = readUInt32BE(&header[24 + i * 8 + 4]);
+        entry.tableOffset = 24 + i * 8;
+        optionalHeaders.push_back(entry);
+    }
+    std::stable_sort(optionalHeaders.begin(), optionalHeaders.end(),
+                     [](const XexOptionalHeader& a, const XexOptionalHeader& b) { return a.key < b.key; });
+    
+    uint32_t recordSize;
+    const uint8_t* record = getOptionalHeaderData(HEADER_EXECUTION_INFO, recordSize);
+    if (!record) {
+        LOGE("ExecutionInfo not found in XEX headers");
+        return false;
+    }
+    if (recordSize < 20) {
+        LOGE("ExecutionInfo offset out of bounds");
+        return false;
+    }
+    
+    // Ler ExecutionInfo (big-endian)
+    memcpy(execInfo.mediaId, &record[0], 4);
+    execInfo.version = readUInt32BE(&record[4]);
+    execInfo.baseVersion = readUInt32BE(&record[8]);
+    memcpy(execInfo.titleId, &record[12], 4);
+    execInfo.platform = record[16];
+    execInfo.executableType = record[17];
+    execInfo.discNumber = record[18];
+    execInfo.discCount = record[19];
+    
+    LOGD("Title ID: %02X%02X%02X%02X",
+         execInfo.titleId[0], execInfo.titleId[1],
+         execInfo.titleId[2], execInfo.titleId[3]);
+    
+    LOGD("Media ID: %02X%02X%02X%02X",
+         execInfo.mediaId[0], execInfo.mediaId[1],
+         execInfo.mediaId[2], execInfo.mediaId[3]);
+    
+    valid = true;
+    return true;
+}
+
+const XexOptionalHeader* XexParser::findOptionalHeader(uint32_t key) const {
+    auto it = std::lower_bound(optionalHeaders.begin(), optionalHeaders.end(), key,
+                               [](const XexOptionalHeader& entry, uint32_t k) { return entry.key < k; });
+    if (it == optionalHeaders.end() || it->key != key) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+const uint8_t* XexParser::getOptionalHeaderData(uint32_t key, uint32_t& size) const {
+    const XexOptionalHeader* entry = findOptionalHeader(key);
+    if (!entry) {
+        return nullptr;
+    }
+    
+    uint32_t sizeCode = key & 0xFF;
+    if (sizeCode <= 0x01) {
+        // Valor inline: os 4 bytes dele na própria tabela
+        size = 4;
+        return &header[entry->tableOffset + 4];
+    }
+    
+    uint64_t offset = entry->value;
+    if (sizeCode == 0xFF) {
+        // Tamanho variável: o primeiro dword do dado (incluído nele)
+        if (offset + 4 > header.size()) {
+            return nullptr;
+        }
+        size = readUInt32BE(&header[offset]);
+    } else {
+        size = sizeCode * 4;
+    }
+    
+    if (offset + size > header.size()) {
+        LOGE("Optional header 0x%08X out of bounds", key);
+        return nullptr;
+    }
+    return &header[offset];
+}
+
+bool XexParser::getOptionalHeaderValue(uint32_t key, uint32_t& value) const {
+    const XexOptionalHeader* entry = findOptionalHeader(key);
+    if (!entry || (key & 0xFF) > 0x01) {
+        return false;
+    }
+    value = entry->value;
+    return true;
+}
+
+bool XexParser::getFileFormat(XexFileFormat& format) const {
+    uint32_t size;
+    const uint8_t* data = getOptionalHeaderData(HEADER_FILE_FORMAT_INFO, size);
+    if (!data || size < 8) {
+        return false;
+    }
+    format.encryption = (uint16_t)((data[4] << 8) | data[5]);
+    format.compression = (uint16_t)((data[6] << 8) | data[7]);
+    return true;
+}
+
+bool XexParser::getResources(std::vector<XexResource>& resources) const {
+    resources.clear();
+    
+    uint32_t size;
+    const uint8_t* data = getOptionalHeaderData(HEADER_RESOURCE_INFO, size);
+    if (!data || size < 4) {
+        return false;
+    }
+    
+    // Entradas de 16 bytes: nome (8, sem terminador se cheio), endereço, tamanho
+    for (uint32_t pos = 4; pos + 16 <= size; pos += 16) {
+        XexResource resource;
+        const char* name = (const char*)&data[pos];
+        resource.name.assign(name, strnlen(name, 8));
+        resource.address = readUInt32BE(&data[pos + 8]);
+        resource.size = readUInt32BE(&data[pos + 12]);
+        resources.push_back(resource);
+    }
+    return true;
+}
+
+bool XexParser::getGameRatings(std::vector<uint8_t>& ratings) const {
+    uint32_t size;
+    const uint8_t* data = getOptionalHeaderData(HEADER_GAME_RATINGS, size);
+    if (!data) {
+        return false;
+    }
+    ratings.assign(data, data + std::min(size, GAME_RATINGS_SIZE));
+    return true;
+}
+
+bool XexParser::getAlternateTitleIds(std::vector<uint32_t>& titleIds) const {
+    titleIds.clear();
+    
+    uint32_t size;
+    const uint8_t* data = getOptionalHeaderData(HEADER_ALTERNATE_TITLE_IDS, size);
+    if (!data) {
+        return false;
+    }
+    for (uint32_t pos = 4; pos + 4 <= size; pos += 4) {
+        titleIds.push_back(readUInt32BE(&data[pos]));
+    }
+    return true;
+}
+
+bool XexParser::getOriginalPeName(std::string& name) const {
+    uint32_t size;
+    const uint8_t* data = getOptionalHeaderData(HEADER_ORIGINAL_PE_NAME, size);
+    if (!data || size < 4) {
+        return false;
+    }
+    name.assign((const char*)&data[4], strnlen((const char*)&data[4], size - 4));
+    return true;
+}
+
+bool XexParser::getSecurityInfo(XexSecurityInfo& info) const {
+    // Campos usados vão até allowedMediaTypes (0x17C)
+    if ((uint64_t)securityInfoOffset + 0x180 > header.size()) {
+        return false;
+    }
+    const uint8_t* security = &header[securityInfoOffset];
+    info.imageSize = readUInt32BE(&security[0x004]);
+    info.loadAddress = readUInt32BE(&security[0x110]);
+    info.gameRegions = readUInt32BE(&security[0x178]);
+    info.allowedMediaTypes = readUInt32BE(&security[0x17C]);
+    return true;
+}
+
+bool XexParser::prepareImageAccess() {
+    if (imageAccess != ImageAccess::Unknown) {
+        return imageAccess == ImageAccess::Ready;
+    }
+    imageAccess = ImageAccess::Unavailable;
+    
+    XexFileFormat format;
+    if (!valid || !bytes || peDataOffset == 0 || !getFileFormat(format)) {
+        LOGE("XEX file format info not found");
+        return false;
+    }
+    
+    uint64_t streamSize = bytes->getSize() - peDataOffset;
+    if (format.compression == 0) {
+        imageBlocks.push_back({(uint32_t)streamSize, 0});
+    } else if (format.compression == 1) {
+        // Pares (dados, zeros) depois de tamanho + tipos
+        uint32_t size;
+        const uint8_t* data = getOptionalHeaderData(HEADER_FILE_FORMAT_INFO, size);
+        for (uint32_t pos = 8; pos + 8 <= size; pos += 8) {
+            imageBlocks.push_back({readUInt32BE(&data[pos]), readUInt32BE(&data[pos + 4])});
+        }
+    } else {
+        LOGD("XEX image compression %u not supported for partial reads", format.compression);
+        return false;
+    }
+    
+    for (const ImageBlock& block : imageBlocks) {
+        imageSize += (uint64_t)block.dataSize + block.zeroSize;
+    }
+    
+    encrypted = format.encryption != 0;
+    if (encrypted) {
+        if ((uint64_t)securityInfoOffset + 0x150 + XexCrypto::KEY_SIZE > header.size()) {
+            LOGE("XEX file key out of bounds");
+            return false;
+        }
+        const uint8_t* fileKey = &header[securityInfoOffset + 0x150];
         
-        // Verificar se é ExecutionInfo
-        if (signature == 0x00040006) {
-            LOGD("Found ExecutionInfo at offset 0x%X", dataOffset);
-            
-            // ExecutionInfo está em dataOffset
-            if (dataOffset + 20 > size) {
-                LOGE("ExecutionInfo offset out of bounds");
-                return false;
+        // A chave certa decifra o começo da imagem no "MZ" do PE
+        const XexCrypto::KeyType keyTypes[] = {XexCrypto::KeyType::Retail, XexCrypto::KeyType::Devkit};
+        bool found = false;
+        for (XexCrypto::KeyType type : keyTypes) {
+            XexCrypto::deriveSessionKey(type, fileKey, sessionKey);
+            uint8_t magic[2];
+            if (readStream(0, sizeof(magic), magic) && magic[0] == 'M' && magic[1] == 'Z') {
+                found = true;
+                break;
             }
-            
-            // Ler ExecutionInfo (big-endian)
-            memcpy(execInfo.mediaId, &xexData[dataOffset], 4);
-            execInfo.version = readUInt32BE(&xexData[dataOffset + 4]);
-            execInfo.baseVersion = readUInt32BE(&xexData[dataOffset + 8]);
-            memcpy(execInfo.titleId, &xexData[dataOffset + 12], 4);
-            execInfo.platform = xexData[dataOffset + 16];
-            execInfo.executableType = xexData[dataOffset + 17];
-            execInfo.discNumber = xexData[dataOffset + 18];
-            execInfo.discCount = xexData[dataOffset + 19];
-            
-            LOGD("Title ID: %02X%02X%02X%02X",
-                 execInfo.titleId[0], execInfo.titleId[1],
-                 execInfo.titleId[2], execInfo.titleId[3]);
-            
-            LOGD("Media ID: %02X%02X%02X%02X",
-                 execInfo.mediaId[0], execInfo.mediaId[1],
-                 execInfo.mediaId[2], execInfo.mediaId[3]);
-            
-            valid = true;
-            return true;
+        }
+        if (!found) {
+            LOGE("No XEX key decrypts the PE image");
+            return false;
+        }
+    }
+    
+    imageAccess = ImageAccess::Ready;
+    return true;
+}
+
+bool XexParser::readStream(uint64_t streamOffset, uint32_t length, uint8_t* out) {
+    if (!encrypted) {
+        const uint8_t* data = bytes->fetch(peDataOffset + streamOffset, length);
+        if (!data) {
+            return false;
+        }
+        memcpy(out, data, length);
+        return true;
+    }
+    
+    // Blocos AES inteiros, mais o bloco cifrado anterior como IV
+    const uint64_t block = XexCrypto::BLOCK_SIZE;
+    uint64_t start = streamOffset / block * block;
+    uint64_t end = (streamOffset + length + block - 1) / block * block;
+    uint64_t readFrom = start >= block ? start - block : start;
+    
+    const uint8_t* data = bytes->fetch(peDataOffset + readFrom, (uint32_t)(end - readFrom));
+    if (!data) {
+        return false;
+    }
+    
+    uint8_t iv[XexCrypto::BLOCK_SIZE] = {0};
+    if (start >= block) {
+        memcpy(iv, data, block);
+    }
+    
+    std::vector<uint8_t> plain((size_t)(end - start));
+    XexCrypto::decryptCbc(sessionKey, iv, data + (start - readFrom), plain.data(), plain.size());
+    memcpy(out, plain.data() + (streamOffset - start), length);
+    return true;
+}
+
+bool XexParser::readImage(uint32_t offset, uint32_t length, std::vector<uint8_t>& out) {
+    if (!prepareImageAccess()) {
+        return false;
+    }
+    
+    // Antes de alocar: o tamanho vem do XDBF, que pode estar corrompido
+    uint64_t end = (uint64_t)offset + length;
+    if (end > imageSize) {
+        LOGE("XEX image range out of bounds: 0x%X + %u", offset, length);
+        return false;
+    }
+    
+    out.assign(length, 0);
+    uint64_t imagePos = 0;
+    uint64_t streamPos = 0;
+    
+    for (const ImageBlock& block : imageBlocks) {
+        if (imagePos >= end) {
+            break;
+        }
+        
+        // Parte com dados deste bloco; os zeros que a seguem já estão em out
+        uint64_t dataEnd = imagePos + block.dataSize;
+        uint64_t from = std::max<uint64_t>(offset, imagePos);
+        uint64_t to = std::min(end, dataEnd);
+        if (from < to && !readStream(streamPos + (from - imagePos), (uint32_t)(to - from), &out[from - offset])) {
+            LOGE("Failed to read XEX image at 0x%llX", (unsigned long long)from);
+            return false;
         }
         
-        pos += 8; // Próximo header
+        imagePos = dataEnd + block.zeroSize;
+        streamPos += block.dataSize;
+    }
+    return true;
+}
+
+bool XexParser::loadTitleResource() {
+    if (titleResourceState != 0) {
+        return titleResourceState > 0;
+    }
+    titleResourceState = -1;
+    
+    std::vector<XexResource> resources;
+    XexSecurityInfo security;
+    if (!valid || !getResources(resources) || !getSecurityInfo(security)) {
+        return false;
+    }
+    
+    // O XDBF do título é o resource com o nome do title ID
+    std::string titleId = getTitleIdString();
+    const XexResource* resource = nullptr;
+    for (const XexResource& candidate : resources) {
+        if (strcasecmp(candidate.name.c_str(), titleId.c_str()) == 0) {
+            resource = &candidate;
+            break;
+        }
+    }
+    if (!resource || resource->address < security.loadAddress) {
+        LOGD("Title XDBF resource not found");
+        return false;
     }
     
-    LOGE("ExecutionInfo not found in XEX headers");
-    return false;
+    uint32_t imageOffset = resource->address - security.loadAddress;
+    if (!prepareImageAccess()) {
+        return false;
+    }
+    if ((uint64_t)imageOffset + resource->size > imageSize) {
+        LOGE("Title XDBF resource out of bounds: 0x%X + %u", imageOffset, resource->size);
+        return false;
+    }
+    
+    XdbfReader reader = [this, imageOffset](uint32_t offset, uint32_t length, std::vector<uint8_t>& out) {
+        return readImage(imageOffset + offset, length, out);
+    };
+    if (!titleResource.parse(reader, resource->size)) {
+        return false;
+    }
+    
+    titleResourceState = 1;
+    return true;
+}
+
+bool XexParser::getTitleName(std::string& name) {
+    return loadTitleResource() && titleResource.getTitleName(name);
+}
+
+bool XexParser::getTitleIcon(std::vector<uint8_t>& png) {
+    return loadTitleResource() && titleResource.getTitleIcon(png);
 }
 
 std::string XexParser::getTitleIdString() const {
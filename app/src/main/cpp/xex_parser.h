@@ -1,8 +1,14 @@
 #ifndef XEX_PARSER_H
 #define XEX_PARSER_H
 
+#include "xdbf_parser.h"
+#include "xex_crypto.h"
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+class IsoSource;
 
 struct XexExecutionInfo {
     uint8_t mediaId[4];
@@ -15,6 +21,78 @@ struct XexExecutionInfo {
     uint8_t discCount;
 };
 
+// Entrada da tabela de optional headers. value é o próprio dado nas chaves
+// com byte baixo 0x00/0x01 e, nas demais, o offset do dado no cabeçalho.
+struct XexOptionalHeader {
+    uint32_t key;
+    uint32_t value;
+    uint32_t tableOffset;   // posição da entrada no cabeçalho (value em +4)
+};
+
+struct XexResource {
+    std::string name;       // até 8 caracteres; o XDBF do título leva o title ID
+    uint32_t address;       // endereço virtual na imagem
+    uint32_t size;
+};
+
+// Formato da imagem PE
+struct XexFileFormat {
+    uint16_t encryption;    // 0 = nenhuma, 1 = AES
+    uint16_t compression;   // 0 = nenhuma, 1 = básica (zeros omitidos), 2 = LZX, 3 = delta
+};
+
+struct XexSecurityInfo {
+    uint32_t imageSize;
+    uint32_t loadAddress;
+    uint32_t gameRegions;
+    uint32_t allowedMediaTypes;
+};
+
+// Bytes do XEX buscados sob demanda. O parse só precisa do cabeçalho XEX2
+// (optional headers e security info, alguns KiB no começo do arquivo), e
+// da imagem PE só os trechos do XDBF do título são lidos, e só se o nome
+// ou o ícone forem pedidos. As leituras crescem um prefixo em passos de
+// READ_GRANULARITY, e uma faixa longe do prefixo vai para uma janela
+// separada em vez de arrastar tudo o que fica no meio.
+class XexByteSource {
+public:
+    // XEX inteiro já na memória
+    XexByteSource(const uint8_t* data, uint64_t size);
+    
+    // XEX em [offset, offset + size) do ISO
+    XexByteSource(IsoSource& source, uint64_t offset, uint64_t size);
+    
+    uint64_t getSize() const { return size; }
+    
+    // Ponteiro para [offset, offset + length) do XEX, válido até a próxima
+    // chamada; nullptr se a faixa passar do fim do XEX ou a leitura falhar
+    const uint8_t* fetch(uint64_t offset, uint32_t length);
+    
+    // Bytes trazidos do ISO até agora (com mmap, os bytes referenciados)
+    uint64_t getBytesRead() const { return bytesRead; }
+    
+    static const uint32_t READ_GRANULARITY = 4096;
+    
+private:
+    const uint8_t* data;
+    IsoSource* source;
+    uint64_t baseOffset;
+    uint64_t size;
+    uint64_t bytesRead;
+    
+    std::vector<uint8_t> prefix;      // [0, prefix.size()) do XEX
+    std::vector<uint8_t> window;      // [windowOffset, windowOffset + window.size())
+    uint64_t windowOffset;
+    
+    // Estende buffer (que começa em bufferOffset do XEX) até cobrir end
+    const uint8_t* extend(std::vector<uint8_t>& buffer, uint64_t bufferOffset, uint64_t offset, uint64_t end);
+};
+
+// Cabeçalho do XEX2: o parse copia o cabeçalho inteiro numa leitura e
+// indexa todos os optional headers por chave, então os acessores abaixo
+// não leem mais nada. Nome e ícone do título saem do XDBF embutido na
+// imagem PE, lido sob demanda; para isso o XexByteSource passado a parse()
+// precisa continuar vivo.
 class XexParser {
 public:
     XexParser();
@@ -22,15 +100,91 @@ public:
     
     bool parse(const uint8_t* xexData, size_t size);
     
+    // Mesmo parse, buscando só os bytes que ele usa
+    bool parse(XexByteSource& bytes);
+    
     std::string getTitleIdString() const;
     std::string getMediaIdString() const;
     XexExecutionInfo getExecutionInfo() const { return execInfo; }
     
+    static const uint32_t HEADER_RESOURCE_INFO = 0x000002FF;
+    static const uint32_t HEADER_FILE_FORMAT_INFO = 0x000003FF;
+    static const uint32_t HEADER_ENTRY_POINT = 0x00010100;
+    static const uint32_t HEADER_IMAGE_BASE_ADDRESS = 0x00010201;
+    static const uint32_t HEADER_ORIGINAL_PE_NAME = 0x000183FF;
+    static const uint32_t HEADER_SYSTEM_FLAGS = 0x00030000;
+    static const uint32_t HEADER_EXECUTION_INFO = 0x00040006;
+    static const uint32_t HEADER_GAME_RATINGS = 0x00040310;
+    static const uint32_t HEADER_ALTERNATE_TITLE_IDS = 0x000407FF;
+    
+    static constexpr uint32_t GAME_RATINGS_SIZE = 64;
+    
+    // Diretório completo, ordenado por chave
+    const std::vector<XexOptionalHeader>& getOptionalHeaders() const { return optionalHeaders; }
+    const XexOptionalHeader* findOptionalHeader(uint32_t key) const;
+    
+    // Dado do optional header dentro do cabeçalho: os 4 bytes do valor nas
+    // chaves inline, e nas de tamanho variável (byte baixo 0xFF) o dado
+    // começando pelo próprio tamanho. nullptr se ausente ou fora do cabeçalho.
+    const uint8_t* getOptionalHeaderData(uint32_t key, uint32_t& size) const;
+    
+    // Valor de uma chave inline (byte baixo 0x00/0x01)
+    bool getOptionalHeaderValue(uint32_t key, uint32_t& value) const;
+    
+    bool getSystemFlags(uint32_t& flags) const { return getOptionalHeaderValue(HEADER_SYSTEM_FLAGS, flags); }
+    bool getFileFormat(XexFileFormat& format) const;
+    bool getResources(std::vector<XexResource>& resources) const;
+    bool getGameRatings(std::vector<uint8_t>& ratings) const;
+    bool getAlternateTitleIds(std::vector<uint32_t>& titleIds) const;
+    bool getOriginalPeName(std::string& name) const;
+    bool getSecurityInfo(XexSecurityInfo& info) const;
+    
+    // Nome e ícone (PNG) do título, do XDBF embutido. Só imagens sem
+    // compressão ou com compressão básica (cifradas ou não): com LZX o
+    // trecho não pode ser lido sem descomprimir a imagem inteira.
+    bool getTitleName(std::string& name);
+    bool getTitleIcon(std::vector<uint8_t>& png);
+    
+    // [offset, offset + length) da imagem PE já decifrada, com os blocos
+    // omitidos pela compressão básica preenchidos com zeros
+    bool readImage(uint32_t offset, uint32_t length, std::vector<uint8_t>& out);
+    
 private:
+    enum class ImageAccess {
+        Unknown,
+        Ready,
+        Unavailable
+    };
+    
+    struct ImageBlock {
+        uint32_t dataSize;
+        uint32_t zeroSize;
+    };
+    
     XexExecutionInfo execInfo;
     bool valid;
     
-    uint32_t readUInt32BE(const uint8_t* data);
+    XexByteSource* bytes;
+    std::unique_ptr<XexByteSource> ownedBytes;   // parse() sobre um buffer
+    std::vector<uint8_t> header;                  // [0, peDataOffset) do XEX
+    std::vector<XexOptionalHeader> optionalHeaders;
+    uint32_t peDataOffset;                        // 0 se o cabeçalho não traz um válido
+    uint32_t securityInfoOffset;
+    
+    ImageAccess imageAccess;
+    bool encrypted;
+    uint8_t sessionKey[XexCrypto::KEY_SIZE];
+    std::vector<ImageBlock> imageBlocks;
+    uint64_t imageSize;                           // soma dos imageBlocks (dados + zeros)
+    
+    // XDBF do título: 0 = ainda não procurado, 1 = pronto, -1 = indisponível
+    int titleResourceState;
+    XdbfParser titleResource;
+    
+    static uint32_t readUInt32BE(const uint8_t* data);
+    bool prepareImageAccess();
+    bool readStream(uint64_t streamOffset, uint32_t length, uint8_t* out);
+    bool loadTitleResource();
 };
 
 #endif // XEX_PARSER_H
@@ -114,18 +114,19 @@ class Iso2GodService : Service() {
                 
                 Log.d("Iso2GodService", "Starting conversion: $isoPath -> $outputPath")
                 
-                val converter = Iso2GodConverter(applicationContext)
-                val result = converter.convertIsoToGod(
-                    isoPath = isoPath,
-                    outputPath = outputPath,
-                    onProgress = { progress, status ->
-                        updateProgressNotification(
-                            isoFile.name,
-                            progress,
-                            status
-                        )
-                    }
-                )
+                val result = Iso2GodConverter(applicationContext).use { converter ->
+                    converter.convertIsoToGod(
+                        isoPath = isoPath,
+                        outputPath = outputPath,
+                        onProgress = { progress, status ->
+                            updateProgressNotification(
+                                isoFile.name,
+                                progress,
+                                status
+                            )
+                        }
+                    )
+                }
                 
                 result.fold(
                     onSuccess = { godPath ->
@@ -154,6 +155,7 @@ class Iso2GodService : Service() {
     }
     
     private fun cancelConversion() {
+        // convertIsoToGod repassa o cancelamento da coroutine ao código nativo
         currentConversionJob?.cancel()
         currentConversionJob = null
     }
@@ -3,10 +3,27 @@ package com.x360games.archivedownloader.utils
 import android.content.Context
 import android.util.Log
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.awaitCancellation
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.ensureActive
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.flow
+import kotlinx.coroutines.flow.flowOn
+import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import java.io.Closeable
 import java.io.File
+import java.util.concurrent.atomic.AtomicBoolean
 
-class Iso2GodConverter(private val context: Context) {
+/**
+ * Conversor ISO → GOD. Cada instância tem o seu estado nativo (conversor,
+ * sessões, jobs, lote e varredura), sem nada compartilhado com outras:
+ * conversões de instâncias diferentes, ou jobs de [startConversion],
+ * rodam em paralelo e cancelar uma não afeta as demais. [close] libera o
+ * estado nativo depois que as conversões da instância terminaram.
+ */
+class Iso2GodConverter(private val context: Context) : Closeable {
     
     companion object {
         init {
@@ -20,18 +37,127 @@ class Iso2GodConverter(private val context: Context) {
         
         private const val BLOCK_SIZE = 4096
         private const val BLOCKS_PER_PART = 41412
+        private const val SCAN_POLL_TIMEOUT_MS = 250
+        private const val PROGRESS_INTERVAL_MS = 250
+    }
+    
+    // Cache nativo dos metadados de cada ISO (IsoInfo + árvore GDF): um ISO
+    // já visto não é lido de novo enquanto caminho, tamanho e data não mudam
+    private val metadataCacheDir = File(context.cacheDir, "iso_metadata").absolutePath
+    
+    // Estado nativo desta instância (nativeCreate), passado em cada chamada
+    private val nativeHandle: Long = nativeCreate()
+    private val released = AtomicBoolean(false)
+    
+    // Handle para uma chamada nativa; depois de close() falha aqui em vez
+    // de chegar ao código nativo
+    private val liveHandle: Long
+        get() {
+            check(!released.get()) { "Iso2GodConverter já foi fechado" }
+            return nativeHandle
+        }
+    
+    // Cancelamentos e liberações: depois de close() não há mais nada a
+    // cancelar (nativeDestroy já cancelou e liberou tudo)
+    private inline fun ifOpen(block: (Long) -> Unit) {
+        if (!released.get()) {
+            block(nativeHandle)
+        }
     }
     
     // Native methods (implementadas em C++)
-    private external fun nativeConvertIso(
-        isoPath: String,
+    private external fun nativeCreate(): Long
+    
+    private external fun nativeDestroy(nativeConverter: Long)
+    
+    private external fun nativeGetIsoInfo(nativeConverter: Long, isoPath: String, metadataCacheDir: String?): IsoInfo?
+    
+    private external fun nativeGetTitleMetadata(nativeConverter: Long, isoPath: String): TitleMetadata?
+    
+    private external fun nativeSessionOpen(nativeConverter: Long, isoPath: String, metadataCacheDir: String?): Long
+    
+    private external fun nativeSessionGetInfo(nativeConverter: Long, handle: Long): IsoInfo?
+    
+    private external fun nativeSessionGetTitleMetadata(nativeConverter: Long, handle: Long): TitleMetadata?
+    
+    private external fun nativeSessionConvert(
+        nativeConverter: Long,
+        handle: Long,
         outputPath: String,
+        threadCount: Int,
+        readChunkSizeMb: Int,
+        kernelCopy: Boolean,
+        gamePartitionOnly: Boolean,
+        resume: Boolean,
+        collectMetrics: Boolean,
+        tracePath: String?,
         progressCallback: ProgressCallback
     ): Int
     
-    private external fun nativeGetIsoInfo(isoPath: String): IsoInfo?
+    private external fun nativeSessionClose(nativeConverter: Long, handle: Long)
+    
+    private external fun nativeConvertStart(
+        nativeConverter: Long,
+        handle: Long,
+        outputPath: String,
+        threadCount: Int,
+        readChunkSizeMb: Int,
+        kernelCopy: Boolean,
+        gamePartitionOnly: Boolean,
+        resume: Boolean,
+        collectMetrics: Boolean,
+        tracePath: String?
+    ): Int
+    
+    private external fun nativeConvertWaitProgress(nativeConverter: Long, jobId: Int, timeoutMs: Int): ConversionProgress?
+    
+    private external fun nativeConvertCancel(nativeConverter: Long, jobId: Int)
+    
+    private external fun nativeConvertRelease(nativeConverter: Long, jobId: Int)
+    
+    private external fun nativeConvertGetMetrics(nativeConverter: Long, jobId: Int): Array<ConversionStageMetrics>?
+    
+    private external fun nativeCancelConversion(nativeConverter: Long)
+    
+    private external fun nativeGetConversionMetrics(nativeConverter: Long): Array<ConversionStageMetrics>?
+    
+    private external fun nativeBatchCreate(
+        nativeConverter: Long,
+        maxConcurrentJobs: Int,
+        threadCount: Int,
+        readChunkSizeMb: Int,
+        kernelCopy: Boolean,
+        gamePartitionOnly: Boolean,
+        resume: Boolean,
+        metadataCacheDir: String?
+    ): Boolean
+    
+    private external fun nativeBatchSubmit(nativeConverter: Long, isoPath: String, outputPath: String): Int
     
-    private external fun nativeCancelConversion()
+    private external fun nativeBatchGetJobStatus(nativeConverter: Long, jobId: Int): BatchJobStatus?
+    
+    private external fun nativeBatchGetStats(nativeConverter: Long): BatchStats?
+    
+    private external fun nativeBatchCancel(nativeConverter: Long, jobId: Int)
+    
+    private external fun nativeBatchRelease(nativeConverter: Long)
+    
+    private external fun nativeScanStart(
+        nativeConverter: Long,
+        paths: Array<String>,
+        workerThreads: Int,
+        ioPerDevice: Int,
+        recursive: Boolean,
+        metadataCacheDir: String?
+    ): Boolean
+    
+    private external fun nativeScanNext(nativeConverter: Long, timeoutMs: Int): Array<IsoScanResult>?
+    
+    private external fun nativeScanGetProgress(nativeConverter: Long): LibraryScanProgress?
+    
+    private external fun nativeScanCancel(nativeConverter: Long)
+    
+    private external fun nativeScanRelease(nativeConverter: Long)
     
     /**
      * Converte um arquivo ISO do Xbox 360 para o formato GOD (Games on Demand)
@@ -39,12 +165,26 @@ class Iso2GodConverter(private val context: Context) {
      * @param isoPath Caminho do arquivo ISO de origem
      * @param outputPath Caminho de saída para os arquivos GOD
      * @param onProgress Callback para atualizações de progresso (progress: 0.0-1.0, status: String)
+     * @param threadCount Threads de hashing (0 = automático, 1 = sem threads auxiliares)
+     * @param readChunkSizeMb Tamanho de cada leitura do ISO em MB (0 = padrão, 1-16)
+     * @param kernelCopy Copiar os dados do ISO pelo kernel (copy_file_range/sendfile)
+     * @param gamePartitionOnly Converter só a partição do jogo (pula a partição de vídeo do XGD)
+     * @param resume Retomar uma conversão interrompida a partir da última parte concluída
+     * @param collectMetrics Medir cada etapa da conversão (ver [getConversionMetrics])
+     * @param traceFilePath Gravar um trace do Chrome (chrome://tracing, Perfetto) neste arquivo
      * @return Result<String> com o caminho do GOD gerado ou erro
      */
     suspend fun convertIsoToGod(
         isoPath: String,
         outputPath: String,
-        onProgress: (Float, String) -> Unit
+        onProgress: (Float, String) -> Unit,
+        threadCount: Int = 0,
+        readChunkSizeMb: Int = 0,
+        kernelCopy: Boolean = true,
+        gamePartitionOnly: Boolean = false,
+        resume: Boolean = false,
+        collectMetrics: Boolean = false,
+        traceFilePath: String? = null
     ): Result<String> = withContext(Dispatchers.IO) {
         try {
             val isoFile = File(isoPath)
@@ -71,52 +211,161 @@ class Iso2GodConverter(private val context: Context) {
             
             onProgress(0f, "Analisando arquivo ISO...")
             
-            // Obter informações do ISO
-            val isoInfo = nativeGetIsoInfo(isoPath)
-            if (isoInfo == null) {
-                return@withContext Result.failure(Exception("Falha ao ler informações do ISO"))
-            }
+            // Uma sessão só: o ISO é aberto e o GDF/XEX lidos uma vez, e a
+            // conversão segue direto para a cópia dos dados
+            val session = openIsoSession(isoPath)
+                ?: return@withContext Result.failure(Exception("Falha ao ler informações do ISO"))
             
-            Log.d("Iso2GodConverter", "ISO Info: ${isoInfo.gameName} (${isoInfo.titleId})")
+            session.use {
+                convertSession(it, outputPath, onProgress, threadCount, readChunkSizeMb, kernelCopy, gamePartitionOnly, resume, collectMetrics, traceFilePath)
+            }
             
-            onProgress(0.05f, "Iniciando conversão...")
+        } catch (e: Exception) {
+            Log.e("Iso2GodConverter", "Conversion error", e)
+            Result.failure(e)
+        }
+    }
+    
+    /**
+     * Converte um ISO já aberto por [openSession], sem ler os metadados de
+     * novo. Os parâmetros são os mesmos de [convertIsoToGod] com caminho.
+     */
+    suspend fun convertIsoToGod(
+        session: IsoSession,
+        outputPath: String,
+        onProgress: (Float, String) -> Unit,
+        threadCount: Int = 0,
+        readChunkSizeMb: Int = 0,
+        kernelCopy: Boolean = true,
+        gamePartitionOnly: Boolean = false,
+        resume: Boolean = false,
+        collectMetrics: Boolean = false,
+        traceFilePath: String? = null
+    ): Result<String> = withContext(Dispatchers.IO) {
+        try {
+            val outputDir = File(outputPath)
+            if (!outputDir.exists()) {
+                outputDir.mkdirs()
+            }
             
-            val progressCallback = object : ProgressCallback {
-                override fun onProgress(progress: Float, currentOperation: String) {
-                    onProgress(progress, currentOperation)
-                }
+            if (!outputDir.canWrite()) {
+                return@withContext Result.failure(Exception("Sem permissão de escrita em: $outputPath"))
             }
             
-            val result = nativeConvertIso(isoPath, outputPath, progressCallback)
+            convertSession(session, outputPath, onProgress, threadCount, readChunkSizeMb, kernelCopy, gamePartitionOnly, resume, collectMetrics, traceFilePath)
             
-            if (result == 0) {
-                onProgress(1f, "Conversão concluída!")
-                val godPath = File(outputPath, isoInfo.titleId).absolutePath
-                Log.d("Iso2GodConverter", "Conversion successful: $godPath")
-                Result.success(godPath)
-            } else {
-                val errorMessage = when (result) {
-                    -1 -> "Erro ao abrir arquivo ISO"
-                    -2 -> "Erro ao criar arquivos de saída"
-                    -3 -> "Erro durante a conversão"
-                    -4 -> "Conversão cancelada"
-                    else -> "Erro desconhecido (código: $result)"
+        } catch (e: Exception) {
+            Log.e("Iso2GodConverter", "Conversion error", e)
+            Result.failure(e)
+        }
+    }
+    
+    /**
+     * Roda uma chamada nativa bloqueante repassando o cancelamento da
+     * coroutine: a chamada não vê o Job, então um vigia cancela a
+     * conversão nativa (volta com -4) se a coroutine for cancelada antes
+     * de ela terminar
+     */
+    private suspend fun runCancellable(block: () -> Int): Int = coroutineScope {
+        val finished = AtomicBoolean(false)
+        val watcher = launch {
+            try {
+                awaitCancellation()
+            } finally {
+                if (!finished.get()) {
+                    cancelConversion()
                 }
-                Result.failure(Exception(errorMessage))
             }
-            
+        }
+        try {
+            block()
+        } finally {
+            finished.set(true)
+            watcher.cancel()
+        }
+    }
+    
+    private suspend fun convertSession(
+        session: IsoSession,
+        outputPath: String,
+        onProgress: (Float, String) -> Unit,
+        threadCount: Int,
+        readChunkSizeMb: Int,
+        kernelCopy: Boolean,
+        gamePartitionOnly: Boolean,
+        resume: Boolean,
+        collectMetrics: Boolean,
+        traceFilePath: String?
+    ): Result<String> {
+        val isoInfo = session.info
+        Log.d("Iso2GodConverter", "ISO Info: ${isoInfo.gameName} (${isoInfo.titleId})")
+        
+        onProgress(0.05f, "Iniciando conversão...")
+        
+        val progressCallback = object : ProgressCallback {
+            override fun onProgress(progress: Float, currentOperation: String) {
+                onProgress(progress, currentOperation)
+            }
+        }
+        
+        val result = runCancellable {
+            nativeSessionConvert(liveHandle, session.handle, outputPath, threadCount, readChunkSizeMb, kernelCopy, gamePartitionOnly, resume, collectMetrics, traceFilePath, progressCallback)
+        }
+        
+        return if (result == 0) {
+            onProgress(1f, "Conversão concluída!")
+            val godPath = File(outputPath, isoInfo.titleId).absolutePath
+            Log.d("Iso2GodConverter", "Conversion successful: $godPath")
+            Result.success(godPath)
+        } else {
+            val errorMessage = when (result) {
+                -1 -> "Erro ao abrir arquivo ISO"
+                -2 -> "Erro ao criar arquivos de saída"
+                -3 -> "Erro durante a conversão"
+                -4 -> "Conversão cancelada"
+                else -> "Erro desconhecido (código: $result)"
+            }
+            Result.failure(Exception(errorMessage))
+        }
+    }
+    
+    /**
+     * Abre um ISO para várias operações seguidas (info, metadados do
+     * título, conversão) lendo o GDF e o XEX uma vez só. A sessão mantém
+     * o arquivo aberto até [IsoSession.close].
+     */
+    suspend fun openSession(isoPath: String): Result<IsoSession> = withContext(Dispatchers.IO) {
+        try {
+            val session = openIsoSession(isoPath)
+            if (session != null) {
+                Result.success(session)
+            } else {
+                Result.failure(Exception("Falha ao ler informações do ISO"))
+            }
         } catch (e: Exception) {
-            Log.e("Iso2GodConverter", "Conversion error", e)
             Result.failure(e)
         }
     }
     
+    private fun openIsoSession(isoPath: String): IsoSession? {
+        val handle = nativeSessionOpen(liveHandle, isoPath, metadataCacheDir)
+        if (handle == 0L) {
+            return null
+        }
+        val info = nativeSessionGetInfo(liveHandle, handle)
+        if (info == null) {
+            nativeSessionClose(liveHandle, handle)
+            return null
+        }
+        return IsoSession(handle, isoPath, info)
+    }
+    
     /**
      * Obtém informações de um arquivo ISO
      */
     suspend fun getIsoInfo(isoPath: String): Result<IsoInfo> = withContext(Dispatchers.IO) {
         try {
-            val info = nativeGetIsoInfo(isoPath)
+            val info = nativeGetIsoInfo(liveHandle, isoPath, metadataCacheDir)
             if (info != null) {
                 Result.success(info)
             } else {
@@ -128,17 +377,244 @@ class Iso2GodConverter(private val context: Context) {
     }
     
     /**
-     * Cancela uma conversão em andamento
+     * Metadados completos do título (tela de detalhes) numa chamada só:
+     * IsoInfo, versão, regiões, classificações e, quando o default.xex
+     * traz, nome e ícone do XDBF. Lê só o cabeçalho do executável e os
+     * trechos do XDBF, não o ISO inteiro.
+     */
+    suspend fun getTitleMetadata(isoPath: String): Result<TitleMetadata> = withContext(Dispatchers.IO) {
+        try {
+            val metadata = nativeGetTitleMetadata(liveHandle, isoPath)
+            if (metadata != null) {
+                Result.success(metadata)
+            } else {
+                Result.failure(Exception("Falha ao ler metadados do título"))
+            }
+        } catch (e: Exception) {
+            Result.failure(e)
+        }
+    }
+    
+    /**
+     * Metadados do título de uma sessão aberta; com a sessão vinda do
+     * cache, só o cabeçalho do XEX é lido aqui
+     */
+    suspend fun getTitleMetadata(session: IsoSession): Result<TitleMetadata> = withContext(Dispatchers.IO) {
+        try {
+            val metadata = nativeSessionGetTitleMetadata(liveHandle, session.handle)
+            if (metadata != null) {
+                Result.success(metadata)
+            } else {
+                Result.failure(Exception("Falha ao ler metadados do título"))
+            }
+        } catch (e: Exception) {
+            Result.failure(e)
+        }
+    }
+    
+    /**
+     * ISO aberto por [openSession]. Pode ser fechado durante uma conversão:
+     * o lado nativo só libera o arquivo quando ela termina.
+     */
+    inner class IsoSession internal constructor(
+        internal val handle: Long,
+        val isoPath: String,
+        val info: IsoInfo
+    ) : Closeable {
+        private val closed = AtomicBoolean(false)
+        
+        override fun close() {
+            if (closed.compareAndSet(false, true)) {
+                ifOpen { nativeConverter -> nativeSessionClose(nativeConverter, handle) }
+            }
+        }
+    }
+    
+    /**
+     * Inicia a conversão de uma sessão numa thread nativa e volta na hora.
+     * A conversão não chama o Kotlin: o andamento sai de
+     * [getConversionProgress] ou [conversionProgress]. Liberar o job com
+     * [releaseConversion] depois do fim (ou para cancelar e descartar).
+     * Com collectMetrics, as métricas do job saem de
+     * [getConversionMetrics] com o id, até ele ser liberado.
+     * 
+     * @return id do job, ou -1 se a sessão já foi fechada
+     */
+    fun startConversion(
+        session: IsoSession,
+        outputPath: String,
+        threadCount: Int = 0,
+        readChunkSizeMb: Int = 0,
+        kernelCopy: Boolean = true,
+        gamePartitionOnly: Boolean = false,
+        resume: Boolean = false,
+        collectMetrics: Boolean = false,
+        traceFilePath: String? = null
+    ): Int {
+        File(outputPath).mkdirs()
+        return nativeConvertStart(liveHandle, session.handle, outputPath, threadCount, readChunkSizeMb, kernelCopy, gamePartitionOnly, resume, collectMetrics, traceFilePath)
+    }
+    
+    /**
+     * Andamento atual de um job de [startConversion] (null se o id não existir)
+     */
+    fun getConversionProgress(jobId: Int): ConversionProgress? = nativeConvertWaitProgress(liveHandle, jobId, 0)
+    
+    /**
+     * Andamento do job a cada intervalMs, e uma última vez assim que a
+     * conversão termina. A coleta só lê a foto nativa: não atrasa a
+     * conversão. Cancelar a coleta não cancela o job.
+     */
+    fun conversionProgress(jobId: Int, intervalMs: Int = PROGRESS_INTERVAL_MS): Flow<ConversionProgress> = flow {
+        while (true) {
+            currentCoroutineContext().ensureActive()
+            val progress = nativeConvertWaitProgress(liveHandle, jobId, intervalMs) ?: break
+            emit(progress)
+            if (progress.isFinished) {
+                break
+            }
+        }
+    }.flowOn(Dispatchers.IO)
+    
+    fun cancelConversion(jobId: Int) {
+        ifOpen { handle -> nativeConvertCancel(handle, jobId) }
+    }
+    
+    /**
+     * Métricas por etapa de um job iniciado com collectMetrics (ou
+     * traceFilePath); podem ser lidas durante a conversão. Lista vazia se
+     * o id não existir
+     */
+    fun getConversionMetrics(jobId: Int): List<ConversionStageMetrics> {
+        return nativeConvertGetMetrics(liveHandle, jobId)?.toList() ?: emptyList()
+    }
+    
+    /**
+     * Descarta o job (cancelando se ainda estiver rodando)
+     */
+    fun releaseConversion(jobId: Int) {
+        ifOpen { handle -> nativeConvertRelease(handle, jobId) }
+    }
+    
+    /**
+     * Libera o estado nativo: conversões, jobs, lote e varredura ainda
+     * ativos são cancelados e esperados. Depois disso os métodos que
+     * consultam ou iniciam algo lançam IllegalStateException; os de
+     * cancelar e liberar não fazem nada.
+     */
+    override fun close() {
+        if (released.compareAndSet(false, true)) {
+            nativeDestroy(nativeHandle)
+        }
+    }
+    
+    /**
+     * Cancela as conversões síncronas ([convertIsoToGod]) em andamento
+     * nesta instância. Cancelar a coroutine de [convertIsoToGod] tem o
+     * mesmo efeito.
      */
     fun cancelConversion() {
         try {
-            nativeCancelConversion()
+            ifOpen { handle -> nativeCancelConversion(handle) }
             Log.d("Iso2GodConverter", "Conversion cancellation requested")
         } catch (e: Exception) {
             Log.e("Iso2GodConverter", "Error cancelling conversion", e)
         }
     }
     
+    /**
+     * Métricas por etapa da conversão em andamento ou da última feita com
+     * collectMetrics (ou traceFilePath); lista vazia se não houver
+     */
+    fun getConversionMetrics(): List<ConversionStageMetrics> {
+        return nativeGetConversionMetrics(liveHandle)?.toList() ?: emptyList()
+    }
+    
+    /**
+     * Inicia um lote de conversões (descarta o lote anterior, se houver).
+     * Os jobs enviados com [submitBatchJob] rodam em segundo plano, até
+     * maxConcurrentJobs ao mesmo tempo e no máximo um por disco.
+     * 
+     * @param maxConcurrentJobs Conversões simultâneas
+     * @param threadCount Threads de hashing por job (0 = núcleos divididos entre os jobs)
+     */
+    fun startBatch(
+        maxConcurrentJobs: Int,
+        threadCount: Int = 0,
+        readChunkSizeMb: Int = 0,
+        kernelCopy: Boolean = true,
+        gamePartitionOnly: Boolean = false,
+        resume: Boolean = false
+    ): Boolean {
+        return nativeBatchCreate(liveHandle, maxConcurrentJobs, threadCount, readChunkSizeMb, kernelCopy, gamePartitionOnly, resume, metadataCacheDir)
+    }
+    
+    /**
+     * Enfileira uma conversão no lote atual
+     * 
+     * @return id do job, ou -1 se não houver lote
+     */
+    fun submitBatchJob(isoPath: String, outputPath: String): Int {
+        return nativeBatchSubmit(liveHandle, isoPath, outputPath)
+    }
+    
+    fun getBatchJobStatus(jobId: Int): BatchJobStatus? = nativeBatchGetJobStatus(liveHandle, jobId)
+    
+    fun getBatchStats(): BatchStats? = nativeBatchGetStats(liveHandle)
+    
+    /**
+     * Cancela um job do lote (-1 = todos)
+     */
+    fun cancelBatchJob(jobId: Int = -1) {
+        ifOpen { handle -> nativeBatchCancel(handle, jobId) }
+    }
+    
+    /**
+     * Cancela o que estiver rodando e libera o lote
+     */
+    fun releaseBatch() {
+        ifOpen { handle -> nativeBatchRelease(handle) }
+    }
+    
+    /**
+     * Varre pastas (ou arquivos) de ISOs e lê as informações de cada um em
+     * paralelo no código nativo. Os resultados chegam na ordem em que
+     * terminam, em lotes, sem uma chamada JNI por arquivo; ISOs já vistos
+     * saem do cache de metadados. Cancelar a coleta cancela a varredura.
+     * 
+     * @param paths Pastas e/ou arquivos ISO
+     * @param workerThreads Threads de leitura (0 = automático)
+     * @param ioPerDevice Leituras simultâneas por disco
+     * @param recursive Descer nas subpastas
+     */
+    fun scanLibrary(
+        paths: List<String>,
+        workerThreads: Int = 0,
+        ioPerDevice: Int = 2,
+        recursive: Boolean = true
+    ): Flow<IsoScanResult> = flow {
+        if (!nativeScanStart(liveHandle, paths.toTypedArray(), workerThreads, ioPerDevice, recursive, metadataCacheDir)) {
+            return@flow
+        }
+        try {
+            while (true) {
+                currentCoroutineContext().ensureActive()
+                val results = nativeScanNext(liveHandle, SCAN_POLL_TIMEOUT_MS) ?: break
+                results.forEach { emit(it) }
+            }
+        } finally {
+            ifOpen { handle ->
+                nativeScanCancel(handle)
+                nativeScanRelease(handle)
+            }
+        }
+    }.flowOn(Dispatchers.IO)
+    
+    /**
+     * Andamento da varredura atual (null se não houver)
+     */
+    fun getScanProgress(): LibraryScanProgress? = nativeScanGetProgress(liveHandle)
+    
     // Interface para callback de progresso
     interface ProgressCallback {
         fun onProgress(progress: Float, currentOperation: String)
@@ -156,3 +632,135 @@ data class IsoInfo(
     val sizeBytes: Long,
     val volumeDescriptor: String
 )
+
+/**
+ * Metadados completos de um título. titleName e icon (PNG) vêm do XDBF
+ * embutido no default.xex: ficam vazio/null quando o executável não traz
+ * o XDBF ou usa compressão LZX. gameRatings tem um byte por órgão de
+ * classificação (0xFF = sem classificação).
+ */
+data class TitleMetadata(
+    val info: IsoInfo,
+    val titleName: String,
+    val icon: ByteArray?,
+    val version: Int,
+    val baseVersion: Int,
+    val discNumber: Int,
+    val discCount: Int,
+    val systemFlags: Int,
+    val gameRegions: Int,
+    val allowedMediaTypes: Int,
+    val gameRatings: ByteArray,
+    val alternateTitleIds: Array<String>
+)
+
+/**
+ * Um ISO examinado por [Iso2GodConverter.scanLibrary]. info é null se o
+ * arquivo não pôde ser lido; index é a ordem em que foi encontrado.
+ */
+data class IsoScanResult(
+    val index: Int,
+    val isoPath: String,
+    val info: IsoInfo?,
+    val fromCache: Boolean,
+    val seconds: Double
+)
+
+/**
+ * Andamento de uma varredura de biblioteca
+ */
+data class LibraryScanProgress(
+    val discovered: Int,
+    val completed: Int,
+    val failed: Int,
+    val cacheHits: Int,
+    val discoveryDone: Boolean,
+    val elapsedSeconds: Double
+)
+
+/**
+ * Números de uma etapa da conversão (GdfParse, XexParse, Read, Hash, Write,
+ * Finish, Progress). stalls/stallNanos são as esperas em filas do pipeline;
+ * histogram[i] conta as operações com latência por bloco de 4 KiB (por
+ * operação nas etapas sem blocos) entre 2^i e 2^(i+1) ns.
+ */
+data class ConversionStageMetrics(
+    val stage: String,
+    val ops: Long,
+    val bytes: Long,
+    val blocks: Long,
+    val totalNanos: Long,
+    val maxNanos: Long,
+    val stalls: Long,
+    val stallNanos: Long,
+    val histogram: LongArray
+)
+
+/**
+ * Andamento de uma conversão de [Iso2GodConverter.startConversion].
+ * bytesDone/totalBytes são da faixa convertida (com as partes retomadas);
+ * throughputMBps conta só o copiado nesta execução; etaSeconds é -1
+ * enquanto não há como estimar. result vale nas fases finais.
+ */
+data class ConversionProgress(
+    val phase: Int,
+    val progress: Float,
+    val bytesDone: Long,
+    val totalBytes: Long,
+    val blocksDone: Long,
+    val totalBlocks: Long,
+    val elapsedSeconds: Double,
+    val throughputMBps: Double,
+    val etaSeconds: Double,
+    val result: Int
+) {
+    val isFinished: Boolean get() = phase >= PHASE_DONE
+    
+    companion object {
+        const val PHASE_IDLE = 0
+        const val PHASE_ANALYZING = 1
+        const val PHASE_PREPARING = 2
+        const val PHASE_VERIFYING = 3
+        const val PHASE_COPYING = 4
+        const val PHASE_FINISHING = 5
+        const val PHASE_DONE = 6
+        const val PHASE_FAILED = 7
+        const val PHASE_CANCELLED = 8
+    }
+}
+
+/**
+ * Situação de um job de conversão em lote
+ */
+data class BatchJobStatus(
+    val id: Int,
+    val state: Int,
+    val progress: Float,
+    val status: String,
+    val result: Int,
+    val sizeBytes: Long,
+    val seconds: Double,
+    val throughputMBps: Double
+) {
+    companion object {
+        const val STATE_QUEUED = 0
+        const val STATE_RUNNING = 1
+        const val STATE_DONE = 2
+        const val STATE_FAILED = 3
+        const val STATE_CANCELLED = 4
+    }
+}
+
+/**
+ * Números agregados do lote de conversões
+ */
+data class BatchStats(
+    val queued: Int,
+    val running: Int,
+    val done: Int,
+    val failed: Int,
+    val cancelled: Int,
+    val bytesConverted: Long,
+    val elapsedSeconds: Double,
+    val throughputMBps: Double
+)